@@ -39,6 +39,7 @@ void AssimpHelper::buildSkeletonFormAssimpNode(Skeleton* pSkeleton, aiNode* pNod
 		pSkeleton->bone_names_reverse[itr->second] = itr->first;
 	}
 	pSkeleton->mNumBones = boneIndexCount + 1;
+	pSkeleton->buildLookupTables();
 }
 
 void AssimpHelper::indexSkeletonHirarchyFormAssimpNode(Skeleton* pSkeleton, aiNode* pNode, int* currentBoneCount)
@@ -85,3 +86,140 @@ void AssimpHelper::setAnimationRestingPositionFromAssimpNode(const aiNode& pNode
 		AssimpHelper::setAnimationRestingPositionFromAssimpNode(*child_node,pSkeleton,pAnimation);
 	}
 }
+
+void AssimpHelper::loadAnimationData(aiAnimation* pASSIMPAnimation, Skeleton* pSkeleton, Animation* pAnimation, aiNode* pNode)
+{
+	pAnimation->mBones = std::vector<Bone>(pSkeleton->mNumBones, Bone());
+	for (auto var : pSkeleton->bone_names)
+	{
+		pAnimation->mBones[var.second].mName = var.first;
+	}
+
+	AssimpHelper::setAnimationRestingPositionFromAssimpNode(*pNode, *pSkeleton, pAnimation);
+
+	// Calculate mDurationFrames from actual keyframe count instead of mDuration
+	int maxKeyframes = 0;
+	for (int idx = 0; idx < pASSIMPAnimation->mNumChannels; idx++)
+	{
+
+		auto channel = pASSIMPAnimation->mChannels[idx];
+		std::string name = channel->mNodeName.C_Str();
+		int boneIndex = -1;
+		try {
+			boneIndex = pSkeleton->bone_names.at(name);
+		}
+		catch(const std::out_of_range& e){
+			qWarning() << "Bone: " << name << "not found.";
+			continue;
+		}
+
+
+		int numKeysRot = channel->mNumRotationKeys;
+		int numKeysPos = channel->mNumPositionKeys;
+		int numKeysScl = channel->mNumScalingKeys;
+
+		// Track maximum keyframe count across all channels
+		maxKeyframes = std::max(maxKeyframes, numKeysRot);
+		maxKeyframes = std::max(maxKeyframes, numKeysPos);
+		maxKeyframes = std::max(maxKeyframes, numKeysScl);
+
+		// Log first channel's keyframe counts to see actual frame count
+		if (idx == 0) {
+			qDebug() << "[AssimpLoader] First channel actual keyframe counts:"
+			         << "mNumRotationKeys:" << numKeysRot
+			         << "mNumPositionKeys:" << numKeysPos
+			         << "mNumScalingKeys:" << numKeysScl;
+		}
+
+		for (int i = 0; i < numKeysRot; i++)
+		{
+			pAnimation->mBones.at(boneIndex).mNumKeysRotation = numKeysRot;
+			auto rotKey = channel->mRotationKeys[i];
+			glm::quat orientation = AssimpHelper::ConvertQuaternionToGLM(rotKey.mValue);
+			pAnimation->mBones.at(boneIndex).mRotationKeys.push_back({ (float)rotKey.mTime,orientation });
+		}
+
+		for (int i = 0; i < numKeysPos; i++)
+		{
+			pAnimation->mBones.at(boneIndex).mNumKeysPosition = numKeysPos;
+			auto posKey = channel->mPositionKeys[i];
+			glm::vec3 position = AssimpHelper::ConvertVectorToGLM(posKey.mValue);
+			pAnimation->mBones.at(boneIndex).mPositonKeys.push_back({ (float)posKey.mTime,position });
+		}
+
+		for (int i = 0; i < numKeysScl; i++)
+		{
+			pAnimation->mBones.at(boneIndex).mNumKeysScale = numKeysScl;
+			auto sclKey = channel->mScalingKeys[i];
+			glm::vec3 scale = AssimpHelper::ConvertVectorToGLM(sclKey.mValue);
+			pAnimation->mBones.at(boneIndex).mScaleKeys.push_back({ (float)sclKey.mTime,scale });
+		}
+	}
+	pAnimation->mDurationFrames = maxKeyframes;
+
+	for (Bone& bone : pAnimation->mBones) {
+		bone.UpdateSampling();
+	}
+
+	qDebug() << "[AssimpLoader] mDurationFrames set from keyframe count:" << pAnimation->mDurationFrames
+	         << "(ASSIMP mDuration was:" << pASSIMPAnimation->mDuration << ")"
+	         << "- Difference:" << (pAnimation->mDurationFrames - (int)pASSIMPAnimation->mDuration);
+}
+
+void AssimpHelper::extractSubSkeleton(Skeleton& skeleton, const Animation& animation, const std::string& rootBone,
+	const std::vector<std::string>& leafBones, Skeleton& outSkeleton, Animation& outAnimation)
+{
+	auto subSkel = skeleton.CreateSubSkeleton(rootBone, leafBones);
+
+	outAnimation = Animation();
+	outAnimation.mDurationFrames = animation.mDurationFrames;
+	outAnimation.mDuration = animation.mDuration;
+	qDebug() << "[AssimpLoader] SubSkeleton mDurationFrames:" << outAnimation.mDurationFrames
+	         << "mDuration:" << outAnimation.mDuration;
+	outAnimation.sequenceID = animation.sequenceID;
+	outAnimation.sourceName = animation.sourceName;
+	outAnimation.dataSetID = animation.dataSetID;
+
+	outAnimation.mBones = std::vector<Bone>(subSkel.mNumBones, Bone());
+
+	int newIdxCounter = 0;
+
+	for (auto idx : subSkel) {
+		outAnimation.mBones[newIdxCounter] = animation.mBones[idx];
+		newIdxCounter++;
+	}
+
+	//Create copy of SubSkeleton and reset the index of the bones in skeleton
+	outSkeleton = subSkel;
+
+	outSkeleton.bone_names.clear();
+	outSkeleton.bone_names_reverse.clear();
+	outSkeleton.bone_hierarchy.clear();
+
+	outSkeleton.rootBoneID = 0;
+
+	newIdxCounter = 0;
+
+	for (auto idx : subSkel) {
+		outSkeleton.bone_names[subSkel.bone_names_reverse[idx]] = newIdxCounter;
+		outSkeleton.bone_names_reverse[newIdxCounter] = subSkel.bone_names_reverse[idx];
+		newIdxCounter++;
+	}
+
+	//update bone hirarchy to match with new bone index
+	for (auto workingBoneIdx : subSkel) {
+		
+		std::string workingBoneName = subSkel.bone_names_reverse[workingBoneIdx];
+		int parendIdx = outSkeleton.bone_names[workingBoneName];
+
+		outSkeleton.bone_hierarchy[parendIdx] = std::vector<int>();
+
+		for(auto childIdx : subSkel.bone_hierarchy.at(workingBoneIdx)) {
+			std::string childName = subSkel.bone_names_reverse[childIdx];
+			outSkeleton.bone_hierarchy[parendIdx].push_back(outSkeleton.bone_names[childName]);
+		}
+
+	}
+
+	outSkeleton.buildLookupTables();
+}
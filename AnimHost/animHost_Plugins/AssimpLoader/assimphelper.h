@@ -77,6 +77,21 @@ public:
 
 	static void setAnimationRestingPositionFromAssimpNode(const aiNode& pNode, const Skeleton& pSkeleton, Animation* pAnimation);
 
+	/**
+	 * Fills pAnimation with the resting pose below pNode and the keys of the assimp animation channels.
+	 * The bones of pAnimation are indexed by the bone IDs of pSkeleton.
+	 */
+	static void loadAnimationData(aiAnimation* pASSIMPAnimation, Skeleton* pSkeleton, Animation* pAnimation, aiNode* pNode);
+
+	/**
+	 * Creates a sub-skeleton from the root bone and the leaf bones and the matching animation.
+	 * Bone IDs of outSkeleton are renumbered in depth first order, starting with 0 for the root bone.
+	 *
+	 * @throws std::runtime_error If the root bone is not part of skeleton.
+	 */
+	static void extractSubSkeleton(Skeleton& skeleton, const Animation& animation, const std::string& rootBone,
+		const std::vector<std::string>& leafBones, Skeleton& outSkeleton, Animation& outAnimation);
+
 };
 
 
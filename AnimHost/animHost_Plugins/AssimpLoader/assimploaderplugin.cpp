@@ -300,157 +300,17 @@ void AssimpLoaderPlugin::onSkeletonTypeChanged(int index)
 	}
 }
 
-void AssimpLoaderPlugin::loadAnimationData(aiAnimation* pASSIMPAnimation, Skeleton* pSkeleton, Animation* pAnimation, aiNode* pNode)
-{
-	pAnimation->mBones = std::vector<Bone>(pSkeleton->mNumBones, Bone());
-	for (auto var : pSkeleton->bone_names)
-	{
-		pAnimation->mBones[var.second].mName = var.first;
-	}
-
-	AssimpHelper::setAnimationRestingPositionFromAssimpNode(*pNode, *pSkeleton, pAnimation);
-
-	// Calculate mDurationFrames from actual keyframe count instead of mDuration
-	int maxKeyframes = 0;
-	for (int idx = 0; idx < pASSIMPAnimation->mNumChannels; idx++)
-	{
-
-		auto channel = pASSIMPAnimation->mChannels[idx];
-		std::string name = channel->mNodeName.C_Str();
-		int boneIndex = -1;
-		try {
-			boneIndex = pSkeleton->bone_names.at(name);
-		}
-		catch(const std::out_of_range& e){
-			qWarning() << "Bone: " << name << "not found.";
-			continue;
-		}
-
-
-		int numKeysRot = channel->mNumRotationKeys;
-		int numKeysPos = channel->mNumPositionKeys;
-		int numKeysScl = channel->mNumScalingKeys;
-
-		// Track maximum keyframe count across all channels
-		maxKeyframes = std::max(maxKeyframes, numKeysRot);
-		maxKeyframes = std::max(maxKeyframes, numKeysPos);
-		maxKeyframes = std::max(maxKeyframes, numKeysScl);
-
-		// Log first channel's keyframe counts to see actual frame count
-		if (idx == 0) {
-			qDebug() << "[AssimpLoader] First channel actual keyframe counts:"
-			         << "mNumRotationKeys:" << numKeysRot
-			         << "mNumPositionKeys:" << numKeysPos
-			         << "mNumScalingKeys:" << numKeysScl;
-		}
-
-		for (int i = 0; i < numKeysRot; i++)
-		{
-			pAnimation->mBones.at(boneIndex).mNumKeysRotation = numKeysRot;
-			auto rotKey = channel->mRotationKeys[i];
-			glm::quat orientation = AssimpHelper::ConvertQuaternionToGLM(rotKey.mValue);
-			pAnimation->mBones.at(boneIndex).mRotationKeys.push_back({ (float)rotKey.mTime,orientation });
-		}
-
-		for (int i = 0; i < numKeysPos; i++)
-		{
-			pAnimation->mBones.at(boneIndex).mNumKeysPosition = numKeysPos;
-			auto posKey = channel->mPositionKeys[i];
-			glm::vec3 position = AssimpHelper::ConvertVectorToGLM(posKey.mValue);
-			pAnimation->mBones.at(boneIndex).mPositonKeys.push_back({ (float)posKey.mTime,position });
-		}
-
-		for (int i = 0; i < numKeysScl; i++)
-		{
-			pAnimation->mBones.at(boneIndex).mNumKeysScale = numKeysScl;
-			auto sclKey = channel->mScalingKeys[i];
-			glm::vec3 scale = AssimpHelper::ConvertVectorToGLM(sclKey.mValue);
-			pAnimation->mBones.at(boneIndex).mScaleKeys.push_back({ (float)sclKey.mTime,scale });
-		}
-	}
-	pAnimation->mDurationFrames = maxKeyframes;
-
-	qDebug() << "[AssimpLoader] mDurationFrames set from keyframe count:" << pAnimation->mDurationFrames
-	         << "(ASSIMP mDuration was:" << pASSIMPAnimation->mDuration << ")"
-	         << "- Difference:" << (pAnimation->mDurationFrames - (int)pASSIMPAnimation->mDuration);
-}
-
-
 //takes the loaded skeleton and animation and creates a sub skeleton from the root bone and the leave bones, loaded animation gets updated
 void AssimpLoaderPlugin::UseSubSkeleton(std::string pRootBone, std::vector<std::string> pLeaveBones) {
 
-	auto oAnimation = _animation->getData();
+	auto subSkeleton = std::make_shared<Skeleton>();
+	auto subAnimation = std::make_shared<Animation>();
 
-	auto subSkel = _skeleton->getData()->CreateSubSkeleton(pRootBone, pLeaveBones);
-
-	/*
-	// print each bone in skeleton before and after sub skeleton
-	qDebug() << "Bone Names before Subskeleton: ";
-	for (auto var : _skeleton->getData()->bone_names)
-	{
-		qDebug() << var.first.c_str() << " :: " << var.second;
-	}
-
-	qDebug() << "Bone Names after Subskeleton: ";
-	for (auto var : subSkel.bone_names)
-	{
-		qDebug() << var.first.c_str() << " :: " << var.second;
-	}
-	*/
-
-	std::shared_ptr<Animation> anim = std::make_shared<Animation>();
-
-	anim->mDurationFrames = oAnimation->mDurationFrames;
-	anim->mDuration = oAnimation->mDuration;
-	qDebug() << "[AssimpLoader] SubSkeleton mDurationFrames:" << anim->mDurationFrames
-	         << "mDuration:" << anim->mDuration;
-	anim->sequenceID = oAnimation->sequenceID;
-	anim->sourceName = oAnimation->sourceName;
-	anim->dataSetID = oAnimation->dataSetID;
-
-	anim->mBones = std::vector<Bone>(subSkel.mNumBones, Bone());
-
-	int newIdxCounter = 0;
-
-	for (auto idx : subSkel) {
-		anim->mBones[newIdxCounter] = oAnimation->mBones[idx];
-		newIdxCounter++;
-	}
-
-	//Create copy of SubSkeleton and reset the index of the bones in skeleton
-	Skeleton subSkelCopy = subSkel;
-
-	subSkelCopy.bone_names.clear();
-	subSkelCopy.bone_names_reverse.clear();
-	subSkelCopy.bone_hierarchy.clear();
-
-	subSkelCopy.rootBoneID = 0;
-
-	newIdxCounter = 0;
-
-	for (auto idx : subSkel) {
-		subSkelCopy.bone_names[subSkel.bone_names_reverse[idx]] = newIdxCounter;
-		subSkelCopy.bone_names_reverse[newIdxCounter] = subSkel.bone_names_reverse[idx];
-		newIdxCounter++;
-	}
-
-	//update bone hirarchy to match with new bone index
-	for (auto workingBoneIdx : subSkel) {
-		
-		std::string workingBoneName = subSkel.bone_names_reverse[workingBoneIdx];
-		int parendIdx = subSkelCopy.bone_names[workingBoneName];
-
-		subSkelCopy.bone_hierarchy[parendIdx] = std::vector<int>();
-
-		for(auto childIdx : subSkel.bone_hierarchy[workingBoneIdx]) {
-			std::string childName = subSkel.bone_names_reverse[childIdx];
-			subSkelCopy.bone_hierarchy[parendIdx].push_back(subSkelCopy.bone_names[childName]);
-		}
-
-	}
+	AssimpHelper::extractSubSkeleton(*_skeleton->getData(), *_animation->getData(), pRootBone, pLeaveBones,
+		*subSkeleton, *subAnimation);
 
-	_animation->setData(anim);
-	_skeleton->setData(std::make_shared<Skeleton>(subSkelCopy));
+	_animation->setData(subAnimation);
+	_skeleton->setData(subSkeleton);
 
 }
 
@@ -504,7 +364,7 @@ void AssimpLoaderPlugin::importAssimpData()
 
 		std::shared_ptr<Skeleton> skel = _skeleton->getData();
 
-		loadAnimationData(scene->mAnimations[0], _skeleton->getData().get(), _animation->getData().get(), scene->mRootNode);
+		AssimpHelper::loadAnimationData(scene->mAnimations[0], _skeleton->getData().get(), _animation->getData().get(), scene->mRootNode);
 
 		bDataValid = true;
 	}
@@ -109,9 +109,6 @@ private Q_SLOTS:
     void onIndexingChanged(int index);
 
 private:
-    void loadAnimationData(aiAnimation* pASSIMPAnimation, Skeleton* pSkeleton, Animation* pAnimation, aiNode* pNode);
-
-
     /**
      * This function creates a sub-skeleton from the root bone and the leave bones.
      * It also updates the loaded animation to match the new sub-skeleton.
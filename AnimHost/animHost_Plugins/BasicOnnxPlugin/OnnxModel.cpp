@@ -40,7 +40,7 @@ bool OnnxModel::LoadOnnxModel(QString Path)
     std::wstring modelFilepath = Path.toStdWString();
 
     Ort::SessionOptions sessionOptions;
-    sessionOptions.SetIntraOpNumThreads(1);
+    sessionOptions.SetIntraOpNumThreads(intraOpThreads);
 
     try {
         session = std::make_unique<Ort::Session>(*environment.get(), modelFilepath.c_str(), sessionOptions);
@@ -23,6 +23,7 @@
 #include "BasicOnnxPlugin_global.h"
 
 #include <QMetaType>
+#include <algorithm>
 #include <onnxruntime_cxx_api.h>
 
 class BASICONNXPLUGINSHARED_EXPORT OnnxModel {
@@ -41,6 +42,9 @@ private:
     QString OnnxModelFilePath = "";
     bool bModelValid = false;
 
+    //Number of threads onnxruntime uses to parallelize a single operator
+    int intraOpThreads = 1;
+
 public:
 	OnnxModel();
 	~OnnxModel() {};
@@ -48,6 +52,10 @@ public:
     void SetupEnvironment();
     bool LoadOnnxModel(QString Path);
 
+    //Takes effect on the next LoadOnnxModel call
+    void SetIntraOpThreads(int threads) { intraOpThreads = std::max(1, threads); };
+    int GetIntraOpThreads() const { return intraOpThreads; };
+
     bool IsModelValid() { return bModelValid; };
 
     std::vector<std::string> GetTensorNames(bool bGetInput = true);
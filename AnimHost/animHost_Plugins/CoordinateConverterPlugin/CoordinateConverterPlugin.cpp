@@ -25,6 +25,8 @@
 #include "animhosthelper.h"
 #include <MathUtils.h>
 
+#include <algorithm>
+
 CoordinateConverterPlugin::CoordinateConverterPlugin()
 {
     _animationOut = std::make_shared<AnimNodeData<Animation>>();
@@ -94,91 +96,22 @@ void CoordinateConverterPlugin::run()
 
         if (auto spAnimationIn = _animationIn.lock()) {
             auto AnimIn = spAnimationIn->getData();
+            // The input stays owned by the upstream node, convert a single copy in place
             auto animOut = std::make_shared<Animation>(*AnimIn);
-            bool negX, negY, negZ, negW, swapYZ = false;
 
-            negX = xButton->isChecked();
-            negY = yButton->isChecked();
-            negZ = zButton->isChecked();
-            negW = wButton->isChecked();
-            swapYZ = swapYzButton->isChecked();
+            const ConversionKernel kernel = ConversionKernel::Compile(activePreset, swapYzButton->isChecked(),
+                xButton->isChecked(), yButton->isChecked(), zButton->isChecked(), wButton->isChecked());
 
             // Apply Transforms to Character Object Root
-
-            for (int i = 0; i < animOut->mBones[0].mPositonKeys.size(); i++) {
-                
-				glm::vec3 pos = animOut->mBones[0].mPositonKeys[i].position;
-				glm::quat rot = animOut->mBones[0].mRotationKeys[i].orientation;
-
-				glm::mat4 transform = glm::translate(glm::mat4(1.0), pos) * glm::toMat4(rot);
-
-				// Transform to target system
-				transform = activePreset.transformMatrix * transform * glm::inverse(activePreset.transformMatrix);
-
-				// Extract position and rotation
-				animOut->mBones[0].mPositonKeys[i].position = glm::vec3(transform[3]);
-				animOut->mBones[0].mRotationKeys[i].orientation = glm::toQuat(transform);
-
-            }
-
+            ConvertObjectRootKeys(animOut->mBones[0], kernel);
 
 			// Revert Asset specific conversion applied to character "root" bone (Usually Hip)
-            glm::mat4 conversion = activePreset.characterRootTransform;
-            for (int i = 0; i < animOut->mBones[1].mPositonKeys.size(); i++) {
-
-                glm::vec3 pos = glm::vec4(animOut->mBones[1].mPositonKeys[i].position, 1.f);
-                glm::quat rot = animOut->mBones[1].mRotationKeys[i].orientation  ;
-
-                glm::mat4 transform =glm::translate(glm::mat4(1.0), pos) * glm::toMat4(rot);
-
-                // Transform to target system
-                transform = conversion * transform;
-
-
-                if (activePreset.applyScaleOnCharacter)
-                    animOut->mBones[1].mPositonKeys[i].position = glm::vec3(transform[3]) / 100.f;
-                else
-					animOut->mBones[1].mPositonKeys[i].position = glm::vec3(transform[3]);
-
-
-                animOut->mBones[1].mRotationKeys[i].orientation = glm::toQuat(transform);
-
-            }
-
-
+            if (animOut->mBones.size() > 1)
+                ConvertCharacterRootKeys(animOut->mBones[1], kernel);
 
 			//Apply bone specific transformations to the rest of the bones
             for (int i = 0; i < animOut->mBones.size(); i++) {
-
-				//Iterate over T, R, S Keys individually, might contain different amount of keys
-                int numKeys = animOut->mBones[i].mNumKeysRotation;
-                for (int j = 0; j < numKeys; j++) {
-                    animOut->mBones[i].mRotationKeys[j].orientation = ConvertToTargetSystem(animOut->mBones[i].mRotationKeys[j].orientation,
-                        swapYZ, negX, negY, negZ, negW);
-                }
-
-                numKeys = animOut->mBones[i].mNumKeysPosition;
-                for (int j = 0; j < numKeys; j++) {
-                    animOut->mBones[i].mPositonKeys[j].position = ConvertToTargetSystem(animOut->mBones[i].mPositonKeys[j].position,
-                        swapYZ, negX, negY, negZ, negW)  ;
-
-
-					// Fill other position keys with rest translation, no animation expected but prevent empty keys
-                    if (i > 1)
-                        animOut->mBones[i].mPositonKeys[j].position = animOut->mBones[i].mRestingTransform[3] / 100.f;
-                }
-
-                numKeys = animOut->mBones[i].mNumKeysScale;
-                for (int j = 0; j < numKeys; j++) {
-                    animOut->mBones[i].mScaleKeys[j].scale = ConvertToTargetSystem(animOut->mBones[i].GetScale(j),
-                        swapYZ, negX, negY, negZ, negW);
-                }
-
-                animOut->mBones[i].restingRotation = ConvertToTargetSystem(animOut->mBones[i].restingRotation,
-                    swapYZ, negX, negY, negZ, negW);
-
-                animOut->mBones[i].mRestingTransform = ConvertToTargetSystem(animOut->mBones[i].mRestingTransform,
-                    swapYZ, negX, negY, negZ, negW);
+                ConvertBoneKeys(animOut->mBones[i], kernel, i > 1);
             }
 
             _animationOut->setVariant(QVariant::fromValue(animOut));
@@ -339,71 +272,87 @@ QWidget* CoordinateConverterPlugin::embeddedWidget()
 	return widget;
 }
 
-glm::quat CoordinateConverterPlugin::ConvertToTargetSystem(const glm::quat& qIn, bool flipYZ, bool negX, bool negY, bool negZ, bool negW)
+CoordinateConverterPlugin::ConversionKernel CoordinateConverterPlugin::ConversionKernel::Compile(const CoordinateConversionPreset& preset, bool flipYZ, bool negX, bool negY, bool negZ, bool negW)
 {
-    glm::quat qOut;
-    if (!flipYZ) {
-        qOut.x = qIn.x * (negX ? -1.0f : 1.0f);
-        qOut.y = qIn.y * (negY ? -1.0f : 1.0f);
-        qOut.z = qIn.z * (negZ ? -1.0f : 1.0f);
-        qOut.w = qIn.w * (negW ? -1.0f : 1.0f);
-    }
-    else
-    {
-        qOut.x = qIn.x * (negX ? -1.0f : 1.0f);
-        qOut.z = qIn.y * (negY ? -1.0f : 1.0f);
-        qOut.y = qIn.z * (negZ ? -1.0f : 1.0f);
-        qOut.w = qIn.w * (negW ? -1.0f : 1.0f);
-    }
+    ConversionKernel kernel;
 
-    return qOut;
-}
+    // Swapping Y and Z moves the sign of the source component along with it
+    kernel.ySource = flipYZ ? 2 : 1;
+    kernel.zSource = flipYZ ? 1 : 2;
+    kernel.sign = glm::vec3(negX ? -1.0f : 1.0f,
+                            (flipYZ ? negZ : negY) ? -1.0f : 1.0f,
+                            (flipYZ ? negY : negZ) ? -1.0f : 1.0f);
+    kernel.signW = negW ? -1.0f : 1.0f;
 
+    kernel.rootTransform = preset.transformMatrix;
+    kernel.inverseRootTransform = glm::inverse(preset.transformMatrix);
+
+    kernel.characterRootTransform = preset.characterRootTransform;
+    kernel.characterRootBasis = glm::mat3(preset.characterRootTransform);
+    kernel.characterRootScale = preset.applyScaleOnCharacter ? 0.01f : 1.0f;
+
+    return kernel;
+}
 
-glm::mat4 CoordinateConverterPlugin::ConvertToTargetSystem(const glm::mat4& matIn, bool flipYZ, bool negX, bool negY, bool negZ, bool negW)
+void CoordinateConverterPlugin::ConvertObjectRootKeys(Bone& bone, const ConversionKernel& kernel)
 {
-    glm::mat4 matOut;
-    
-    glm::mat4 convert;
-    
-    if (!flipYZ) {
-        convert = { (negX ? -1.0 : 1.0),  .0,  .0,  .0,
-                           .0, (negY ? -1.0 : 1.0),  .0,  .0,
-                           .0,  .0, (negZ ? -1.0 : 1.0),  .0,
-                           .0,  .0,  .0, 1.0 };
-    }
-    else {
-        convert = { (negX ? -1.0 : 1.0),  .0,  .0,  .0,
-                     .0,   .0, (negY ? -1.0 : 1.0), .0,
-                     .0, (negZ ? -1.0 : 1.0),.0,   .0,
-                     .0,  .0,  .0, 1.0 };
-    }
+    const size_t numKeys = std::min(bone.mPositonKeys.size(), bone.mRotationKeys.size());
+
+    for (size_t i = 0; i < numKeys; i++) {
+        glm::vec3& pos = bone.mPositonKeys[i].position;
+        glm::quat& rot = bone.mRotationKeys[i].orientation;
 
-    matOut = convert * matIn;
-    return matOut;
+        glm::mat4 transform = glm::translate(glm::mat4(1.0), pos) * glm::toMat4(rot);
+
+        // Transform to target system
+        transform = kernel.rootTransform * transform * kernel.inverseRootTransform;
+
+        // Extract position and rotation
+        pos = glm::vec3(transform[3]);
+        rot = glm::toQuat(transform);
+    }
 }
 
-glm::vec3 CoordinateConverterPlugin::ConvertToTargetSystem(const glm::vec3& vecIn, bool flipYZ, bool negX, bool negY, bool negZ, bool negW)
+void CoordinateConverterPlugin::ConvertCharacterRootKeys(Bone& bone, const ConversionKernel& kernel)
 {
-    glm::vec3 vecOut;
+    const size_t numKeys = std::min(bone.mPositonKeys.size(), bone.mRotationKeys.size());
 
-    glm::mat4 convert;
+    for (size_t i = 0; i < numKeys; i++) {
+        glm::vec3& pos = bone.mPositonKeys[i].position;
+        glm::quat& rot = bone.mRotationKeys[i].orientation;
 
-    if (!flipYZ) {
-        convert = { (negX ? -1.0 : 1.0),  .0,  .0,  .0,
-                           .0, (negY ? -1.0 : 1.0),  .0,  .0,
-                           .0,  .0, (negZ ? -1.0 : 1.0),  .0,
-                           .0,  .0,  .0, 1.0 };
+        // Equivalent to conversion * translate(pos) * toMat4(rot), without building the full matrix
+        pos = glm::vec3(kernel.characterRootTransform * glm::vec4(pos, 1.0f)) * kernel.characterRootScale;
+        rot = glm::quat_cast(kernel.characterRootBasis * glm::mat3_cast(rot));
+    }
+}
+
+void CoordinateConverterPlugin::ConvertBoneKeys(Bone& bone, const ConversionKernel& kernel, bool useRestTranslation)
+{
+    // Iterate over T, R, S Keys individually, might contain different amount of keys
+    for (KeyRotation& key : bone.mRotationKeys) {
+        key.orientation = kernel.Apply(key.orientation);
+    }
+
+    if (useRestTranslation) {
+        // Fill other position keys with rest translation, no animation expected but prevent empty keys
+        const glm::vec3 restTranslation = glm::vec3(bone.mRestingTransform[3]) / 100.f;
+        for (KeyPosition& key : bone.mPositonKeys) {
+            key.position = restTranslation;
+        }
     }
     else {
-        convert = { (negX ? -1.0 : 1.0),  .0,  .0,  .0,
-                     .0,   .0, (negY ? -1.0 : 1.0), .0,
-                     .0, (negZ ? -1.0 : 1.0),.0,   .0,
-                     .0,  .0,  .0, 1.0 };
+        for (KeyPosition& key : bone.mPositonKeys) {
+            key.position = kernel.Apply(key.position);
+        }
+    }
+
+    for (KeyScale& key : bone.mScaleKeys) {
+        key.scale = kernel.Apply(key.scale);
     }
 
-    vecOut = convert * glm::vec4(vecIn,1);
-    return vecOut;
+    bone.restingRotation = kernel.Apply(bone.restingRotation);
+    bone.mRestingTransform = kernel.Apply(bone.mRestingTransform);
 }
 
 void CoordinateConverterPlugin::onChangedCheck(int check)
@@ -55,6 +55,49 @@ public:
         bool negW = false;
     };
 
+    /**
+     * @struct ConversionKernel
+     * @brief A preset and axis flags compiled into a branch free conversion.
+     *
+     * The axis flags reduce to a permutation of the y and z components plus a sign per component,
+     * which is applied identically to quaternions, vectors and matrix columns.
+     * The matrices for the character object root and the character root bone are inverted or
+     * decomposed once instead of per key.
+     */
+    struct ConversionKernel {
+        int ySource = 1;
+        int zSource = 2;
+        glm::vec3 sign = glm::vec3(1.0f);
+        float signW = 1.0f;
+
+        glm::mat4 rootTransform = glm::mat4(1.0f);
+        glm::mat4 inverseRootTransform = glm::mat4(1.0f);
+
+        glm::mat4 characterRootTransform = glm::mat4(1.0f);
+        glm::mat3 characterRootBasis = glm::mat3(1.0f);
+        float characterRootScale = 1.0f;
+
+        static ConversionKernel Compile(const CoordinateConversionPreset& preset, bool flipYZ, bool negX, bool negY, bool negZ, bool negW);
+
+        glm::vec3 Apply(const glm::vec3& v) const {
+            return glm::vec3(sign.x * v.x, sign.y * v[ySource], sign.z * v[zSource]);
+        }
+
+        glm::quat Apply(const glm::quat& q) const {
+            glm::vec3 axis(q.x, q.y, q.z);
+            glm::vec3 converted = Apply(axis);
+            return glm::quat(signW * q.w, converted.x, converted.y, converted.z);
+        }
+
+        glm::mat4 Apply(const glm::mat4& m) const {
+            glm::mat4 out;
+            for (int c = 0; c < 4; c++) {
+                out[c] = glm::vec4(Apply(glm::vec3(m[c])), m[c].w);
+            }
+            return out;
+        }
+    };
+
 private:
     
     std::weak_ptr<AnimNodeData<Animation>> _animationIn;
@@ -113,11 +156,14 @@ public:
     QWidget* embeddedWidget() override;
 
 private:
-    glm::quat ConvertToTargetSystem(const glm::quat& qIN, bool flipYZ = false, bool negX = false, bool negY = false, bool negZ = false, bool negW = false);
+    //! Transforms the keys of the character object (bone 0) into the target system
+    static void ConvertObjectRootKeys(Bone& bone, const ConversionKernel& kernel);
 
-    glm::mat4 ConvertToTargetSystem(const glm::mat4& matIn, bool flipYZ = false, bool negX = false, bool negY = false, bool negZ = false, bool negW = false);
-    
-    glm::vec3 ConvertToTargetSystem(const glm::vec3& matIn, bool flipYZ = false, bool negX = false, bool negY = false, bool negZ = false, bool negW = false);
+    //! Reverts the asset specific conversion of the character root bone (bone 1, usually the hip)
+    static void ConvertCharacterRootKeys(Bone& bone, const ConversionKernel& kernel);
+
+    //! Applies the axis permutation and signs to all keys and the rest pose of a bone
+    static void ConvertBoneKeys(Bone& bone, const ConversionKernel& kernel, bool useRestTranslation);
 
 private Q_SLOTS:
     void onChangedCheck(int check);
@@ -26,9 +26,14 @@
 #include <QFileInfo>
 
 #include <FileHandler.h>
+#include <TemporalFilter.h>
+#include <TextWriter.h>
+
+#include <QtConcurrent/QtConcurrentMap>
 
 #include <iostream>
 #include <fstream>
+#include <numeric>
 
 #include "animhosthelper.h"
 
@@ -57,6 +62,8 @@ QJsonObject DataExportPlugin::save() const
 
     nodeJson["overwrite"] = bOverwritePoseSeq;
 
+    nodeJson["parallelText"] = bParallelTextExport;
+
     return nodeJson;
 }
 
@@ -86,6 +93,11 @@ void DataExportPlugin::load(QJsonObject const& p)
         bOverwritePoseSeq = v.toBool();
         bOverwriteJointVelSeq = v.toBool();
     }
+
+    v = p["parallelText"];
+    if (!v.isUndefined()) {
+        bParallelTextExport = v.toBool();
+    }
 }
 
 unsigned int DataExportPlugin::nDataPorts(QtNodes::PortType portType) const
@@ -207,24 +219,35 @@ void DataExportPlugin::run()
                     currentSequenceIndex = 1;
                 }
 
-                // Export each segment
-                for (size_t i = 0; i < segments.size(); i++) {
-                    currentFrameSegment = segments[i];
-                    isFirstSegment = (i == 0);
+                bWriteBinaryData = _cbWriteBinary->isChecked();
 
-                    qDebug() << "[DataExportPlugin] Exporting segment" << (i + 1)
-                             << "with" << currentFrameSegment.size()
-                             << "frames, index:" << currentSequenceIndex;
+                if (bWriteBinaryData) {
+                    // Export each segment
+                    for (size_t i = 0; i < segments.size(); i++) {
+                        currentFrameSegment = segments[i];
+                        isFirstSegment = (i == 0);
 
-                    if (sp_poseSeq && bWritePoseSequence) {
-                        exportPoseSequenceData();
-                    }
+                        qDebug() << "[DataExportPlugin] Exporting segment" << (i + 1)
+                                 << "with" << currentFrameSegment.size()
+                                 << "frames, index:" << currentSequenceIndex;
+
+                        if (sp_poseSeq && bWritePoseSequence) {
+                            writeBinaryPoseSequenceData();
+                        }
+
+                        if (sp_jointVelSeq && bWriteJointVelocity) {
+                            writeBinaryJointVelocitySequence();
+                        }
 
-                    if (sp_jointVelSeq && bWriteJointVelocity) {
-                        exportJointVelocitySequence();
+                        currentSequenceIndex++;
                     }
+                }
+                else {
+                    writeCSVSegments(segments,
+                        (sp_poseSeq && bWritePoseSequence) ? sp_poseSeq->getData().get() : nullptr,
+                        (sp_jointVelSeq && bWriteJointVelocity) ? sp_jointVelSeq->getData().get() : nullptr);
 
-                    currentSequenceIndex++;
+                    currentSequenceIndex += static_cast<int>(segments.size());
                 }
             }
         }
@@ -295,64 +318,106 @@ void DataExportPlugin::onOverrideCheckbox(int state) {
 }
 
 
-void DataExportPlugin::exportPoseSequenceData() {
-    //Check if Binary or CSV
-    bWriteBinaryData = _cbWriteBinary->isChecked();
-
-    if (bWriteBinaryData) {
-        writeBinaryPoseSequenceData();
+std::string DataExportPlugin::csvHeader(const Skeleton& skeleton, const char* leadingColumns)
+{
+    std::string header = leadingColumns;
+    for (int i = 0; i < skeleton.mNumBones; i++) {
+        const std::string& boneName = skeleton.bone_names_reverse.at(i);
+        header += boneName + "_x,";
+        header += boneName + "_y,";
+        header += boneName + "_z";
+        if (i != skeleton.mNumBones - 1)
+            header += ",";
     }
-    else {
-        writeCSVPoseSequenceData();
+    header += "\n";
+    return header;
+}
+
+void DataExportPlugin::writePoseRows(TextWriter& out, const PoseSequence& poses, const std::vector<int>& frames, int sequenceIndex, int numBones)
+{
+    for (int frame : frames) {
+        out << sequenceIndex << ',';
+        out.writeFloats(&poses.mPoseSequence[frame][0].x, numBones * 3);
+        out << '\n';
     }
 }
 
-void DataExportPlugin::writeCSVPoseSequenceData() {
+void DataExportPlugin::writeJointVelocityRows(TextWriter& out, const JointVelocitySequence& velocities, const std::vector<int>& frames, int sequenceIndex, int numBones)
+{
+    for (int frame : frames) {
+        out << sequenceIndex << ',' << frame << ',';
+        out.writeFloats(&velocities.mJointVelocitySequence[frame][0].x, numBones * 3);
+        out << '\n';
+    }
+}
 
+void DataExportPlugin::writeCSVSegments(const std::vector<std::vector<int>>& segments, const PoseSequence* poseSequence, const JointVelocitySequence* jointVelSequence)
+{
     auto skeletonIn = _skeletonIn.lock()->getData();
-    auto poseSequenceIn = _poseSequenceIn.lock()->getData();
+    const int numBones = skeletonIn->mNumBones;
 
-    qDebug() << "Write Pose Data to CSV File";
+    TextWriter poseOut;
+    TextWriter jointVelOut;
 
-    // Use pre-computed segment from run()
-    const std::vector<int>& framesToExport = currentFrameSegment;
-
-    QFile file(exportDirectory+"pose.csv");
+    if (poseSequence) {
+        qDebug() << "Write Pose Data to CSV File";
 
-    if (isFirstSegment && bOverwritePoseSeq) {
-        file.open(QIODevice::WriteOnly | QIODevice::Text);
-    }
-    else {
-        file.open(QIODevice::WriteOnly | QIODevice::Text | QIODevice::Append);
+        if (!poseOut.open(exportDirectory + "pose.csv", !bOverwritePoseSeq))
+            poseSequence = nullptr;
+        else if (bOverwritePoseSeq)
+            poseOut << csvHeader(*skeletonIn, "seq_id,");
     }
 
+    if (jointVelSequence) {
+        qDebug() << "Write Joint Velocity Data to CSV File";
 
-    QTextStream out(&file);
+        if (!jointVelOut.open(exportDirectory + "joint_velocity.csv", !bOverwriteJointVelSeq))
+            jointVelSequence = nullptr;
+        else if (bOverwriteJointVelSeq)
+            jointVelOut << csvHeader(*skeletonIn, "seq_id,frame,");
+    }
 
-    if (isFirstSegment && bOverwritePoseSeq) {
-        out << "seq_id,";
-        for (int i = 0; i < skeletonIn->mNumBones; i++) {
-            out << QString::fromStdString(skeletonIn->bone_names_reverse.at(i)) << "_x,";
-            out << QString::fromStdString(skeletonIn->bone_names_reverse.at(i)) << "_y,";
-            out << QString::fromStdString(skeletonIn->bone_names_reverse.at(i)) << "_z";
-            if (i != skeletonIn->mNumBones - 1)
-                out << ",";
+    // Export only filtered frames using continuous sequence index
+    auto formatSegment = [&](size_t segment, TextWriter& poseText, TextWriter& jointVelText) {
+        int sequenceIndex = currentSequenceIndex + static_cast<int>(segment);
+        if (poseSequence)
+            writePoseRows(poseText, *poseSequence, segments[segment], sequenceIndex, numBones);
+        if (jointVelSequence)
+            writeJointVelocityRows(jointVelText, *jointVelSequence, segments[segment], sequenceIndex, numBones);
+    };
+
+    if (!bParallelTextExport || segments.size() < 2) {
+        for (size_t i = 0; i < segments.size(); i++) {
+            formatSegment(i, poseOut, jointVelOut);
         }
-        out << "\n";
+        return;
     }
 
-    // Export only filtered frames using continuous sequence index
-    for (int frame : framesToExport) {
-        out << currentSequenceIndex << ",";
-        for (int bone = 0; bone < skeletonIn->mNumBones; bone++) {
-            out << poseSequenceIn->mPoseSequence[frame].mPositionData[bone].x << ",";
-            out << poseSequenceIn->mPoseSequence[frame].mPositionData[bone].y << ",";
-            out << poseSequenceIn->mPoseSequence[frame].mPositionData[bone].z;
-            if (bone != skeletonIn->mNumBones - 1)
-                out << ",";
+    // Format a batch of segments on worker threads, each into its own writer, then append them in segment order.
+    // Batching bounds the memory held by formatted but unwritten text.
+    const size_t batchSize = static_cast<size_t>(std::max(1, QThread::idealThreadCount())) * 2;
+
+    std::vector<std::unique_ptr<TextWriter>> poseParts;
+    std::vector<std::unique_ptr<TextWriter>> jointVelParts;
+    for (size_t slot = 0; slot < batchSize; slot++) {
+        poseParts.push_back(std::make_unique<TextWriter>(textPartBufferSize));
+        jointVelParts.push_back(std::make_unique<TextWriter>(textPartBufferSize));
+    }
+
+    for (size_t batchStart = 0; batchStart < segments.size(); batchStart += batchSize) {
+        std::vector<int> slots(std::min(batchSize, segments.size() - batchStart));
+        std::iota(slots.begin(), slots.end(), 0);
 
+        QtConcurrent::blockingMap(slots, [&](const int& slot) {
+            poseParts[slot]->clear();
+            jointVelParts[slot]->clear();
+            formatSegment(batchStart + slot, *poseParts[slot], *jointVelParts[slot]);
+        });
+
+        for (int slot : slots) {
+            poseOut.append(*poseParts[slot]);
+            jointVelOut.append(*jointVelParts[slot]);
         }
-        out << "\n";
     }
 }
 
@@ -377,11 +442,16 @@ void DataExportPlugin::writeBinaryPoseSequenceData() {
 
     QDataStream out(&file);
 
-    int sizeframe = poseSequenceIn->mPoseSequence[0].mPositionData.size() * sizeof(glm::vec3);
+    const JointFrameBuffer& poses = poseSequenceIn->mPoseSequence;
 
-    // Export only filtered frames
-    for (int frame : framesToExport) {
-        out.writeRawData((char*)&poseSequenceIn->mPoseSequence[frame].mPositionData[0], sizeframe);
+    // Export only filtered frames, runs of consecutive frames are contiguous in memory and written at once
+    size_t runStart = 0;
+    for (size_t i = 1; i <= framesToExport.size(); i++) {
+        if (i == framesToExport.size() || framesToExport[i] != framesToExport[i - 1] + 1) {
+            int runLength = static_cast<int>(i - runStart);
+            out.writeRawData(reinterpret_cast<const char*>(poses.frameData(framesToExport[runStart])), static_cast<int>(poses.byteSize(runLength)));
+            runStart = i;
+        }
     }
 
 }
@@ -435,70 +505,6 @@ void DataExportPlugin::writeBinarySkeletonData() {
 //    myfile.close();
 
 
-void DataExportPlugin::exportJointVelocitySequence() {
-    //Check if Binary or CSV
-
-    bWriteBinaryData = _cbWriteBinary->isChecked();
-
-    if (bWriteBinaryData) {
-        writeBinaryJointVelocitySequence();
-    }
-    else {
-        writeCSVJointVelocitySequence();
-    }
-}
-
-void DataExportPlugin::writeCSVJointVelocitySequence() {
-
-    auto skeletonIn = _skeletonIn.lock()->getData();
-    auto jointVelSeqIn = _jointVelocitySequenceIn.lock()->getData();
-
-    qDebug() << "Write Joint Velocity Data to CSV File";
-
-    // Use pre-computed segment from run()
-    const std::vector<int>& framesToExport = currentFrameSegment;
-
-    QFile file(exportDirectory + "joint_velocity.csv");
-
-    if (isFirstSegment && bOverwriteJointVelSeq) {
-        file.open(QIODevice::WriteOnly | QIODevice::Text);
-    }
-    else {
-        file.open(QIODevice::WriteOnly | QIODevice::Text | QIODevice::Append);
-    }
-
-
-    QTextStream out(&file);
-
-    if (isFirstSegment && bOverwriteJointVelSeq) {
-        out << "seq_id,";
-        out << "frame,";
-        for (int i = 0; i < skeletonIn->mNumBones; i++) {
-            out << QString::fromStdString(skeletonIn->bone_names_reverse.at(i)) << "_x,";
-            out << QString::fromStdString(skeletonIn->bone_names_reverse.at(i)) << "_y,";
-            out << QString::fromStdString(skeletonIn->bone_names_reverse.at(i)) << "_z";
-            if (i != skeletonIn->mNumBones - 1)
-                out << ",";
-        }
-        out << "\n";
-    }
-
-    // Export only filtered frames using continuous sequence index
-    for (int frame : framesToExport) {
-        out << currentSequenceIndex << ",";
-        out << frame << ",";
-        for (int bone = 0; bone < skeletonIn->mNumBones; bone++) {
-            out << jointVelSeqIn->mJointVelocitySequence[frame].mJointVelocity[bone].x << ",";
-            out << jointVelSeqIn->mJointVelocitySequence[frame].mJointVelocity[bone].y << ",";
-            out << jointVelSeqIn->mJointVelocitySequence[frame].mJointVelocity[bone].z;
-            if (bone != skeletonIn->mNumBones - 1)
-                out << ",";
-
-        }
-        out << "\n";
-    }
-} 
-
 void DataExportPlugin::writeBinaryJointVelocitySequence() {
 
     auto skeletonIn = _skeletonIn.lock()->getData();
@@ -512,41 +518,49 @@ void DataExportPlugin::writeBinaryJointVelocitySequence() {
     qDebug() << "[DataExportPlugin] JointVelocitySequence frames to export:" << framesToExport.size();
 
     QFile file(exportDirectory + "joint_velocity.bin");
+    QFile filteredFile(exportDirectory + "p_velocity.bin");
 
     QString fileNameIdent = exportDirectory + "sequences_velocity.txt";
 
     if (isFirstSegment && bOverwriteJointVelSeq) {
         file.open(QIODevice::WriteOnly);
+        filteredFile.open(QIODevice::WriteOnly);
         FileHandler<QTextStream>::deleteFile(fileNameIdent);
     }
     else {
         file.open(QIODevice::WriteOnly | QIODevice::Append);
+        filteredFile.open(QIODevice::WriteOnly | QIODevice::Append);
     }
 
-    QDataStream out(&file);
-
-    int sizeframe = jointVelSeqIn->mJointVelocitySequence[0].mJointVelocity.size() * sizeof(glm::vec3);
+    const int channels = jointVelSeqIn->mJointVelocitySequence.jointCount() * 3;
+    const int sizeframe = channels * sizeof(float);
 
-    // Export only filtered frames
-    for (int frame : framesToExport) {
-        out.writeRawData((char*)&jointVelSeqIn->mJointVelocitySequence[frame].mJointVelocity[0], sizeframe);
+    // Gather the segment into one frame-major block, it is written raw and filtered
+    std::vector<float> segment(framesToExport.size() * channels);
+    for (size_t i = 0; i < framesToExport.size(); i++) {
+        memcpy(segment.data() + i * channels, jointVelSeqIn->mJointVelocitySequence.frameData(framesToExport[i]), sizeframe);
+    }
+    file.write(reinterpret_cast<const char*>(segment.data()), segment.size() * sizeof(float));
+
+    // Zero-phase low-pass over the whole segment, as the PAE training expects in p_velocity.bin
+    static const TemporalFilter::IIRCoefficients velocityFilter =
+        TemporalFilter::ButterworthLowPass(velocityFilterOrder, velocityFilterCutoff / (velocityFrameRate / 2.0));
+    if (!TemporalFilter::ZeroPhaseFilter(velocityFilter, segment.data(), framesToExport.size(), channels)) {
+        qWarning() << "[DataExportPlugin] Segment with" << framesToExport.size() << "frames is too short for velocity filtering (minimum"
+                   << MIN_FRAMES_FOR_VELOCITY_FILTERING << ") - writing unfiltered velocities";
     }
+    filteredFile.write(reinterpret_cast<const char*>(segment.data()), segment.size() * sizeof(float));
+
+    TextWriter outID;
+    if (!outID.open(fileNameIdent, true, false))
+        return;
 
-    FileHandler<QTextStream> fileIdent = FileHandler<QTextStream>(fileNameIdent);
-    QTextStream& outID = fileIdent.getStream();
-    QString idString = "";
+    // Columns after the frame number are the same for every line of the segment
+    QByteArray idSuffix = " Standard " + jointVelSeqIn->sourceName.toUtf8() + " " + jointVelSeqIn->dataSetID.toUtf8() + "\n";
 
     // Write sequence identifiers for filtered frames only, using continuous sequence index
     for (int frame : framesToExport) {
-        idString += QString::number(currentSequenceIndex) + " ";
-        idString += QString::number(frame) + " ";
-        idString += "Standard ";
-        idString += jointVelSeqIn->sourceName + " ";
-        idString += jointVelSeqIn->dataSetID;
-
-        idString += "\n";
-        outID << idString;
-        idString = "";
+        outID << currentSequenceIndex << ' ' << frame << idSuffix;
     }
 }
 
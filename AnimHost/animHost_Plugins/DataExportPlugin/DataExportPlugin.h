@@ -30,6 +30,7 @@
 #include <commondatatypes.h>
 
 class QPushButton;
+class TextWriter;
 
 class DATAEXPORTPLUGINSHARED_EXPORT DataExportPlugin : public PluginNodeInterface
 {
@@ -63,6 +64,15 @@ private:
     bool bOverwriteJointVelSeq = true;
     bool bOverwritePoseSeq = true;
 
+    // Format CSV segments on worker threads, the text is still written in segment order
+    bool bParallelTextExport = true;
+    static constexpr size_t textPartBufferSize = 1024 * 1024;
+
+    // Butterworth low-pass applied to the joint velocities written to p_velocity.bin
+    static constexpr int velocityFilterOrder = 5;
+    static constexpr double velocityFilterCutoff = 4.5;     // Hz
+    static constexpr double velocityFrameRate = 60.0;       // Hz
+
     // Continuous sequence indexing
     int currentSequenceIndex = 1;
 
@@ -94,16 +104,25 @@ public:
 
     QWidget* embeddedWidget() override;
 
-    void exportPoseSequenceData();
-    void writeCSVPoseSequenceData();
     void writeBinaryPoseSequenceData();
 
     void writeBinarySkeletonData();
 
-    void exportJointVelocitySequence();
-    void writeCSVJointVelocitySequence();
     void writeBinaryJointVelocitySequence();
 
+    /**
+     * @brief Writes the frames of all segments to pose.csv and joint_velocity.csv.
+     *
+     * Both files are opened once for all segments. Rows are formatted with TextWriter, in parallel per
+     * segment if bParallelTextExport is set.
+     *
+     * @param segments Consecutive frame segments, segment i gets sequence index currentSequenceIndex + i
+     * @param poseSequence Poses to export or nullptr to skip pose.csv
+     * @param jointVelSequence Joint velocities to export or nullptr to skip joint_velocity.csv
+     */
+    void writeCSVSegments(const std::vector<std::vector<int>>& segments, const PoseSequence* poseSequence,
+        const JointVelocitySequence* jointVelSequence);
+
     //QTNodes
     QString category() override { return "Undefined Category"; };  // Returns a category for the node
 
@@ -120,6 +139,12 @@ private:
      */
     std::vector<int> getFramesToProcess(int totalFrames, const QString& sourceName);
 
+    //! CSV header line with x, y and z columns for every bone after \c leadingColumns
+    static std::string csvHeader(const Skeleton& skeleton, const char* leadingColumns);
+
+    static void writePoseRows(TextWriter& out, const PoseSequence& poses, const std::vector<int>& frames, int sequenceIndex, int numBones);
+    static void writeJointVelocityRows(TextWriter& out, const JointVelocitySequence& velocities, const std::vector<int>& frames, int sequenceIndex, int numBones);
+
 private Q_SLOTS:
     void onButtonClicked();
     void onOverrideCheckbox(int state);
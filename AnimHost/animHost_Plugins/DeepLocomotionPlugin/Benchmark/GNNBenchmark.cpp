@@ -0,0 +1,412 @@
+/*
+ ***************************************************************************************
+
+ *   Copyright (c) 2024 Filmakademie Baden-Wuerttemberg, Animationsinstitut R&D Labs
+ *   https://research.animationsinstitut.de/animhost
+ *   https://github.com/FilmakademieRnd/AnimHost
+ *    
+ *   AnimHost is a development by Filmakademie Baden-Wuerttemberg, Animationsinstitut
+ *   R&D Labs in the scope of the EU funded project MAX-R (101070072).
+ *    
+ *   This program is distributed in the hope that it will be useful, but WITHOUT
+ *   ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ *   FOR A PARTICULAR PURPOSE. See the MIT License for more details.
+ *   You should have received a copy of the MIT License along with this program; 
+ *   if not go to https://opensource.org/licenses/MIT
+
+ ***************************************************************************************
+ */
+
+ 
+/**
+ * @file GNNBenchmark.cpp
+ * @brief Standalone inference benchmark for the GNN locomotion controller.
+ *
+ * Drives GNNController with a synthetic straight control path created by ControlPath::CreateTestControlPath
+ * and reports per stage timings, heap allocations and generated frames per second for every requested
+ * onnxruntime thread count as JSON.
+ *
+ * Model loading, skeleton import and the forward kinematics of the seed pose are reported separately
+ * and are not part of the generation timings.
+ *
+ * Usage:
+ *   GNNBenchmark --model <network.onnx> --skeleton <animation.bvh|fbx> [--skeleton-type biped|quad]
+ *                [--frames 360] [--repeats 5] [--warmup 1] [--threads 1,2,4] [--output results.json]
+ *
+ * Allocations are counted by replacing the global operator new of this executable. The controller sources
+ * are compiled into the benchmark for that reason, allocations inside AnimHostCore, BasicOnnxPlugin and
+ * onnxruntime are not included.
+ */
+
+#include "GNNController.h"
+#include "assimphelper.h"
+
+#include <animhosthelper.h>
+#include <commondatatypes.h>
+#include <SkeletonConfig.h>
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QDateTime>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+
+#include <glm/gtx/matrix_decompose.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+
+namespace {
+
+    std::atomic<std::uint64_t> allocationCount{ 0 };
+    std::atomic<std::uint64_t> allocatedBytes{ 0 };
+
+    void* countedAlloc(std::size_t size)
+    {
+        allocationCount.fetch_add(1, std::memory_order_relaxed);
+        allocatedBytes.fetch_add(size, std::memory_order_relaxed);
+
+        if (void* ptr = std::malloc(size ? size : 1)) {
+            return ptr;
+        }
+        throw std::bad_alloc();
+    }
+
+    bool verboseOutput = false;
+
+    // Keeps the controller chatter out of the report, warnings and errors still reach stderr.
+    void benchmarkMessageHandler(QtMsgType type, const QMessageLogContext& context, const QString& msg)
+    {
+        if (!verboseOutput && (type == QtDebugMsg || type == QtInfoMsg)) {
+            return;
+        }
+        std::fprintf(stderr, "%s\n", qPrintable(msg));
+    }
+
+    struct RunResult
+    {
+        double wallMs = 0.0;
+        int frames = 0;
+        std::uint64_t allocations = 0;
+        std::uint64_t bytes = 0;
+        GNNStageTimings stages;
+    };
+
+    double median(std::vector<double> values)
+    {
+        if (values.empty()) {
+            return 0.0;
+        }
+        std::sort(values.begin(), values.end());
+        size_t mid = values.size() / 2;
+        return values.size() % 2 ? values[mid] : 0.5 * (values[mid - 1] + values[mid]);
+    }
+
+    double nsToMs(std::int64_t ns)
+    {
+        return static_cast<double>(ns) / 1.0e6;
+    }
+
+    /**
+     * Imports skeleton and animation the same way the Animation Import node does,
+     * including the sub-skeleton filtering of the selected skeleton type.
+     */
+    bool loadSkeleton(const QString& path, SkeletonType skeletonType, Skeleton& skeleton, Animation& animation)
+    {
+        Assimp::Importer importer;
+        importer.SetPropertyBool(AI_CONFIG_IMPORT_FBX_PRESERVE_PIVOTS, false);
+
+        const aiScene* scene = importer.ReadFile(path.toStdString(),
+            aiProcess_SortByPType |
+            aiProcess_ValidateDataStructure |
+            aiProcess_PopulateArmatureData);
+
+        if (nullptr == scene || !scene->HasAnimations()) {
+            qWarning() << "Loading skeleton failed: " << importer.GetErrorString();
+            return false;
+        }
+
+        Skeleton fullSkeleton;
+        Animation fullAnimation;
+        AssimpHelper::buildSkeletonFormAssimpNode(&fullSkeleton, scene->mRootNode);
+        AssimpHelper::loadAnimationData(scene->mAnimations[0], &fullSkeleton, &fullAnimation, scene->mRootNode);
+
+        const auto& config = getSubSkeletonConfig(skeletonType);
+        try {
+            AssimpHelper::extractSubSkeleton(fullSkeleton, fullAnimation, config.rootBone, config.leafBones, skeleton, animation);
+        }
+        catch (const std::runtime_error& e) {
+            qWarning() << "Loading skeleton failed: " << e.what();
+            return false;
+        }
+
+        if (config.applyChangeOfBasis) {
+            animation.ApplyChangeOfBasis();
+        }
+        return true;
+    }
+
+    /**
+     * Seed pose of the generation, relative to the character root. Mirrors GNNNode::run.
+     */
+    void computeSeedPose(const Skeleton& skeleton, Animation& animation, int frame, GNNController& controller)
+    {
+        std::vector<glm::mat4> transforms;
+        AnimHostHelper::ForwardKinematics(skeleton, animation, transforms, frame);
+
+        glm::mat4 root = animation.CalculateRootTransform(frame, 0);
+        glm::mat4 invRoot = glm::inverse(root);
+
+        controller.initJointPos.clear();
+        controller.initJointRot.clear();
+        controller.initJointVel.clear();
+
+        for (const glm::mat4& transform : transforms) {
+            glm::vec3 scale;
+            glm::quat rotation;
+            glm::vec3 translation;
+            glm::vec3 skew;
+            glm::vec4 perspective;
+
+            glm::decompose(invRoot * transform, scale, rotation, translation, skew, perspective);
+
+            controller.initJointPos.push_back(translation);
+            controller.initJointRot.push_back(rotation);
+            controller.initJointVel.push_back(glm::vec3(0.0f, 0.0f, 0.0f));
+        }
+    }
+
+    QJsonObject stageTotalsToJson(const GNNStageTimings& stages)
+    {
+        QJsonObject json;
+        json["feature_assembly_ms"] = nsToMs(stages.featureAssembly);
+        json["inference_ms"] = nsToMs(stages.inference);
+        json["read_output_ms"] = nsToMs(stages.readOutput);
+        json["root_update_ms"] = nsToMs(stages.rootUpdate);
+        json["build_animation_ms"] = nsToMs(stages.buildAnimation);
+        return json;
+    }
+
+    QJsonObject stagesPerFrameToJson(const GNNStageTimings& stages)
+    {
+        double toUsPerFrame = stages.frames > 0 ? 1.0 / (1.0e3 * stages.frames) : 0.0;
+
+        QJsonObject json;
+        json["feature_assembly_us"] = stages.featureAssembly * toUsPerFrame;
+        json["inference_us"] = stages.inference * toUsPerFrame;
+        json["read_output_us"] = stages.readOutput * toUsPerFrame;
+        json["root_update_us"] = stages.rootUpdate * toUsPerFrame;
+        json["build_animation_us"] = stages.buildAnimation * toUsPerFrame;
+        return json;
+    }
+}
+
+
+void* operator new(std::size_t size) { return countedAlloc(size); }
+void* operator new[](std::size_t size) { return countedAlloc(size); }
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+void operator delete[](void* ptr) noexcept { std::free(ptr); }
+void operator delete(void* ptr, std::size_t) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, std::size_t) noexcept { std::free(ptr); }
+
+
+int main(int argc, char* argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("GNNBenchmark");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Measures animation generation throughput of the GNN controller.");
+    parser.addHelpOption();
+
+    QCommandLineOption modelOption("model", "ONNX network of the controller.", "file");
+    QCommandLineOption skeletonOption("skeleton", "Animation file (bvh, fbx) providing skeleton and seed pose.", "file");
+    QCommandLineOption skeletonTypeOption("skeleton-type", "Sub-skeleton configuration, biped or quad.", "type", "biped");
+    QCommandLineOption framesOption("frames", "Length of the synthetic control path in frames.", "count", "360");
+    QCommandLineOption speedOption("speed", "Control path advance per frame in meters.", "meters", "0.07");
+    QCommandLineOption seedFrameOption("seed-frame", "Animation frame used as seed pose.", "frame", "20");
+    QCommandLineOption repeatsOption("repeats", "Measured generations per thread count.", "count", "5");
+    QCommandLineOption warmupOption("warmup", "Unmeasured generations per thread count.", "count", "1");
+    QCommandLineOption threadsOption("threads", "Comma separated onnxruntime intra op thread counts.", "list", "1");
+    QCommandLineOption outputOption("output", "Write the JSON report to file instead of stdout.", "file");
+    QCommandLineOption verboseOption("verbose", "Print debug output of the controller.");
+
+    parser.addOptions({ modelOption, skeletonOption, skeletonTypeOption, framesOption, speedOption, seedFrameOption,
+        repeatsOption, warmupOption, threadsOption, outputOption, verboseOption });
+    parser.process(app);
+
+    verboseOutput = parser.isSet(verboseOption);
+    qInstallMessageHandler(benchmarkMessageHandler);
+
+    if (!parser.isSet(modelOption) || !parser.isSet(skeletonOption)) {
+        qCritical() << "--model and --skeleton are required.";
+        parser.showHelp(1);
+    }
+
+    const QString modelPath = parser.value(modelOption);
+    const QString skeletonPath = parser.value(skeletonOption);
+    const SkeletonType skeletonType = parser.value(skeletonTypeOption) == "quad" ? SkeletonType::Quadrupedal : SkeletonType::Bipedal;
+    const int frameCount = std::max(1, parser.value(framesOption).toInt());
+    const float speed = parser.value(speedOption).toFloat();
+    const int seedFrame = std::max(0, parser.value(seedFrameOption).toInt());
+    const int repeats = std::max(1, parser.value(repeatsOption).toInt());
+    const int warmup = std::max(0, parser.value(warmupOption).toInt());
+
+    std::vector<int> threadCounts;
+    for (const QString& value : parser.value(threadsOption).split(',', Qt::SkipEmptyParts)) {
+        int threads = value.trimmed().toInt();
+        if (threads > 0) {
+            threadCounts.push_back(threads);
+        }
+    }
+    if (threadCounts.empty()) {
+        threadCounts.push_back(1);
+    }
+
+    // Setup, not part of the generation timings
+    auto skeleton = std::make_shared<Skeleton>();
+    auto animation = std::make_shared<Animation>();
+
+    auto setupStart = std::chrono::steady_clock::now();
+    if (!loadSkeleton(skeletonPath, skeletonType, *skeleton, *animation)) {
+        return 1;
+    }
+    double skeletonLoadMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - setupStart).count();
+
+    auto controlPath = std::make_shared<ControlPath>(ControlPath::CreateTestControlPath(frameCount,
+        glm::vec3(0.f, 0.f, 0.f), glm::vec3(0.0f, 0.0f, speed), 0.f));
+
+    QJsonArray results;
+
+    for (int threads : threadCounts) {
+        auto loadStart = std::chrono::steady_clock::now();
+        GNNController controller(modelPath, threads);
+        double modelLoadMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - loadStart).count();
+
+        if (!controller.network->IsModelValid()) {
+            qCritical() << "Could not load model " << modelPath;
+            return 1;
+        }
+
+        auto seedStart = std::chrono::steady_clock::now();
+        computeSeedPose(*skeleton, *animation, seedFrame, controller);
+        double seedPoseMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - seedStart).count();
+
+        controller.SetAnimationIn(animation);
+        controller.SetSkeleton(skeleton);
+        controller.SetControlPath(controlPath);
+
+        for (int i = 0; i < warmup; i++) {
+            controller.prepareInput();
+        }
+
+        std::vector<RunResult> runs(repeats);
+        GNNStageTimings timings;
+        controller.SetStageTimings(&timings);
+
+        for (RunResult& run : runs) {
+            timings.clear();
+
+            std::uint64_t allocationsBefore = allocationCount.load(std::memory_order_relaxed);
+            std::uint64_t bytesBefore = allocatedBytes.load(std::memory_order_relaxed);
+            auto start = std::chrono::steady_clock::now();
+
+            controller.prepareInput();
+
+            auto end = std::chrono::steady_clock::now();
+            run.allocations = allocationCount.load(std::memory_order_relaxed) - allocationsBefore;
+            run.bytes = allocatedBytes.load(std::memory_order_relaxed) - bytesBefore;
+            run.wallMs = std::chrono::duration<double, std::milli>(end - start).count();
+            run.frames = timings.frames;
+            run.stages = timings;
+
+            if (!controller.GetAnimationOut() || timings.frames != frameCount) {
+                qCritical() << "Generation stopped after " << timings.frames << " of " << frameCount << " frames.";
+                return 1;
+            }
+        }
+
+        controller.SetStageTimings(nullptr);
+
+        QJsonArray runsJson;
+        std::vector<double> fps;
+        std::vector<double> allocationsPerFrame;
+        GNNStageTimings stageSum;
+
+        for (const RunResult& run : runs) {
+            double runFps = run.frames / (run.wallMs / 1000.0);
+            fps.push_back(runFps);
+            allocationsPerFrame.push_back(static_cast<double>(run.allocations) / run.frames);
+
+            stageSum.featureAssembly += run.stages.featureAssembly;
+            stageSum.inference += run.stages.inference;
+            stageSum.readOutput += run.stages.readOutput;
+            stageSum.rootUpdate += run.stages.rootUpdate;
+            stageSum.buildAnimation += run.stages.buildAnimation;
+            stageSum.frames += run.stages.frames;
+
+            QJsonObject runJson;
+            runJson["wall_ms"] = run.wallMs;
+            runJson["frames"] = run.frames;
+            runJson["fps"] = runFps;
+            runJson["allocations"] = static_cast<qint64>(run.allocations);
+            runJson["allocated_bytes"] = static_cast<qint64>(run.bytes);
+            runJson["stages"] = stageTotalsToJson(run.stages);
+            runsJson.append(runJson);
+        }
+
+        QJsonObject result;
+        result["threads"] = threads;
+        result["model_load_ms"] = modelLoadMs;
+        result["seed_pose_ms"] = seedPoseMs;
+        result["fps_median"] = median(fps);
+        result["fps_min"] = *std::min_element(fps.begin(), fps.end());
+        result["fps_max"] = *std::max_element(fps.begin(), fps.end());
+        result["allocations_per_frame"] = median(allocationsPerFrame);
+        result["stages_per_frame"] = stagesPerFrameToJson(stageSum);
+        result["runs"] = runsJson;
+        results.append(result);
+    }
+
+    QJsonObject report;
+    report["benchmark"] = "GNNController";
+    report["timestamp"] = QDateTime::currentDateTimeUtc().toString(Qt::ISODate);
+    report["qt_version"] = qVersion();
+#ifdef NDEBUG
+    report["build_type"] = "Release";
+#else
+    report["build_type"] = "Debug";
+#endif
+    report["model"] = QFileInfo(modelPath).fileName();
+    report["skeleton"] = QFileInfo(skeletonPath).fileName();
+    report["bones"] = skeleton->mNumBones;
+    report["frames"] = frameCount;
+    report["warmup"] = warmup;
+    report["repeats"] = repeats;
+    report["skeleton_load_ms"] = skeletonLoadMs;
+    report["results"] = results;
+
+    QByteArray json = QJsonDocument(report).toJson(QJsonDocument::Indented);
+
+    if (parser.isSet(outputOption)) {
+        QFile file(parser.value(outputOption));
+        if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+            qCritical() << "Could not open " << file.fileName() << " for writing.";
+            return 1;
+        }
+        file.write(json);
+    }
+    else {
+        std::fwrite(json.constData(), 1, json.size(), stdout);
+    }
+
+    return 0;
+}
@@ -46,9 +46,10 @@
 
 
 
-GNNController::GNNController(QString networkPath) : NetworkModelPath(networkPath)
+GNNController::GNNController(QString networkPath, int inferenceThreads) : NetworkModelPath(networkPath)
 {
 	network = std::make_unique<OnnxModel>();	
+	network->SetIntraOpThreads(inferenceThreads);
 	network->LoadOnnxModel(NetworkModelPath);
     debugSignal = std::make_shared<DebugSignal>();
 }
@@ -64,6 +65,7 @@ void GNNController::clearGeneratedData() {
 void GNNController::prepareControlTrajectory() {
 	ctrlTrajPos.clear();
 	ctrlTrajForward.clear();
+	ctrlTrajVel.clear();
 	int idx = 0;
 
 	for (auto& p : controlPath->mControlPath) {
@@ -142,7 +144,24 @@ void GNNController::prepareInput()
 	RootSeries rootSeries;
 	rootSeries.Setup(glm::translate(glm::vec3(ctrlTrajPos[0].x, 0.0f,ctrlTrajPos[0].y)) * glm::toMat4(ctrlTrajForward[0]));
 
+	// Stage timing, only sampled while profiling is enabled
+	std::chrono::steady_clock::time_point stageStart;
+	auto beginStage = [&]() {
+		if (stageTimings) {
+			stageStart = std::chrono::steady_clock::now();
+		}
+	};
+	auto endStage = [&](std::int64_t& stageTotal) {
+		if (stageTimings) {
+			auto now = std::chrono::steady_clock::now();
+			stageTotal += std::chrono::duration_cast<std::chrono::nanoseconds>(now - stageStart).count();
+			stageStart = now;
+		}
+	};
+
 	for (int genIdx = 0; genIdx < ctrlTrajPos.size(); genIdx++) {
+		beginStage();
+
 		//get current root
 
 		if(genIdx == 0){
@@ -205,9 +224,17 @@ void GNNController::prepareInput()
 		BuildInputTensor(inTrajFrame,
 			inJointFrame);
 
+		if (stageTimings) {
+			endStage(stageTimings->featureAssembly);
+		}
+
 		//Inference
 		std::vector<float> inferenceOutputValues = network->RunInference(input_values);
 
+		if (stageTimings) {
+			endStage(stageTimings->inference);
+		}
+
 		if (bExportData) {
 			_exportInputSamples.push_back(input_values);
 			_exportOutputSamples.push_back(inferenceOutputValues);
@@ -218,6 +245,8 @@ void GNNController::prepareInput()
 			return;
 		}
 
+		beginStage();
+
 		std::vector<std::vector<glm::vec2>> outPhase2D;
 		std::vector<std::vector<float>> outAmplitude;
 		std::vector<std::vector<float>> outFrequency;
@@ -239,6 +268,10 @@ void GNNController::prepareInput()
 		genJointPos.push_back(outJointFrame.jointPos);
 		genJointRot.push_back(outJointFrame.jointRot);
 		genJointVel.push_back(outJointFrame.jointVel);
+
+		if (stageTimings) {
+			endStage(stageTimings->readOutput);
+		}
 		
 		// ========================================================================================================
 		// Update Root Transform
@@ -290,6 +323,11 @@ void GNNController::prepareInput()
 		//History
 		genRootPos.push_back({ root[3][0], root[3][2] });
 		genRootForward.push_back(glm::toQuat(glm::mat4(root)));
+
+		if (stageTimings) {
+			endStage(stageTimings->rootUpdate);
+			stageTimings->frames++;
+		}
 		
 		if (genIdx % 10 == 0) {
 			UpdatePlotData(inTrajFrame, outTrajFrame, rootSeries, _testRootSeries, futurePath, ctrlTrajPos, ctrlTrajForward);
@@ -297,8 +335,13 @@ void GNNController::prepareInput()
 		}
 	}
 
+	beginStage();
 	BuildAnimationSequence(genJointRot, rootSeries);
 
+	if (stageTimings) {
+		endStage(stageTimings->buildAnimation);
+	}
+
 	if (bExportData && !_exportInputSamples.empty()) {
 		QDir().mkpath(_exportDir);
 		writeExportData();
@@ -314,23 +357,26 @@ TrajectoryFrameData GNNController::BuildTrajectoryFrameData(const RootSeries& ro
 
 	glm::vec3 forward{ 0.0,0.0,1.0 };
 
+	// Invert the root once for all samples
+	RootSpace rootSpace(Root);
+
 	for (int i : frameRange) {
 
 		// Relative Position
 
-		glm::vec3 Pos = MathUtils::PositionTo(rootSeries.GetPosition(i), Root);
+		glm::vec3 Pos = rootSpace.PositionTo(rootSeries.GetPosition(i));
 		trajFrame.pos.push_back({ Pos.x, Pos.z });
 
 		// Relative Character Forward Direction
 
 		glm::vec3 charFwrd = rootSeries.GetRotation(i) * forward;
-		charFwrd = MathUtils::DirectionTo(charFwrd, Root);
+		charFwrd = rootSpace.DirectionTo(charFwrd);
 		trajFrame.dir.push_back({ charFwrd.x, charFwrd.z });
 
 		// Relative Velocity
 
 		glm::vec3 velocity = rootSeries.GetVelocity(i);
-		velocity = MathUtils::VelocityTo(velocity, Root);
+		velocity = rootSpace.VelocityTo(velocity);
 		trajFrame.vel.push_back({ velocity.x, velocity.z });
 		
 		// Speed
@@ -556,6 +602,7 @@ void GNNController::BuildAnimationSequence(const std::vector<std::vector<glm::qu
 		bone.mNumKeysPosition = bone.mPositonKeys.size();
 		bone.mNumKeysRotation = bone.mRotationKeys.size();
 		bone.mNumKeysScale = 0;
+		bone.UpdateSampling();
 	}
 
 
@@ -574,7 +621,7 @@ std::vector<glm::quat> GNNController::ConvertRotationsToLocalSpace(const std::ve
 		// root space rotation
 		glm::quat rsJointRot = rootSpaceJointRots[idx];
 
-		int parentBoneIdx = AnimHostHelper::FindParentBone(skeleton->bone_hierarchy, idx);
+		int parentBoneIdx = skeleton->getParentBone(idx);
 
 		if (parentBoneIdx != -1) {
 			// parent bone rotation
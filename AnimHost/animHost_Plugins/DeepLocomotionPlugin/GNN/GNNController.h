@@ -77,6 +77,29 @@ struct TrajectoryFrameData
 	}
 };
 
+/**
+ * @struct GNNStageTimings
+ * @brief Accumulated wall clock time per stage of GNNController::prepareInput.
+ *
+ * Filled while a controller has profiling enabled through GNNController::SetStageTimings.
+ * Durations are in nanoseconds and summed over all generated frames of a run, frames counts
+ * the completed inference steps.
+ */
+struct GNNStageTimings
+{
+    std::int64_t featureAssembly = 0; ///< Control path slicing, trajectory and joint features, input tensor.
+    std::int64_t inference = 0; ///< OnnxModel::RunInference.
+    std::int64_t readOutput = 0; ///< readOutput, phase update and generated pose history.
+    std::int64_t rootUpdate = 0; ///< Root transform and root series update.
+    std::int64_t buildAnimation = 0; ///< BuildAnimationSequence after the last frame.
+    int frames = 0;
+
+    void clear()
+    {
+        *this = GNNStageTimings();
+    }
+};
+
 class DEEPLOCOMOTIONPLUGINSHARED_EXPORT GNNController
 {
 private:
@@ -164,6 +187,9 @@ private:
     std::vector<std::vector<float>> _exportInputSamples;
     std::vector<std::vector<float>> _exportOutputSamples;
 
+    // Profiling, not owned
+    GNNStageTimings* stageTimings = nullptr;
+
     //Plotting
     #ifdef DEBUG_PLOT
     matplot::figure_handle figure = nullptr;
@@ -189,7 +215,7 @@ public:
 
 public:
 
-    GNNController(QString networkPath);
+    GNNController(QString networkPath, int inferenceThreads = 1);
     
     void prepareInput();
 
@@ -212,6 +238,12 @@ public:
     std::shared_ptr<Animation> GetAnimationOut();
     std::shared_ptr<DebugSignal> GetDebugSignal(){return debugSignal; }
 
+    /**
+     * Accumulate per stage timings of following prepareInput calls into timings.
+     * Pass nullptr to disable profiling. The timings must outlive the generation.
+     */
+    void SetStageTimings(GNNStageTimings* timings) { stageTimings = timings; }
+
     void EnableDataExport(const QString& dir) {
         bExportData = true;
         _exportDir = dir;
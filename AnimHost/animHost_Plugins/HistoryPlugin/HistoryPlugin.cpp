@@ -25,8 +25,6 @@ HistoryPlugin::HistoryPlugin()
 {
     _lineEdit = nullptr;
 
-    _poseHistory = new RingBuffer<Pose>(100);
-
     _outPoseSeq = std::make_shared<AnimNodeData<PoseSequence>>();
 
 
@@ -91,13 +89,32 @@ void HistoryPlugin::run()
         // Indexing 1st element of posesequence. 
         // We assume sequence in realtime scenario only contains one frame, the current frame.
 
-        Pose pose = poseSeq->mPoseSequence[0];
+        if (!poseSeq->mPoseSequence.empty()) {
+            int jointCount = poseSeq->mPoseSequence.jointCount();
+
+            if (_poseHistory.capacity() == 0 || _poseHistory.jointCount() != jointCount) {
+                _poseHistory.configure(historyCapacity, jointCount);
+            }
 
-        _poseHistory->updateBuffer(pose);
+            _poseHistory.push(poseSeq->mPoseSequence.frameData(0), jointCount);
+        }
     }
 
-    auto pastFrames = _poseHistory->getPastFrames(numHistoryFrames);
-    _outPoseSeq->getData()->mPoseSequence = pastFrames;
+    // Reuse the output buffer, resizing to an unchanged shape does not allocate.
+    // Frames without history yet are left at zero.
+    PoseWindow pastFrames = _poseHistory.latest(numHistoryFrames);
+    auto& outPoses = _outPoseSeq->getData()->mPoseSequence;
+    outPoses.resize(numHistoryFrames, pastFrames.jointCount());
+
+    for (int i = 0; i < numHistoryFrames; i++) {
+        if (i < pastFrames.size()) {
+            const glm::vec3* positions = pastFrames.frame(i);
+            std::copy(positions, positions + pastFrames.jointCount(), outPoses.frameData(i));
+        }
+        else {
+            std::fill(outPoses.frameData(i), outPoses.frameData(i) + outPoses.jointCount(), glm::vec3(0.0f));
+        }
+    }
 
 }
 
@@ -26,7 +26,7 @@
 #include <QMetaType>
 #include <QtWidgets>
 #include <pluginnodeinterface.h>
-#include "HistoryHelper.h"
+#include <PoseRingBuffer.h>
 
 
 class HISTORYPLUGINSHARED_EXPORT HistoryPlugin : public PluginNodeInterface
@@ -43,7 +43,10 @@ private:
     
     int numHistoryFrames = 1;
 
-    RingBuffer<Pose>* _poseHistory = nullptr;
+    static constexpr int historyCapacity = 100;
+
+    // Allocated once per joint count, pushing a frame copies into a preallocated slot
+    PoseRingBuffer _poseHistory;
 
 private:
 
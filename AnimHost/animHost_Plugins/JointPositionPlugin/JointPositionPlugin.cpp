@@ -56,7 +56,7 @@ void JointPositionPlugin::run(QVariantList in, QVariantList& out)
     auto poseSequence = std::make_shared<PoseSequence>();
     int frame = 0;
   
-    poseSequence->mPoseSequence = std::vector<Pose>(animation->mDurationFrames);
+    poseSequence->mPoseSequence.resize(animation->mDurationFrames, skeleton->mNumBones);
 
 
     //std::function<void(glm::mat4, int)> lBuildPose;
@@ -94,8 +94,6 @@ void JointPositionPlugin::run(QVariantList in, QVariantList& out)
         int initcurrentBone = 0;
         glm::mat4 initcurrentPos(1.0f);
 
-        poseSequence->mPoseSequence[frame].mPositionData = std::vector<glm::vec3>(skeleton->mNumBones, glm::vec3(0.0));
-
         //lBuildPose(initcurrentPos, initcurrentBone);
 
 
@@ -103,7 +101,7 @@ void JointPositionPlugin::run(QVariantList in, QVariantList& out)
         AnimHostHelper::ForwardKinematics(*skeleton, *animation, transforms, frame);
 
         for(int j = 0; j < skeleton->mNumBones; j++) {
-			poseSequence->mPoseSequence[frame].mPositionData[j] = transforms[j] * glm::vec4(0.0, 0.0, 0.0, 1.0);
+			poseSequence->mPoseSequence[frame][j] = transforms[j] * glm::vec4(0.0, 0.0, 0.0, 1.0);
 		}
 
         frame++;
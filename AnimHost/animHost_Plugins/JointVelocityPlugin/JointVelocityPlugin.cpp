@@ -83,8 +83,10 @@ void JointVelocityPlugin::run(QVariantList in, QVariantList& out)
 
     // Do new Stuff
 
+    const int nBones = poseSequenceIn->mPoseSequence.jointCount();
+    jointVelocitySequence->mJointVelocitySequence.resize(poseSequenceIn->mPoseSequence.size(), nBones);
+
     for (int frame = 0; frame < poseSequenceIn->mPoseSequence.size(); frame++) {
-        jointVelocitySequence->mJointVelocitySequence.push_back(JointVelocity());
 
      
         glm::mat4x4 prevTRS = animationIn->mBones[0].GetTransform(glm::max(0, frame - 1));
@@ -93,13 +95,13 @@ void JointVelocityPlugin::run(QVariantList in, QVariantList& out)
         glm::mat4x4 inv_prevTRS = glm::inverse(prevTRS);
         glm::mat4x4 inv_currTRS = glm::inverse(currTRS);
            
-        for (int bone = 0; bone < poseSequenceIn->mPoseSequence[frame].mPositionData.size(); bone++) {
+        for (int bone = 0; bone < nBones; bone++) {
 
-            glm::vec3 prevPos = inv_prevTRS * glm::vec4(poseSequenceIn->mPoseSequence[glm::max(0, frame - 1)].mPositionData[bone],1);
-            glm::vec3 currPos = inv_currTRS * glm::vec4(poseSequenceIn->mPoseSequence[frame].mPositionData[bone],1);
+            glm::vec3 prevPos = inv_prevTRS * glm::vec4(poseSequenceIn->mPoseSequence[glm::max(0, frame - 1)][bone],1);
+            glm::vec3 currPos = inv_currTRS * glm::vec4(poseSequenceIn->mPoseSequence[frame][bone],1);
             
             glm::vec3 v  =  (currPos - prevPos) / (1.f / 60.f); // Velociy Unit: m/s
-            jointVelocitySequence->mJointVelocitySequence[frame].mJointVelocity.push_back(v/ 100.f);
+            jointVelocitySequence->mJointVelocitySequence[frame][bone] = v / 100.f;
            
         }
     }
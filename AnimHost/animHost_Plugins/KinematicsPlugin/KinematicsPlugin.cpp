@@ -0,0 +1,76 @@
+/*
+ ***************************************************************************************
+
+ *   Copyright (c) 2024 Filmakademie Baden-Wuerttemberg, Animationsinstitut R&D Labs
+ *   https://research.animationsinstitut.de/animhost
+ *   https://github.com/FilmakademieRnd/AnimHost
+ *    
+ *   AnimHost is a development by Filmakademie Baden-Wuerttemberg, Animationsinstitut
+ *   R&D Labs in the scope of the EU funded project MAX-R (101070072).
+ *    
+ *   This program is distributed in the hope that it will be useful, but WITHOUT
+ *   ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ *   FOR A PARTICULAR PURPOSE. See the MIT License for more details.
+ *   You should have received a copy of the MIT License along with this program; 
+ *   if not go to https://opensource.org/licenses/MIT
+
+ ***************************************************************************************
+ */
+
+ 
+#include "KinematicsPlugin.h"
+#include "animhosthelper.h"
+
+KinematicsPlugin::KinematicsPlugin()
+{
+    //Data
+    inputs.append(QMetaType::fromName("Skeleton"));
+    inputs.append(QMetaType::fromName("Animation"));
+
+    outputs.append(QMetaType::fromName("PoseSequence"));
+    outputs.append(QMetaType::fromName("JointVelocitySequence"));
+}
+
+KinematicsPlugin::~KinematicsPlugin()
+{
+}
+
+// execute the main functionality of the plugin
+void KinematicsPlugin::run(QVariantList in, QVariantList& out)
+{
+    qDebug() << "Running KinematicsPlugin";
+
+    auto skeleton = in[0].value<std::shared_ptr<Skeleton>>();
+    auto animation = in[1].value<std::shared_ptr<Animation>>();
+
+    auto poseSequence = std::make_shared<PoseSequence>();
+    auto jointVelocitySequence = std::make_shared<JointVelocitySequence>();
+
+    AnimHostHelper::ComputeKinematics(*skeleton, *animation, *poseSequence, *jointVelocitySequence);
+
+    poseSequence->dataSetID = animation->dataSetID;
+    poseSequence->sourceName = animation->sourceName;
+    poseSequence->sequenceID = animation->sequenceID;
+
+    jointVelocitySequence->dataSetID = animation->dataSetID;
+    jointVelocitySequence->sourceName = animation->sourceName;
+    jointVelocitySequence->sequenceID = animation->sequenceID;
+
+    out.append(QVariant::fromValue(poseSequence));
+    out.append(QVariant::fromValue(jointVelocitySequence));
+}
+
+QString KinematicsPlugin::category()
+{
+    return "Operator";
+}
+
+QList<QMetaType> KinematicsPlugin::inputTypes()
+{
+    return inputs;
+}
+
+QList<QMetaType> KinematicsPlugin::outputTypes()
+{
+    return outputs;
+}
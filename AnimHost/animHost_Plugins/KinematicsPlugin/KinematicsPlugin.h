@@ -0,0 +1,52 @@
+/*
+ ***************************************************************************************
+
+ *   Copyright (c) 2024 Filmakademie Baden-Wuerttemberg, Animationsinstitut R&D Labs
+ *   https://research.animationsinstitut.de/animhost
+ *   https://github.com/FilmakademieRnd/AnimHost
+ *    
+ *   AnimHost is a development by Filmakademie Baden-Wuerttemberg, Animationsinstitut
+ *   R&D Labs in the scope of the EU funded project MAX-R (101070072).
+ *    
+ *   This program is distributed in the hope that it will be useful, but WITHOUT
+ *   ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ *   FOR A PARTICULAR PURPOSE. See the MIT License for more details.
+ *   You should have received a copy of the MIT License along with this program; 
+ *   if not go to https://opensource.org/licenses/MIT
+
+ ***************************************************************************************
+ */
+
+ 
+#ifndef KINEMATICSPLUGIN_H
+#define KINEMATICSPLUGIN_H
+
+#include "KinematicsPlugin_global.h"
+#include <QMetaType>
+#include <plugininterface.h>
+
+//! Fused joint position and joint velocity computation
+/*!
+ * Produces the outputs of JointPositionPlugin and JointVelocityPlugin in a single pass over the frames of a clip,
+ * see AnimHostHelper::ComputeKinematics
+ */
+class KINEMATICSPLUGINSHARED_EXPORT KinematicsPlugin : public PluginInterface
+{
+    Q_OBJECT
+    Q_PLUGIN_METADATA(IID "de.animhost.Kinematics" FILE "KinematicsPlugin.json")
+    Q_INTERFACES(PluginInterface)
+
+public:
+    KinematicsPlugin();
+    ~KinematicsPlugin();
+    void run(QVariantList in, QVariantList& out) override;
+    QObject* getObject() { return this; }
+
+    //QTNodes
+    QString category() override;  // Returns a category for the node
+    QList<QMetaType> inputTypes() override;  // Returns input data types
+    QList<QMetaType> outputTypes() override;  // Returns output data types
+
+};
+
+#endif // KINEMATICSPLUGIN_H
@@ -19,45 +19,15 @@
 
  
 
-#ifndef HISTORYHELPERPLUGIN_H
-#define HISTORYHELPERPLUGIN_H
+#ifndef KINEMATICSPLUGINSHARED_GLOBAL_H
+#define KINEMATICSPLUGINSHARED_GLOBAL_H
 
-#include "HistoryPlugin_global.h"
-#include <QMetaType>
-#include <pluginnodeinterface.h>
+#include <QtCore/qglobal.h>
 
-template<class T>
-class HISTORYPLUGINSHARED_EXPORT RingBuffer
-{
-private:
-    int bufferSize;
-    int currentPos;
+#if defined(KINEMATICSPLUGIN_LIBRARY)
+#define KINEMATICSPLUGINSHARED_EXPORT Q_DECL_EXPORT
+#else
+#define KINEMATICSPLUGINSHARED_EXPORT Q_DECL_IMPORT
+#endif
 
-    std::vector<T> buffer;
-
-public:
-    RingBuffer(int capacity): bufferSize(capacity), currentPos(0) {
-
-        buffer.resize(capacity, T());
-    };
-
-
-    void updateBuffer(T inData) {
-        buffer[currentPos] = inData;
-        currentPos = (currentPos + 1) % bufferSize; //Wrap around when full
-    }
-
-    std::vector<T> getPastFrames(int numFrames) {
-        std::vector<T> pastFrames;
-
-        for (int i = 0; i < numFrames; i++) {
-            int index = (currentPos - i - 1 + bufferSize) % bufferSize;
-
-            pastFrames.push_back(buffer[index]);
-        }
-        return pastFrames;
-    }
-
-};
-
-#endif // HISTORYHELPERPLUGIN_H
+#endif // KINEMATICSPLUGIN_GLOBAL_H
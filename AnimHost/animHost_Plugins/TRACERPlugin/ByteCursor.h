@@ -0,0 +1,100 @@
+/*
+ ***************************************************************************************
+
+ *   Copyright (c) 2024 Filmakademie Baden-Wuerttemberg, Animationsinstitut R&D Labs
+ *   https://research.animationsinstitut.de/animhost
+ *   https://github.com/FilmakademieRnd/AnimHost
+ *    
+ *   AnimHost is a development by Filmakademie Baden-Wuerttemberg, Animationsinstitut
+ *   R&D Labs in the scope of the EU funded project MAX-R (101070072).
+ *    
+ *   This program is distributed in the hope that it will be useful, but WITHOUT
+ *   ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ *   FOR A PARTICULAR PURPOSE. See the MIT License for more details.
+ *   You should have received a copy of the MIT License along with this program; 
+ *   if not go to https://opensource.org/licenses/MIT
+
+ ***************************************************************************************
+ */
+
+ 
+
+
+#ifndef BYTECURSOR_H
+#define BYTECURSOR_H
+
+#include <QByteArray>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+//!
+//! @brief Bounds checked sequential reader over a received TRACER package
+//!
+//! Reads values directly from the buffer of the QByteArray without creating slices.
+//! Contiguous arrays are copied with a single memcpy. Values are read in host byte order,
+//! like the packages sent by the TRACER clients (little endian).
+//! A read beyond the end of the buffer fails, leaves the output untouched and marks the cursor as failed,
+//! all following reads fail as well.
+//!
+class ByteCursor
+{
+private:
+    const char* _data;
+    qsizetype _size;
+    qsizetype _position = 0;
+    bool _ok = true;
+
+public:
+    explicit ByteCursor(const QByteArray& bytes) : _data(bytes.constData()), _size(bytes.size()) {};
+
+    bool ok() const { return _ok; }
+    bool atEnd() const { return !_ok || _position >= _size; }
+    qsizetype position() const { return _position; }
+    qsizetype remaining() const { return _ok ? _size - _position : 0; }
+
+    //! Returns a pointer to the next bytes and advances the cursor, nullptr if fewer bytes are left
+    const char* take(qsizetype bytes) {
+        if (!_ok || bytes < 0 || bytes > _size - _position) {
+            _ok = false;
+            return nullptr;
+        }
+        const char* current = _data + _position;
+        _position += bytes;
+        return current;
+    }
+
+    bool skip(qsizetype bytes) {
+        return take(bytes) != nullptr;
+    }
+
+    template <typename T>
+    bool read(T& value) {
+        static_assert(std::is_trivially_copyable<T>::value, "ByteCursor reads trivially copyable types only");
+
+        const char* bytes = take(sizeof(T));
+        if (!bytes) {
+            return false;
+        }
+        std::memcpy(&value, bytes, sizeof(T));
+        return true;
+    }
+
+    //! Replaces the content of values with count elements copied in one block
+    template <typename T>
+    bool readArray(std::vector<T>& values, qsizetype count) {
+        static_assert(std::is_trivially_copyable<T>::value, "ByteCursor reads trivially copyable types only");
+
+        const char* bytes = (count >= 0 && count <= remaining() / qsizetype(sizeof(T))) ? take(count * sizeof(T)) : take(-1);
+        if (!bytes) {
+            return false;
+        }
+        values.resize(count);
+        if (count > 0) {
+            std::memcpy(values.data(), bytes, count * sizeof(T));
+        }
+        return true;
+    }
+};
+
+#endif // BYTECURSOR_H
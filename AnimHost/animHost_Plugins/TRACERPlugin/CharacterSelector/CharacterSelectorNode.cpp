@@ -23,6 +23,8 @@
 #include <QComboBox>
 #include <QPushButton>
 
+#include <algorithm>
+
 CharacterSelectorNode::CharacterSelectorNode()
 {
     _widget = nullptr;
@@ -63,8 +65,26 @@ void CharacterSelectorNode::processInData(std::shared_ptr<NodeData> data, QtNode
     _characterListIn = std::static_pointer_cast<AnimNodeData<CharacterObjectSequence>>(data);
 
     if (auto spCharacterList = _characterListIn.lock()) {
+        auto characterList = spCharacterList->getData();
+
+        // Parameter updates only modify existing characters. Keep the menu and the selection,
+        // and forward the selected character only if it is one of the changed objects
+        if (!characterList->changedObjectIDs.empty() && _selectionMenu->count() == static_cast<int>(characterList->mCharacterObjectSequence.size())) {
+            int index = _selectionMenu->currentIndex();
+            if (index >= 0) {
+                const CharacterObject& selectedCharacter = characterList->mCharacterObjectSequence.at(index);
+                const std::vector<int>& changedIDs = characterList->changedObjectIDs;
+
+                if (std::find(changedIDs.begin(), changedIDs.end(), selectedCharacter.sceneObjectID) != changedIDs.end()) {
+                    _characterOut->getData()->fill(selectedCharacter);
+                    emitDataUpdate(0);
+                }
+            }
+            return;
+        }
+
         _selectionMenu->clear();
-        for (CharacterObject chpkg : spCharacterList->getData()->mCharacterObjectSequence) {
+        for (CharacterObject chpkg : characterList->mCharacterObjectSequence) {
             qDebug() << "Received Character" << chpkg.objectName << "with ID" << chpkg.sceneObjectID;
             _selectionMenu->addItem(QString::fromStdString(chpkg.objectName));
         }
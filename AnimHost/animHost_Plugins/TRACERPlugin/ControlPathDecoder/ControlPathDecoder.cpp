@@ -2,6 +2,8 @@
 #include <QPushButton>
 #include "animhosthelper.h"
 
+#include <algorithm>
+
 ControlPathDecoderNode::ControlPathDecoderNode()
 {
     _pushButton = nullptr;
@@ -148,80 +150,63 @@ void ControlPathDecoderNode::run()
     auto spCharacterIn = _characterIn.lock();
     if (spCharacterIn && isDataAvailable()) {
 
-        std::vector<ControlPoint> path = {};
-        //path->initializePath();
-
         qDebug() << "Processing Control Path" << _controlPathID;
         qDebug() << "Number of Control Points" << this->_pointLocation.size();
         qDebug() << "Number of Control Rotations" << this->_pointRotation.size();
 
-        //Construct the path
-        for (int i = 0; i < this->_pointLocation.size() - 1; i++) {
-            qDebug() << "Processing Control Segment starting at" << i;
-            glm::vec3   thisLoc = this->_pointLocation.at(i).value;
-            glm::vec3   outTang = this->_pointLocation.at(i).outTangentValue;
-            int         firstFrame = this->_pointLocation.at(i).time;
-            int         easeOut = this->_pointLocation.at(i).outTangentTime;
-
-            glm::vec3   nextLoc = this->_pointLocation.at(i + 1).value;
-            glm::vec3   inTang = this->_pointLocation.at(i + 1).inTangentValue;
-            int         lastFrame = this->_pointLocation.at(i + 1).time;
-            int         easeIn = this->_pointLocation.at(i + 1).inTangentTime;
-
-            glm::quat thisRot = this->_pointRotation.at(i).value;
-            glm::quat nextRot = this->_pointRotation.at(i + 1).value;
-
-            std::vector<ControlPoint>* sampledSegment = adaptiveSegmentSampling(thisLoc, outTang, inTang, nextLoc, easeOut, easeIn, thisRot, nextRot, firstFrame, lastFrame);
-
-            //linear interpolation thisLoc and nextLoc by amount of frames between thisFrame and nextFrame, create control points for each frame
-
-            // Linear interpolation for position and rotation
-            for (int frame = firstFrame; frame <= lastFrame; frame++) {
-                float t = (frame - firstFrame) / float(lastFrame - firstFrame); // Normalized time [0, 1]
-
-                // Linearly interpolate position and rotation
-                glm::vec3 interpolatedLoc = glm::mix(thisLoc, nextLoc, t);
-                glm::quat interpolatedRot = glm::slerp(thisRot, nextRot, t);
-
-                // Create and add a control point to the path
-                ControlPoint cp;
-                cp.position = interpolatedLoc;
-                cp.lookAt = interpolatedRot;
-                cp.frameTimestamp = frame;
-
-                path.push_back(cp);
+        const int nPoints = static_cast<int>(std::min(this->_pointLocation.size(), this->_pointRotation.size()));
+        if (nPoints < 2) {
+            qDebug() << "Control Path needs at least two points";
+            return;
+        }
+        for (int i = 0; i < nPoints - 1; i++) {
+            if (int(this->_pointLocation.at(i + 1).time) <= int(this->_pointLocation.at(i).time)) {
+                qWarning() << "Control Path points are not ordered in time, ignoring the path";
+                return;
             }
+        }
 
+        const int pathStart = this->_pointLocation.front().time;
+        const int pathEnd = this->_pointLocation.at(nPoints - 1).time;
 
+        // One control point per frame, the segments write into their own range of the path
+        std::vector<ControlPoint> path(pathEnd - pathStart + 1);
 
+        //Construct the path
+        for (int i = 0; i < nPoints - 1; i++) {
+            const KeyFrame<glm::vec3>& thisKey = this->_pointLocation.at(i);
+            const KeyFrame<glm::vec3>& nextKey = this->_pointLocation.at(i + 1);
 
+            int firstFrame = thisKey.time;
+            int lastFrame = nextKey.time;
 
-            // Grow the control path associated with the selected character. This will be passed as control signal onto the GNN
-            //path.insert(path.end(), sampledSegment->begin(), sampledSegment->end());
+            BezierSegment segment(thisKey.value, thisKey.outTangentValue, nextKey.inTangentValue, nextKey.value);
 
-            // For every segnment which is not the last one,
-            // remove its last frame because the first element of the next segment will duplicate it
-            /*if (path.size() > 0 && i < this->_pointLocation.size() - 2)
-                path.pop_back();*/
+            // The last frame of a segment is the first of the next one, so every segment covers [firstFrame, lastFrame)
+            adaptiveSegmentSampling(segment, thisKey.outTangentTime / 100.f, nextKey.inTangentTime / 100.f,
+                                    this->_pointRotation.at(i).value, this->_pointRotation.at(i + 1).value,
+                                    firstFrame, lastFrame, path.data() + (firstFrame - pathStart));
         }
+        path.back() = ControlPoint(this->_pointLocation.at(nPoints - 1).value, this->_pointRotation.at(nPoints - 1).value, pathEnd, 0.f);
 
         // TODO: If path is cyclic, evaluate last-to-first segment
 
         // Apply transforms to controllpath if source is Blender
         if (_pathFromBlenderChecked) {
+            const glm::mat4 toGlobal = AnimHostHelper::GetCoordinateSystemTransformationMatrix();
             for (int i = 0; i < path.size(); i++) {
 				// Transform the control points to the global coordinate system
-				path[i].position = AnimHostHelper::GetCoordinateSystemTransformationMatrix() * glm::vec4(path[i].position, 1.0f);
+				path[i].position = toGlobal * glm::vec4(path[i].position, 1.0f);
 
 				// Rotate the control points to the global coordinate system
 				glm::vec3 lookAt = path[i].lookAt * glm::vec3(0, -1.f, 0);
-				lookAt = AnimHostHelper::GetCoordinateSystemTransformationMatrix() * glm::vec4(lookAt, 0.0f);
+				lookAt = toGlobal * glm::vec4(lookAt, 0.0f);
 				path[i].lookAt = glm::rotation(glm::vec3(0, 0, 1), lookAt);
             }
 
         }
 
-        spCharacterIn->getData()->setPath(path);
+        spCharacterIn->getData()->setPath(std::move(path));
         emitDataUpdate(0);
         emitRunNextNode();
     }
@@ -232,69 +217,77 @@ void ControlPathDecoderNode::run()
 ******** HELPER FUNCTIONS ********
 *********************************/
 
-std::vector<ControlPoint>* ControlPathDecoderNode::adaptiveSegmentSampling(glm::vec3        knot1,      glm::vec3   handle1,    glm::vec3   handle2,    glm::vec3   knot2,
-                                                                           float            easeFrom,   float       easeTo,
-                                                                           glm::quat        quat1,      glm::quat   quat2,
-                                                                           int              frame1,     int         frame2,
-                                                                           ControlPoint*    lastCP) {
-    int nSamples = frame2 - frame1;
-    std::vector<ControlPoint>* sampledSegment = new std::vector<ControlPoint>();
-    std::vector<float> timings = adaptiveTimingsResampling(easeFrom/100, easeTo/100, nSamples);
-    
-    // Assuming that size of timings == nSamples
-    for (int i = 0; i < nSamples; i++) {
-        glm::vec3 sampledPos = sampleBezier(knot1, handle1, handle2, knot2, timings[i]);
-        glm::quat sampledRot = glm::normalize(glm::slerp(quat1, quat2, timings[i]));
-        //float vel = glm::length(sampledSegment->end()->position - sampledPos) / (1.f / 60.f);
-
-        // build Control Point 
-        ControlPoint sampledPoint = ControlPoint(sampledPos, sampledRot, frame1 + i, 0.f);
-
-        sampledSegment->push_back(sampledPoint);
-    }
-
-    return sampledSegment;
-}
-
-// Looking for y-value given a specific x-value on the oversampled Beziér Spline
-// We need to obtain samples at regular intervals on the x-axis to represent the time compression/dialation expressed by the easeFrom-easeTo values
-// The pre-sampling step is needed to obtain the shape of the Beziér curve representing the time easing function
-// The re-sampled values will be used as timings for sampling the (2D) Beziér Spline that represents the selected control path
-std::vector<float> ControlPathDecoderNode::adaptiveTimingsResampling(float easeFrom, float easeTo, int nSamples) {
-    // Good results with oversampling by a factor of 10 but no interpolation or with interpolation but no oversampling
-    // At the moment, doing both :)
-    std::vector<float> timings(nSamples);
-    std::vector<glm::vec3> preSampling(10* nSamples);
-
-    for (int i = 0; i < preSampling.size(); i++) {
-        float oversamplingT = i / (10.0f * nSamples);
-        preSampling[i] = ControlPathDecoderNode::sampleBezier(glm::vec3(0, 0, 0), glm::vec3(easeFrom, 0, 0), glm::vec3(1 - easeTo, 1, 0), glm::vec3(1, 1, 0), oversamplingT);
+void ControlPathDecoderNode::adaptiveSegmentSampling(const BezierSegment&   segment,
+                                                     float                  easeFrom,   float       easeTo,
+                                                     glm::quat              quat1,      glm::quat   quat2,
+                                                     int                    frame1,     int         frame2,
+                                                     ControlPoint*          sampledSegment) {
+    const int nSamples = frame2 - frame1;
+    easeFrom = glm::clamp(easeFrom, 0.f, 1.f);
+    easeTo = glm::clamp(easeTo, 0.f, 1.f);
+
+    // Cumulative chord lengths at regular parameter steps approximate the arc length up to each step
+    float arcLength[arcLengthSamples + 1];
+    arcLength[0] = 0.f;
+    glm::vec3 prevPos = segment.evaluate(0.f);
+    for (int k = 1; k <= arcLengthSamples; k++) {
+        glm::vec3 pos = segment.evaluate(float(k) / arcLengthSamples);
+        arcLength[k] = arcLength[k - 1] + glm::length(pos - prevPos);
+        prevPos = pos;
     }
+    const float totalLength = arcLength[arcLengthSamples];
 
+    // Eased timings grow monotonically, so both the easing solution and the table position only move forward
+    float s = 0.f;
+    int k = 0;
     for (int i = 0; i < nSamples; i++) {
-        float t = (float) i / nSamples;
-        int j = 0;
+        float easedT = easedTiming(easeFrom, easeTo, float(i) / nSamples, s);
 
-        // Finding the pre-sample with the largest x-value lower than t
-        while (preSampling[j].x <= t)
-            j++;
-        
-        float t1 = (t - preSampling[j - 1].x) / (preSampling[j].x - preSampling[j - 1].x);  // Finding the interpolating value of t wrt the j-th and j-1-th sample (i.e. the interpolating weight)
-        float easedT = t1 * preSampling[j].y + (1 - t1) * preSampling[j - 1].y;             // Getting the eased t value by interpolating between the the y-values of the j-th and j-1-th, given t1 (the computed interpolating weight)
+        // Find the chord containing the target length and interpolate the parameter linearly within it
+        float targetLength = easedT * totalLength;
+        while (k < arcLengthSamples - 1 && arcLength[k + 1] < targetLength)
+            k++;
+        float chordLength = arcLength[k + 1] - arcLength[k];
+        float chordT = chordLength > 0.f ? glm::clamp((targetLength - arcLength[k]) / chordLength, 0.f, 1.f) : 0.f;
+        float u = (k + chordT) / arcLengthSamples;
 
-        timings[i] = easedT;
-    }
+        glm::vec3 sampledPos = segment.evaluate(u);
+        glm::quat sampledRot = glm::normalize(glm::slerp(quat1, quat2, easedT));
 
-    return timings;
+        // build Control Point 
+        sampledSegment[i] = ControlPoint(sampledPos, sampledRot, frame1 + i, 0.f);
+    }
 }
 
-// Implementation of the textbook Beziér interpolation function
-glm::vec3 ControlPathDecoderNode::sampleBezier(glm::vec3 knot1, glm::vec3 handle1, glm::vec3 handle2, glm::vec3 knot2, float t) {
-    glm::vec3 sample =  (                         glm::pow((1 - t), 3.0f) *   knot1 ) +
-                        ( 3 *          t        * glm::pow((1 - t), 2.0f) * handle1 ) +
-                        ( 3 * glm::pow(t, 2.0f) *          (1 - t)        * handle2 ) +
-                        (     glm::pow(t, 3.0f)                           *   knot2 );
-    return sample;
+// Looking for y-value given a specific x-value on the Beziér Spline representing the time easing function
+// The curve runs from (0, 0) to (1, 1) with handles (easeFrom, 0) and (1 - easeTo, 1), so x is monotone in s for eases in [0, 1]
+// x(s) = t is solved with Newton steps, falling back to bisection whenever a step leaves the bracket around the root
+float ControlPathDecoderNode::easedTiming(float easeFrom, float easeTo, float t, float& s) {
+    // x(s) in power basis
+    const float p1 = 3.f * easeFrom;
+    const float p2 = 3.f * (1.f - easeTo) - 6.f * easeFrom;
+    const float p3 = 1.f + 3.f * easeFrom - 3.f * (1.f - easeTo);
+
+    float lo = glm::clamp(s, 0.f, 1.f);
+    float hi = 1.f;
+    s = lo;
+    for (int iter = 0; iter < 16; iter++) {
+        float x = s * (p1 + s * (p2 + s * p3)) - t;
+        if (std::abs(x) < 1e-6f)
+            break;
+
+        if (x < 0.f)
+            lo = s;
+        else
+            hi = s;
+
+        float dx = p1 + s * (2.f * p2 + s * 3.f * p3);
+        float next = dx > 1e-6f ? s - x / dx : -1.f;
+        s = (next > lo && next < hi) ? next : 0.5f * (lo + hi);
+    }
+
+    // y(s) = 3s^2(1 - s) + s^3
+    return s * s * (3.f - 2.f * s);
 }
 
 /********************************/
@@ -43,13 +43,35 @@ private:
     std::shared_ptr<AnimNodeData<ControlPath>> _OutControlPath;
 
     // Helper functions for adaptive Beziér Sampling
-    static std::vector<ControlPoint>*   adaptiveSegmentSampling(glm::vec3       knot1,      glm::vec3   handle1,    glm::vec3   handle2,    glm::vec3   knot2,
+
+    //! Cubic Beziér segment converted to power basis, so that a sample costs three multiply-adds per axis
+    struct BezierSegment {
+        glm::vec3 c0, c1, c2, c3;
+
+        BezierSegment(glm::vec3 knot1, glm::vec3 handle1, glm::vec3 handle2, glm::vec3 knot2) :
+            c0 { knot1 },
+            c1 { 3.0f * (handle1 - knot1) },
+            c2 { 3.0f * (knot1 - 2.0f * handle1 + handle2) },
+            c3 { knot2 - knot1 + 3.0f * (handle1 - handle2) } {};
+
+        //! Evaluates the segment at parameter \c u in [0, 1] with Horner's scheme
+        glm::vec3 evaluate(float u) const { return c0 + u * (c1 + u * (c2 + u * c3)); }
+    };
+
+    static constexpr int arcLengthSamples = 64;     //!< Number of chords of the cumulative arc-length table of a segment
+
+    //! Samples one segment at every frame in [frameStart, frameEnd) into the preallocated \c sampledSegment
+    /*!
+    * The eased time of each frame is mapped to a fraction of the segment length, which is looked up in a cumulative arc-length table,
+    * so that the character moves along the curve at the speed described by the easing and not by the Beziér parametrisation.
+    */
+    static void                         adaptiveSegmentSampling(const BezierSegment& segment,
                                                                 float           easeFrom,   float       easeTo,
                                                                 glm::quat       quat1,      glm::quat   quat2,
                                                                 int             frameStart, int         frameEnd,
-                                                                ControlPoint*   prevCP = nullptr);
-    static std::vector<float>           adaptiveTimingsResampling(float easeFrom, float easeTo, int nSamples);
-    static glm::vec3                    sampleBezier(glm::vec3 knot1, glm::vec3 handle1, glm::vec3 handle2, glm::vec3 knot2, float t);
+                                                                ControlPoint*   sampledSegment);
+    //! Inverts the time easing curve at \c t with safeguarded Newton steps, starting from the previous solution \c s
+    static float                        easedTiming(float easeFrom, float easeTo, float t, float& s);
 
 public:
     ControlPathDecoderNode();
@@ -69,6 +69,11 @@ RPCTriggerNode::RPCTriggerNode(const NodeDelegateModelRegistry& modelRegistry)
         }
     }
     
+    _coalesceTimer = new QTimer(this);
+    _coalesceTimer->setSingleShot(true);
+    _coalesceTimer->setInterval(coalesceIntervalMs);
+    connect(_coalesceTimer, &QTimer::timeout, this, &RPCTriggerNode::onCoalescedRun);
+
     //qDebug() << "RPCTriggerNode created";
 }
 
@@ -117,7 +122,7 @@ void RPCTriggerNode::processInData(std::shared_ptr<NodeData> data, QtNodes::Port
  
     run();
 
-    qDebug() << "RPCTriggerNode setInData";
+    //qDebug() << "RPCTriggerNode setInData";
 }
 
 std::shared_ptr<NodeData> RPCTriggerNode::processOutData(QtNodes::PortIndex port)
@@ -166,49 +171,34 @@ void RPCTriggerNode::run()
                         if (_filterType <= AnimHostRPCType::BLOCK) {
                             qDebug() << "RPCData Received: " << rpc;
 
-                            // create QVaraintMap for filtertype and _rpcMappings
-                            QVariantMap parameter;
-                            parameter["sendingMode"] = QVariant::fromValue(_filterType);
-
-                            for (auto mapping : _rpcMappings) {
-                                parameter[mapping.targetProperty] = mapping.value;
-                            }
+                            // A pending coalesced run is superseded by this one
+                            _coalesceTimer->stop();
 
-                            emitRunNextNode(&parameter);
+                            _runParameters["sendingMode"] = QVariant::fromValue(_filterType);
+                            emitRunNextNode(&_runParameters);
                         }
                     }
 				}
-                else if (sp_rpc->sceneID == 255 && sp_rpc->objectID == 1) {
-                    // Check for possible mapping of RPC to other properties
-                    for (auto& mapping : _rpcMappings) {
-                        if (mapping.parameterID == sp_rpc->paramID) {
+                else if (sp_rpc->sceneID == mappingSceneID && sp_rpc->objectID == mappingObjectID) {
+                    // Look up the mappings of this parameter in the pre-resolved dispatch table
+                    auto entry = _dispatchTable.constFind(DispatchKey(sp_rpc->sceneID, sp_rpc->objectID, sp_rpc->paramID));
 
-                            auto data = sp_rpc->decodeRawData();
+                    if (entry != _dispatchTable.constEnd()) {
+                        bool triggerRun = false;
 
-                            if (sp_rpc->paramType == ZMQMessageHandler::INT) {
-                                auto intData = dynamic_cast<ParameterPayload<int>*>(data.get());
-                                mapping.value = intData->getValue();
-                            }
-                            else if (sp_rpc->paramType == ZMQMessageHandler::FLOAT) {
-                                auto floatData = dynamic_cast<ParameterPayload<float>*>(data.get());
-                                mapping.value = floatData->getValue();
-                            }
-                            else if (sp_rpc->paramType == ZMQMessageHandler::VECTOR3) {
-                                //auto vec3Data = dynamic_cast<ParameterPayload<glm::vec3>*>(data.get());
-                                qWarning() << "Vector 3 parmaeter override currently not supported";
-                            }
-                            else if (sp_rpc->paramType == ZMQMessageHandler::VECTOR4) {
-                                //auto vec4Data = dynamic_cast<ParameterPayload<glm::vec4>*>(data.get());
-                                qWarning() << "Vector 4 parmaeter override currently not supported";
-                            }
-                            else if (sp_rpc->paramType == ZMQMessageHandler::QUATERNION) {
-                                //auto quatData = dynamic_cast<ParameterPayload<glm::quat>*>(data.get());
-                                qWarning() << "Quaternion parmaeter override currently not supported";
-                            }
-                            else {
-                                qDebug() << "Unsupported parameter type in RPC!";
+                        for (int mappingIdx : entry.value()) {
+                            RPCMapping& mapping = _rpcMappings[mappingIdx];
+
+                            if (applyMappedUpdate(mapping, *sp_rpc)) {
+                                _runParameters[mapping.targetProperty] = mapping.value;
+                                triggerRun |= mapping.triggerRun;
                             }
                         }
+
+                        // Bursts of updates, e.g. slider drags, result in one run per interval with the latest values
+                        if (triggerRun && !_coalesceTimer->isActive()) {
+                            _coalesceTimer->start();
+                        }
                     }
                 }
 				else {
@@ -297,12 +287,79 @@ QWidget* RPCTriggerNode::embeddedWidget()
 	return _widget;
 }
 
+quint64 RPCTriggerNode::DispatchKey(uint8_t sceneID, uint16_t objectID, uint16_t paramID)
+{
+    return (quint64(sceneID) << 32) | (quint64(objectID) << 16) | quint64(paramID);
+}
+
+void RPCTriggerNode::rebuildDispatchTable()
+{
+    _dispatchTable.clear();
+    _runParameters.clear();
+
+    for (int i = 0; i < _rpcMappings.size(); i++) {
+        const RPCMapping& mapping = _rpcMappings[i];
+        _dispatchTable[DispatchKey(mappingSceneID, mappingObjectID, mapping.parameterID)].append(i);
+
+        if (!mapping.targetProperty.isEmpty()) {
+            _runParameters[mapping.targetProperty] = mapping.value;
+        }
+    }
+
+    _runParameters["sendingMode"] = QVariant::fromValue(_filterType);
+}
+
+bool RPCTriggerNode::applyMappedUpdate(RPCMapping& mapping, const RPCUpdate& rpc)
+{
+    switch (rpc.paramType) {
+    case ZMQMessageHandler::INT: {
+        int32_t value;
+        if (!rpc.decodeValue(value)) {
+            qWarning() << "Truncated INT parameter in RPC";
+            return false;
+        }
+        mapping.value = int(value);
+        return true;
+    }
+    case ZMQMessageHandler::FLOAT: {
+        float value;
+        if (!rpc.decodeValue(value)) {
+            qWarning() << "Truncated FLOAT parameter in RPC";
+            return false;
+        }
+        mapping.value = value;
+        return true;
+    }
+    case ZMQMessageHandler::VECTOR3:
+        qWarning() << "Vector 3 parmaeter override currently not supported";
+        return false;
+    case ZMQMessageHandler::VECTOR4:
+        qWarning() << "Vector 4 parmaeter override currently not supported";
+        return false;
+    case ZMQMessageHandler::QUATERNION:
+        qWarning() << "Quaternion parmaeter override currently not supported";
+        return false;
+    default:
+        qDebug() << "Unsupported parameter type in RPC!";
+        return false;
+    }
+}
+
+void RPCTriggerNode::onCoalescedRun()
+{
+    if (_filterType <= AnimHostRPCType::BLOCK) {
+        _runParameters["sendingMode"] = QVariant::fromValue(_filterType);
+        emitRunNextNode(&_runParameters);
+    }
+}
+
 void RPCTriggerNode::onElementAdded()
 {
 	qDebug() << "ListWidget Changed";
 
 
 	_rpcMappings.append({ 0, "", "", false });
+	rebuildDispatchTable();
 
 
 	Q_EMIT embeddedWidgetSizeUpdated();
@@ -313,6 +370,7 @@ void RPCTriggerNode::onElementRemoved(int index)
 	qDebug() << "ListWidget Changed";
 
 	_rpcMappings.removeAt(index);
+	rebuildDispatchTable();
 	
 }
 
@@ -328,6 +386,8 @@ void RPCTriggerNode::onElementMappingChanged(int elementIdx,int paramId, QString
 	_rpcMappings[elementIdx].targetNode = node;
 	_rpcMappings[elementIdx].targetProperty = property;
 	_rpcMappings[elementIdx].triggerRun = trigger;
+
+	rebuildDispatchTable();
 }
 
 void RPCTriggerNode::onButtonClicked()
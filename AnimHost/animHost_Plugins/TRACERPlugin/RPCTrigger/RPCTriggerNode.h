@@ -7,6 +7,8 @@
 #include <QObject>
 #include <QComboBox>
 #include <QVBoxLayout>
+#include <QHash>
+#include <QTimer>
 #include <pluginnodeinterface.h>
 #include <QtNodes/NodeDelegateModelRegistry>
 
@@ -53,6 +55,22 @@ private:
 	// Defined Mappings for RPC Trigger
 	QList<RPCMapping> _rpcMappings;
 
+	// RPC target of mapped parameters
+	static constexpr uint8_t mappingSceneID = 255;
+	static constexpr uint16_t mappingObjectID = 1;
+
+	// Interval in which mapped parameter updates are collected into a single run, one frame at 60 fps
+	static constexpr int coalesceIntervalMs = 16;
+
+	// Mapping indices per packed (sceneID, objectID, paramID), rebuilt whenever the mappings change
+	QHash<quint64, QList<int>> _dispatchTable;
+
+	// Run parameters passed downstream, updated in place when a mapped value changes
+	QVariantMap _runParameters;
+
+	// Single shot timer collecting mapped updates with triggerRun into one run per interval
+	QTimer* _coalesceTimer = nullptr;
+
 
 public:
     RPCTriggerNode(const NodeDelegateModelRegistry& modelRegistry);
@@ -80,7 +98,16 @@ public:
 
     QWidget* embeddedWidget() override;
 
+private:
+    static quint64 DispatchKey(uint8_t sceneID, uint16_t objectID, uint16_t paramID);
+
+    void rebuildDispatchTable();
+
+    bool applyMappedUpdate(RPCMapping& mapping, const RPCUpdate& rpc);
+
 private Q_SLOTS:
+    void onCoalescedRun();
+
     void onButtonClicked();
 
 	void onElementAdded();
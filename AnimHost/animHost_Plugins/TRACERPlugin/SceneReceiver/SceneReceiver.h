@@ -29,7 +29,9 @@
 //!
 /*!
  * ###This class is instanced by the [SceneReceiverNode](@ref SceneReceiverNode) and is run in a subthread.
- * The class requests all the relevant data from the TRACER client, to which the AnimHost Application will send the Update Messages
+ * The class requests all the relevant data from the TRACER client, to which the AnimHost Application will send the Update Messages.
+ * The header, character and scene node requests are issued together over a DEALER socket and every reply is passed on as an
+ * owned QByteArray as soon as it arrives, so the main thread can start parsing while the remaining parts are still in transit.
  */
 
 #ifndef TRACERSCENERECEIVER_H
@@ -38,8 +40,11 @@
 #include "ZMQMessageHandler.h"
 #include "SceneReceiverNode.h"
 
+#include <QList>
 #include <QMutex>
 #include <QThread>
+
+#include <cstring>
 //#include <nzmqt/nzmqt.hpp>
 
 class TRACERPLUGINSHARED_EXPORT SceneReceiver : public ZMQMessageHandler {
@@ -66,7 +71,7 @@ class TRACERPLUGINSHARED_EXPORT SceneReceiver : public ZMQMessageHandler {
         _working = false;
         _paused = false;
 
-        receiveSocket = new zmq::socket_t(*context, zmq::socket_type::req); // initialising the socket with a Request-Reply pattern
+        createSocket(); // initialising a DEALER socket, so that requests can be pipelined
 
         // THIS TRIGGERS NULLPOINTER-RELATED EXCEPTION
         // open socket
@@ -89,7 +94,7 @@ class TRACERPLUGINSHARED_EXPORT SceneReceiver : public ZMQMessageHandler {
         _working = false;
         _paused = false;
 
-        receiveSocket = new zmq::socket_t(*context, zmq::socket_type::req);
+        createSocket();
 
         // THIS TRIGGERS NULLPOINTER-RELATED EXCEPTION
         // open socket
@@ -100,7 +105,10 @@ class TRACERPLUGINSHARED_EXPORT SceneReceiver : public ZMQMessageHandler {
 
     //! Default constructor
     ~SceneReceiver() {
-        receiveSocket->close();
+        if (receiveSocket) {
+            receiveSocket->close();
+            delete receiveSocket;
+        }
     };
 
     //! Request this process to start working
@@ -131,95 +139,159 @@ class TRACERPLUGINSHARED_EXPORT SceneReceiver : public ZMQMessageHandler {
         mutex.unlock();
     };
 
-    //! Requesting the Character Package list in the TRACER client scene
+    //! Requests header, character and scene node data from the TRACER client in one round trip
     /*!
-    * Uses a Request-Receive pattern to get the TRACER CharacterPackage data, converts message into explicit byte array and
-    * passes byte array to SceneReceiverNode to be parsed and saved in an AnimHost CharacterObjectSequence data structure
+    * The three requests are pipelined on the DEALER socket without waiting for each other. The TRACER client answers them in order,
+    * so every reply is matched against the oldest outstanding request and handed to SceneReceiverNode as soon as it lands.
+    * Scene node data is only passed on after the character data, because resolving the skinned meshes requires the parsed characters.
+    * If no reply arrives within \c replyTimeoutMs the socket is recreated and the still missing requests are sent again,
+    * up to \c maxRetries times; after that \c sceneRequestTimedOut() is emitted.
     */
-    void requestCharacterData() {
-        std::string charReq = "characters";
-        requestMsg.rebuild(charReq.c_str(), charReq.size());
-        //qDebug() << "Requesting character packages";
-        receiveSocket->send(requestMsg);
-
-        receiveSocket->recv(&replyCharMsg);
-        qDebug() << "TRACER character package receive!";
-
-        QByteArray* charPkgArray = new QByteArray();
-        // replyCharMsg will contain a series of bytes representing the Characters in the scene
-        if (replyCharMsg.size() > 0)
-            charPkgArray->append((char*)replyCharMsg.data(), replyCharMsg.size()); // Convert message into explicit byte array
+    void requestSceneData() {
+        QList<ScenePart> pending = { ScenePart::Header, ScenePart::Characters, ScenePart::Nodes };
+        QByteArray heldNodes;           // Nodes reply that arrived before the characters have been delivered
+        bool nodesHeld = false;
+        bool charactersDelivered = false;
+
+        for (int attempt = 0; attempt <= maxRetries && !pending.isEmpty(); attempt++) {
+            if (attempt > 0) {
+                qWarning() << "TRACER scene request timed out, retrying" << attempt << "of" << maxRetries;
+                resetSocket();
+            }
+
+            // Send all missing requests at once, the replies come back in the same order
+            QList<ScenePart> inFlight = pending;
+            for (ScenePart part : inFlight)
+                sendRequest(part);
+
+            while (!inFlight.isEmpty()) {
+                zmq::pollitem_t item = { static_cast<void*>(*receiveSocket), 0, ZMQ_POLLIN, 0 };
+                if (zmq::poll(&item, 1, replyTimeoutMs) <= 0)
+                    break;
+
+                QByteArray payload;
+                if (!receiveReply(payload))
+                    continue;
+
+                ScenePart part = inFlight.takeFirst();
+                pending.removeOne(part);
+
+                switch (part) {
+                    case ScenePart::Header:
+                        qDebug() << "TRACER scene header received!";
+                        passHeaderByteArray(std::move(payload)); // Pass byte array to SceneReceiverNode to be parsed as header data
+                        break;
+                    case ScenePart::Characters:
+                        qDebug() << "TRACER character package receive!";
+                        passCharacterByteArray(std::move(payload)); // Pass byte array to SceneReceiverNode to be parsed as chracter packages
+                        charactersDelivered = true;
+                        if (nodesHeld)
+                            passSceneNodeByteArray(std::move(heldNodes));
+                        break;
+                    case ScenePart::Nodes:
+                        qDebug() << "TRACER scene nodes received!";
+                        if (charactersDelivered) {
+                            passSceneNodeByteArray(std::move(payload)); // Pass byte array to SceneReceiverNode to be parsed as scene nodes
+                        } else {
+                            heldNodes = std::move(payload);
+                            nodesHeld = true;
+                        }
+                        break;
+                }
+            }
+        }
 
-        passCharacterByteArray(charPkgArray); // Pass byte array to SceneReceiverNode to be parsed as chracter packages
+        if (!pending.isEmpty()) {
+            qWarning() << "TRACER scene request to" << senderIP << "failed after" << maxRetries << "retries";
+            sceneRequestTimedOut();
+        }
     }
 
-    //! Requesting the SceneNode list in the TRACER client scene
+    //! Opens a DEALER communication socket
     /*!
-    * Uses a Request-Receive pattern to get the TRACER SceneNode data, converts message into explicit byte array and
-    * passes it to the SceneReceiverNode to be parsed and saved in an AnimHost SceneNodeObjectSequence data structure
+    * Does nothing if the socket is already connected to the address. A DEALER socket with several connections to the same
+    * endpoint spreads the pipelined requests round robin across them, so a changed address gets a fresh socket instead of
+    * an additional connection.
+    * \param[in]    newIPAddress    The (optional) new IP Address, empty string by default. If not empty the new address replaces the previous one
     */
-    void requestSceneNodeData() {
-        std::string nodesReq = "nodes";
-        requestMsg.rebuild(nodesReq.c_str(), nodesReq.size());
-        //qDebug() << "Requesting nodes";
-        receiveSocket->send(requestMsg);
+    void connectSocket(QString newIPAddress = "") {
+        if(!newIPAddress.isEmpty())
+            senderIP = newIPAddress;
 
-        receiveSocket->recv(&replyNodeMsg);
-        qDebug() << "TRACER scene nodes received!";
+        if (connectedIP == senderIP)
+            return;
 
-        QByteArray* nodesArray = new QByteArray();
-        // replyNodeMsg will contain a series of bytes representing all the Scene Nodes in the scene
-        if (replyNodeMsg.size() > 0)
-            nodesArray->append((char*) replyNodeMsg.data(), replyNodeMsg.size());
+        if (!connectedIP.isEmpty()) {
+            receiveSocket->close();
+            delete receiveSocket;
+            createSocket();
+        }
 
-        passSceneNodeByteArray(nodesArray); // Pass byte array to SceneReceiverNode to be parsed as scene nodes
+        receiveSocket->connect(QString("tcp://" + senderIP + ":5555").toLatin1().data());
+        connectedIP = senderIP;
     }
 
-    //! Requesting the header data containing global information of the TRACER client
-    /*!
-    * Uses a Request-Receive pattern to get the TRACER SceneNode data, converts message into explicit byte array and
-    * passes it to the SceneReceiverNode to be parsed and saved in an AnimHost SceneNodeObjectSequence data structure
-    */
-    void requestHeaderData() {
-        std::string headReq = "header";
-        requestMsg.rebuild(headReq.c_str(), headReq.size());
-        //qDebug() << "Requesting nodes";
-        receiveSocket->send(requestMsg);
+    private:
+    //! The parts of the scene that are requested from the TRACER client
+    enum class ScenePart { Header, Characters, Nodes };
+
+    static constexpr int replyTimeoutMs = 2000; //!< Time in milliseconds to wait for the next reply before retrying
+    static constexpr int maxRetries = 2;        //!< Number of times the missing requests are sent again on a fresh socket
+
+    zmq::socket_t* receiveSocket = nullptr; //!< Pointer to the instance of the socket that will receive the messages. It's going to be initialised in the constructor as a DEALER socket.
+    QString senderIP;                       //!< The IP address, on which the connection is going to be established
+    QString connectedIP;                    //!< The IP address the current socket is connected to, empty while unconnected
 
-        receiveSocket->recv(&replyHeaderMsg);
-        qDebug() << "TRACER scene header received!";
+    SceneReceiverNode* TSRPlugin = nullptr; //!< Pointer to the instance of SceneReceiverNode that owns this SceneReceiver
+    zmq::message_t requestMsg {};                   //!< 0MQ message that will contain the request message to be sent out to DataHub or the TRACER client
+    zmq::message_t replyMsg {};                     //!< 0MQ message that will be filled with the frames of the current reply
 
-        QByteArray* headerArray = new QByteArray();
-        // replyHeaderMsg will contain a series of bytes encoding basic global data of the scene and its client/server
-        if (replyHeaderMsg.size() > 0)
-            headerArray->append((char*) replyHeaderMsg.data(), replyHeaderMsg.size());
+    //! Creates the DEALER socket. Linger is disabled so that unanswered requests are dropped when the socket is closed
+    void createSocket() {
+        receiveSocket = new zmq::socket_t(*context, zmq::socket_type::dealer);
+        receiveSocket->setsockopt(ZMQ_LINGER, 0);
+    }
 
-        passHeaderByteArray(headerArray); // Pass byte array to SceneReceiverNode to be parsed as header data
+    //! Closes the current socket and connects a new one, discarding replies to requests sent on the old connection
+    void resetSocket() {
+        receiveSocket->close();
+        delete receiveSocket;
+        createSocket();
+        connectedIP.clear();
+        connectSocket();
     }
 
-    //! Opens a Request-Receive communication socket
-    /*!
-    * \param[in]    newIPAddress    The (optional) new IP Address, empty string by default. If not empty the new address replaces the previous one
-    */
-    void connectSocket(QString newIPAddress = "") {
-        //! (Re-)connect to newIPAddress
-        /*if (receiveSocket->connected())
-            receiveSocket->disconnect(QString("tcp://" + ipAddress + ":5555").toLatin1().data()); //disconnect throws unexpected exception*/
-        if(!newIPAddress.isEmpty())
-            senderIP = newIPAddress;
+    //! Sends the request for \c part, preceded by the empty delimiter frame the TRACER REP socket expects
+    void sendRequest(ScenePart part) {
+        static const char* requestNames[] = { "header", "characters", "nodes" };
+        const char* request = requestNames[static_cast<int>(part)];
 
-        receiveSocket->connect(QString("tcp://" + senderIP + ":5555").toLatin1().data());
+        zmq::message_t delimiter;
+        receiveSocket->send(delimiter, ZMQ_SNDMORE);
+        requestMsg.rebuild(request, strlen(request));
+        receiveSocket->send(requestMsg);
     }
 
-    private:
-    zmq::socket_t* receiveSocket = nullptr; //!< Pointer to the instance of the socket that will receive the messages. It's going to be initialised in the constructor as a Request-Receive socket.
-    QString senderIP;                       //!< The IP address, on which the connection is going to be established
+    //! Receives one reply, skipping the empty delimiter frame and collecting the payload into \c payload
+    /*!
+    * \returns false if the reply didn't carry the delimiter frame and has to be ignored
+    */
+    bool receiveReply(QByteArray& payload) {
+        if (!receiveSocket->recv(&replyMsg) || replyMsg.size() != 0 || !replyMsg.more()) {
+            while (replyMsg.more())
+                receiveSocket->recv(&replyMsg);
+            qWarning() << "Malformed TRACER scene reply, ignoring it";
+            return false;
+        }
 
-    SceneReceiverNode* TSRPlugin = nullptr; //!< Pointer to the instance of SceneReceiverNode that owns this SceneReceiver
-    zmq::message_t requestMsg {};                   //!< 0MQ message that will contain the request message to be sent out to DataHub or the TRACER client
-    zmq::message_t replyNodeMsg {};                 //!< 0MQ message that will be filled with the scene description data
-    zmq::message_t replyHeaderMsg {};               //!< 0MQ message that will be filled with the header data
-    zmq::message_t replyCharMsg {};                 //!< 0MQ message that will be filled with the character list data
+        do {
+            receiveSocket->recv(&replyMsg);
+            // The reply contains a series of bytes representing the requested part of the scene
+            if (replyMsg.size() > 0)
+                payload.append(static_cast<const char*>(replyMsg.data()), replyMsg.size()); // Convert message into explicit byte array
+        } while (replyMsg.more());
+        return true;
+    }
 
     public Q_SLOTS:
     //! Main loop. It doesn't do anything, since the class operations are supposed to be triggered directly from the UI of the Qt Application
@@ -227,8 +299,9 @@ class TRACERPLUGINSHARED_EXPORT SceneReceiver : public ZMQMessageHandler {
 
     Q_SIGNALS:
     void stopped();                                             //!< Signal emitted when process is finished
-    void passCharacterByteArray(QByteArray* characterMsgArray); //!< Signal emitted to pass the character byte sequence onto the main thread
-    void passSceneNodeByteArray(QByteArray* sceneNodeMsgArray); //!< Signal emitted to pass the scene node byte sequence onto the main thread
-    void passHeaderByteArray(QByteArray* headerMsgArray);       //!< Signal emitted to pass the header byte sequence onto the main thread
+    void passCharacterByteArray(QByteArray characterMsgArray);  //!< Signal emitted to pass the character byte sequence onto the main thread
+    void passSceneNodeByteArray(QByteArray sceneNodeMsgArray);  //!< Signal emitted to pass the scene node byte sequence onto the main thread
+    void passHeaderByteArray(QByteArray headerMsgArray);        //!< Signal emitted to pass the header byte sequence onto the main thread
+    void sceneRequestTimedOut();                                //!< Signal emitted when the TRACER client didn't answer all requests in time
 };
 #endif // SCENERECEIVER_H
\ No newline at end of file
@@ -21,9 +21,18 @@
 
 #include "SceneReceiverNode.h"
 #include "SceneReceiver.h"
+#include "../TRACERUpdateReceiver.h"
 #include "animhosthelper.h"
+#include "../ByteCursor.h"
 
-SceneReceiverNode::SceneReceiverNode(std::shared_ptr<zmq::context_t> zmqConext) {
+#include <algorithm>
+
+// The packages are read into these types with plain copies
+static_assert(sizeof(glm::vec3) == 3 * sizeof(float), "glm::vec3 must be tightly packed");
+static_assert(sizeof(glm::mat4) == 16 * sizeof(float), "glm::mat4 must be tightly packed");
+static_assert(sizeof(int) == sizeof(int32_t), "int32 arrays are copied into std::vector<int>");
+
+SceneReceiverNode::SceneReceiverNode(std::shared_ptr<zmq::context_t> zmqConext, std::shared_ptr<TRACERUpdateReceiver> updateReceiver) : _updateReceiver(updateReceiver) {
 	_requestButton = nullptr;
 	_widget = nullptr;
 	_connectIPAddress = nullptr;
@@ -43,9 +52,16 @@ SceneReceiverNode::SceneReceiverNode(std::shared_ptr<zmq::context_t> zmqConext)
 	QObject::connect(sceneReceiver, &SceneReceiver::passCharacterByteArray, this, &SceneReceiverNode::processCharacterByteData);
 	QObject::connect(sceneReceiver, &SceneReceiver::passSceneNodeByteArray, this, &SceneReceiverNode::processSceneNodeByteData);
 	QObject::connect(sceneReceiver, &SceneReceiver::passHeaderByteArray, this, &SceneReceiverNode::processHeaderByteData);
-	QObject::connect(this, &SceneReceiverNode::requestCharacterData, sceneReceiver, &SceneReceiver::requestCharacterData);
-	QObject::connect(this, &SceneReceiverNode::requestSceneNodeData, sceneReceiver, &SceneReceiver::requestSceneNodeData);
-	QObject::connect(this, &SceneReceiverNode::requestHeaderData, sceneReceiver, &SceneReceiver::requestHeaderData);
+	QObject::connect(sceneReceiver, &SceneReceiver::sceneRequestTimedOut, this, &SceneReceiverNode::onSceneRequestTimedOut);
+	QObject::connect(this, &SceneReceiverNode::requestSceneData, sceneReceiver, &SceneReceiver::requestSceneData);
+
+	_deltaTimer = new QTimer(this);
+	_deltaTimer->setSingleShot(true);
+	_deltaTimer->setInterval(deltaIntervalMs);
+	QObject::connect(_deltaTimer, &QTimer::timeout, this, &SceneReceiverNode::flushSceneChanges);
+
+	if (_updateReceiver)
+		QObject::connect(_updateReceiver.get(), &TRACERUpdateReceiver::parameterUpdateMessage, this, &SceneReceiverNode::applyParameterUpdate, Qt::QueuedConnection);
 
 }
 
@@ -170,13 +186,11 @@ void SceneReceiverNode::onButtonClicked()
 	// Set IP Address
 	_ipAddress = _connectIPAddress->text();
 
-	// TODO: Reconnecting the socket requires a correct shut-down process before creating a new connection. To be refactored.
+	// Connects on first use and after the address changed, the existing connection is kept otherwise
 	sceneReceiver->connectSocket(_ipAddress); // DO NOT COMMENT THIS LINE
 
-	// Send signal to SceneReceiver to request characters
-	requestHeaderData();
-	requestCharacterData();
-	// requestSceneNodeData() is then called after processCharacterData() is done (i.e. at thew end of its body)
+	// Send signal to SceneReceiver to request header, characters and scene nodes at once
+	requestSceneData();
 
 	//qDebug() << "Attempting RECEIVE connection to" << _ipAddress;
 }
@@ -193,11 +207,10 @@ void SceneReceiverNode::run() {
 	// Set IP Address
 	_ipAddress = _connectIPAddress->text();
 
-	// TODO: Reconnecting the socket requires a correct shut-down process before creating a new connection. To be refactored.
+	// Connects on first use and after the address changed, the existing connection is kept otherwise
 	sceneReceiver->connectSocket(_ipAddress); // DO NOT COMMENT THIS LINE
 
-	requestHeaderData();
-	requestCharacterData();
+	requestSceneData();
 
 }
 
@@ -205,86 +218,70 @@ void SceneReceiverNode::run() {
  * Gets a QByteArray representing the list of characters in the scene from the SceneReceiver thread.
  * Parses the bytes populating a CharacterObjectSequence
  */
-void SceneReceiverNode::processCharacterByteData(QByteArray* characterByteArray) {
-	int charByteCounter = 0; //! "Bookmark" for reading the character byte array and skipping uninteresting sequences of bytes
+void SceneReceiverNode::processCharacterByteData(const QByteArray& characterByteArray) {
+	ByteCursor cursor(characterByteArray); //! Bounds checked "bookmark" for reading the character byte array
+
+	// The cached scene state points into the lists that are about to be replaced
+	_sceneState.clear();
+	_pendingChanges = SceneStateCache::NONE;
+	_pendingCharacterIDs.clear();
+	_pendingSceneNodeIDs.clear();
+	_deltaTimer->stop();
 
 	// Clear current list of CharacterPackages
-	characterListOut.get()->getData()->mCharacterObjectSequence.clear();
+	auto& characters = characterListOut->getData()->mCharacterObjectSequence;
+	characters.clear();
+	characterListOut->getData()->changedObjectIDs.clear();
+
 	// Execute until all the QByteArray has been read
-	while (characterByteArray->size() > charByteCounter) {
+	while (!cursor.atEnd()) {
 		// Parsing and populating data for a single CharacterPackage
 		CharacterObject character;
 
-		// Get number of bones (not to be saved in CharacterPackage) - int32
-		int32_t nBones; memcpy(&nBones, characterByteArray->sliced(charByteCounter, 4).data(), sizeof(nBones)); // Copies byte values directly into the new variable, which interprets it as the correct type
-		charByteCounter += sizeof(nBones);
-		// Get number of skeleton objects (not to be saved in CharacterPackage) - int32
-		int32_t nSkeletonObjs; memcpy(&nSkeletonObjs, characterByteArray->sliced(charByteCounter, 4), sizeof(nSkeletonObjs));
-		charByteCounter += sizeof(nSkeletonObjs);
+		// Get number of bones and number of skeleton objects (not to be saved in CharacterPackage) - int32
+		int32_t nBones = 0;
+		int32_t nSkeletonObjs = 0;
+		cursor.read(nBones);
+		cursor.read(nSkeletonObjs);
 
 		// Get ID of the root bone - int32
-		memcpy(&character.characterRootID, characterByteArray->sliced(charByteCounter, 4), sizeof(character.characterRootID));
-		charByteCounter += sizeof(character.characterRootID);
-
-		// Populating bone mapping (which Unity HumanBone object corresponds to which element of the skeleton obj vector) - int32[]
-		for (int i = 0; i < nBones; i++) {
-			int32_t id; memcpy(&id, characterByteArray->sliced(charByteCounter, 4), sizeof(id));
-			charByteCounter += sizeof(id);
-			character.boneMapping.push_back(id);
-		}
+		cursor.read(character.characterRootID);
 
-		// Populating skeleton object IDs (ParameterIDs of the actual bones as seen by Unity) - int32[]
-		for (int i = 0; i < nSkeletonObjs; i++) {
-			int32_t id; memcpy(&id, characterByteArray->sliced(charByteCounter, 4), sizeof(id));
-			charByteCounter += sizeof(id);
-			character.skeletonObjIDs.push_back(id);
-		}
+		// Bone mapping (which Unity HumanBone object corresponds to which element of the skeleton obj vector) - int32[]
+		cursor.readArray(character.boneMapping, nBones);
 
-		// Populating T-Pose bone Positions - float[] - size in bytes 4*3*N_bones
-		for (int i = 0; i < nSkeletonObjs; i++) {
-			float x; memcpy(&x, characterByteArray->sliced(charByteCounter, 4), sizeof(x));
-			charByteCounter += sizeof(x);
-			float y; memcpy(&y, characterByteArray->sliced(charByteCounter, 4), sizeof(y));
-			charByteCounter += sizeof(y);
-			float z; memcpy(&z, characterByteArray->sliced(charByteCounter, 4), sizeof(z));
-			charByteCounter += sizeof(z);
-			character.tposeBonePos.push_back(glm::vec3(x, y, z));
-		}
+		// Skeleton object IDs (ParameterIDs of the actual bones as seen by Unity) - int32[]
+		cursor.readArray(character.skeletonObjIDs, nSkeletonObjs);
+
+		// T-Pose bone Positions - float[] - size in bytes 4*3*N_bones
+		cursor.readArray(character.tposeBonePos, nSkeletonObjs);
 
-		// Populating T-Pose bone Rotation - float[] - size in bytes 4*4*N_bones
-		for (int i = 0; i < nSkeletonObjs; i++) {
-			float x; memcpy(&x, characterByteArray->sliced(charByteCounter, 4), sizeof(x));
-			charByteCounter += sizeof(x);
-			float y; memcpy(&y, characterByteArray->sliced(charByteCounter, 4), sizeof(y));
-			charByteCounter += sizeof(y);
-			float z; memcpy(&z, characterByteArray->sliced(charByteCounter, 4), sizeof(z));
-			charByteCounter += sizeof(z);
-			float w; memcpy(&w, characterByteArray->sliced(charByteCounter, 4), sizeof(w));
-			charByteCounter += sizeof(w);
-			character.tposeBoneRot.push_back(glm::quat(w, x, y, z));
+		// T-Pose bone Rotation - float[] - size in bytes 4*4*N_bones, sent as x, y, z, w
+		if (const char* rotations = cursor.take(qsizetype(nSkeletonObjs) * 4 * sizeof(float))) {
+			character.tposeBoneRot.resize(nSkeletonObjs);
+			for (int i = 0; i < nSkeletonObjs; i++) {
+				float xyzw[4]; memcpy(xyzw, rotations + i * sizeof(xyzw), sizeof(xyzw));
+				character.tposeBoneRot[i] = glm::quat(xyzw[3], xyzw[0], xyzw[1], xyzw[2]);
+			}
 		}
 
-		// Populating T-Pose bone Scale - float[] - size in bytes 4*3*N_bones
-		for (int i = 0; i < nSkeletonObjs; i++) {
-			float x; memcpy(&x, characterByteArray->sliced(charByteCounter, 4), sizeof(x));
-			charByteCounter += sizeof(x);
-			float y; memcpy(&y, characterByteArray->sliced(charByteCounter, 4), sizeof(y));
-			charByteCounter += sizeof(y);
-			float z; memcpy(&z, characterByteArray->sliced(charByteCounter, 4), sizeof(z));
-			charByteCounter += sizeof(z);
-			character.tposeBoneScale.push_back(glm::vec3(x, y, z));
+		// T-Pose bone Scale - float[] - size in bytes 4*3*N_bones
+		cursor.readArray(character.tposeBoneScale, nSkeletonObjs);
+
+		if (!cursor.ok()) {
+			qWarning() << "Truncated character package received from TRACER at byte" << cursor.position() << ", ignoring the remaining data";
+			break;
 		}
 
 		// Adding character to the characterList
-		characterListOut->getData()->mCharacterObjectSequence.push_back(character);
+		characters.push_back(std::move(character));
 	}
 	//qDebug() << "Number of character received from VPET:" << characterListOut.get()->getData()->mCharacterObjectSequence.size();
 
 	// Do not emit Update because not ALL of the data has been processed
 	//emitDataUpdate(0);
 
-	// Requesting the complete Scenegraph in order to "fill in the blanks" of the CharacterObject
-	requestSceneNodeData();
+	// The complete Scenegraph, which "fills in the blanks" of the CharacterObject, is passed on by SceneReceiver right after this
 
 	_characterReady = true;
 	checkDataReady();
@@ -294,61 +291,81 @@ void SceneReceiverNode::processCharacterByteData(QByteArray* characterByteArray)
 * Gets a QByteArray from the SceneReceiver thread.
 * Parses the bytes populating a SceneNodeSequence
 */
-void SceneReceiverNode::processSceneNodeByteData(QByteArray* sceneNodeByteArray) {
-	int nodeByteCounter = 0;  // "Bookmark" for reading the scene node byte array and skipping uninteresting sequences of bytes
+void SceneReceiverNode::processSceneNodeByteData(const QByteArray& sceneNodeByteArray) {
+	ByteCursor cursor(sceneNodeByteArray); // Bounds checked "bookmark" for reading the scene node byte array
 	int sceneNodeCounter = 0; // Counting the sceneNodes in order to calculate the objectID
 	int editableSceneNodeCounter = 0; // Counting the sceneNodes that are editable in order to retrieve the sceneObjectID used for the ParameterUpdateMessage
 	int characterCounter = 0;
 
+	constexpr int baseNodeSize = 4 + 112; // node type + base fields, the minimum size of every node
+	constexpr int maxSkinnedBones = 99;   // fixed size of the bind pose and bone map blocks of skinned meshes
 
-	sceneNodeListOut->getData()->mSceneNodeObjectSequence.clear();
-	CharacterObject* currentChar = new CharacterObject();
+	auto& characters = characterListOut->getData()->mCharacterObjectSequence;
+	auto& sceneNodes = sceneNodeListOut->getData()->mSceneNodeObjectSequence;
+	sceneNodes.clear();
+	sceneNodeListOut->getData()->changedObjectIDs.clear();
+	sceneNodes.reserve(sceneNodeByteArray.size() / baseNodeSize);
 
-	while (sceneNodeByteArray->size() > nodeByteCounter) {
-		int32_t sceneNodeType; memcpy(&sceneNodeType, sceneNodeByteArray->sliced(nodeByteCounter, sizeof(sceneNodeType)).data(), sizeof(sceneNodeType)); // Copies byte values directly into the new variable, which interprets it as the correct type
-		nodeByteCounter += sizeof(sceneNodeType);
+	// Skinned meshes preceding any known character are attached to this placeholder
+	CharacterObject placeholderChar;
+	CharacterObject* currentChar = &placeholderChar;
+
+	while (!cursor.atEnd()) {
+		int32_t sceneNodeType = -1;
+		cursor.read(sceneNodeType);
 
 		// Parsing base fields (shared between all nodes)
 		// Components: 1*bool + 1*int + 3*float + 3*float + 4*float + 64*byte
 		// Size:            4 +     4 +      12 +      12 +      16 +      64 = 112
 		// Fields
-		// - bool editable
-		bool editableFlag; memcpy(&editableFlag, sceneNodeByteArray->sliced(nodeByteCounter, sizeof(editableFlag)).data(), sizeof(editableFlag)); // Copies byte values directly into the new variable, which interprets it as the correct type
-		nodeByteCounter += 4;
+		// - bool editable (first byte of a 4 byte field)
+		const char* editableField = cursor.take(4);
+		bool editableFlag = editableField && editableField[0] != 0;
 		editableSceneNodeCounter += editableFlag; // Incrementing activeSceneNodeCounter if editableFlag = TRUE
-		// - int  childCount
-		//int32_t childCount; memcpy(&childCount, sceneNodeByteArray->sliced(nodeByteCounter, sizeof(childCount)).data(), sizeof(childCount)); // Copies byte values directly into the new variable, which interprets it as the correct type
-		nodeByteCounter += 4;
+		// - int  childCount (skipped)
+		cursor.skip(4);
 		// - vec3 position
-		glm::vec3 objPos; memcpy(&objPos, sceneNodeByteArray->sliced(nodeByteCounter, sizeof(objPos)).data(), sizeof(objPos));
-		nodeByteCounter += sizeof(objPos);
+		glm::vec3 objPos(0.0f);
+		cursor.read(objPos);
 		// - vec3 scale
-		glm::vec3 objScale; memcpy(&objScale, sceneNodeByteArray->sliced(nodeByteCounter, sizeof(objPos)).data(), sizeof(objScale));
-		nodeByteCounter += sizeof(objScale);
+		glm::vec3 objScale(0.0f);
+		cursor.read(objScale);
 		// - vec4 rotation
-		glm::vec4 objRot; memcpy(&objRot, sceneNodeByteArray->sliced(nodeByteCounter, sizeof(objPos)).data(), sizeof(objRot));
-		nodeByteCounter += sizeof(objRot);
-		// - char[] (fixed 64 char length)
-		QString nodeName = QString(sceneNodeByteArray->sliced(nodeByteCounter, 64)); // Save name of the scene object (string)
-		nodeName.remove(QChar('\0'));
-		nodeByteCounter += 64;
-		nodeName.shrink_to_fit();
+		glm::vec4 objRot(0.0f);
+		cursor.read(objRot);
+		// - char[] (fixed 64 char length, zero padded)
+		const char* nameField = cursor.take(64);
+
+		if (!cursor.ok()) {
+			qWarning() << "Truncated scene node package received from TRACER at byte" << cursor.position() << ", ignoring the remaining data";
+			break;
+		}
+
+		std::string nodeName(nameField, qstrnlen(nameField, 64));
 
 		SceneNodeObject sceneNode;
+		sceneNode.objectName = nodeName;
+		sceneNode.pos = objPos;
+		sceneNode.rot = objRot;
+		sceneNode.scl = objScale;
+
+		// Non-character nodes get a sceneObjectID only if editable, -1 otherwise (non-editable)
+		// characterRootID should/could be changed so that a descendent bone can have a "reference" to the character root
+		sceneNode.sceneObjectID = (editableFlag ? editableSceneNodeCounter : -1);
+		sceneNode.characterRootID = -1;
+
 		SkinnedMeshComponent skinnedMesh;
-		int i = 0;
 		switch (sceneNodeType) {
 		case CHARACTER:
 			// if the current character has the same ID as the characterRootID of the currently selected character in the characterListOut
 			// ...and the characterCounter is smaller than the size of the list of characters (to avoid OutOfBounds error)
 			// fill its sceneObjectID and objectName fields
-			if (characterCounter < characterListOut->getData()->mCharacterObjectSequence.size() &&
-				sceneNodeCounter == characterListOut->getData()->mCharacterObjectSequence.at(characterCounter).characterRootID) {
-				currentChar = &characterListOut->getData()->mCharacterObjectSequence.at(characterCounter);
+			if (characterCounter < characters.size() &&
+				sceneNodeCounter == characters.at(characterCounter).characterRootID) {
+				currentChar = &characters.at(characterCounter);
 
 				currentChar->sceneObjectID = editableSceneNodeCounter;
-				currentChar->characterRootID = characterListOut->getData()->mCharacterObjectSequence.at(characterCounter).characterRootID;
-				currentChar->objectName = nodeName.toStdString();
+				currentChar->objectName = nodeName;
 
 				currentChar->pos = objPos;
 				currentChar->rot = objRot;
@@ -358,10 +375,10 @@ void SceneReceiverNode::processSceneNodeByteData(QByteArray* sceneNodeByteArray)
 			}
 
 			// Adding the characterObject also to the list of all the scene nodes in the scene to retain the same structure wrt the original scene
-			sceneNodeListOut->getData()->mSceneNodeObjectSequence.push_back(*currentChar);
+			sceneNodes.push_back(*currentChar);
 
 			break;
-		case SKINNEDMESH:
+		case SKINNEDMESH: {
 			// Read the data encapsulated in the SceneNodeSkinnedGeo and save it in a SkinnedMeshRenderer object
 
 			skinnedMesh.id = sceneNodeCounter;
@@ -371,61 +388,47 @@ void SceneReceiverNode::processSceneNodeByteData(QByteArray* sceneNodeByteArray)
 			// Size:             24 +   4 +   4 +      12 +      12 +        6336 +    396 = 6900
 
 			// Skip GEO fields (24 bytes)
-			nodeByteCounter += 24;
-			// Save bindPoseLength (int) for later
-			int32_t bindPoseLength; memcpy(&bindPoseLength, sceneNodeByteArray->sliced(nodeByteCounter, sizeof(bindPoseLength)).data(), sizeof(bindPoseLength)); // Copies byte values directly into the new variable, which interprets it as the correct type
-			nodeByteCounter += sizeof(bindPoseLength);
-			// Save skeletonRootID (int) for later
-			int32_t skeletonRootID; memcpy(&skeletonRootID, sceneNodeByteArray->sliced(nodeByteCounter, sizeof(skeletonRootID)).data(), sizeof(skeletonRootID)); // Copies byte values directly into the new variable, which interprets it as the correct type
-			nodeByteCounter += sizeof(skeletonRootID);
-			// Save bounding box dimensions (3 floats)
-			glm::vec3 boundExtents; memcpy(&boundExtents, sceneNodeByteArray->sliced(nodeByteCounter, sizeof(boundExtents)).data(), sizeof(boundExtents));
-			nodeByteCounter += sizeof(boundExtents);
-			skinnedMesh.boundExtents = boundExtents;
-			// Save bounding box center (3 floats)
-			glm::vec3 boundCenter; memcpy(&boundCenter, sceneNodeByteArray->sliced(nodeByteCounter, sizeof(boundCenter)).data(), sizeof(boundCenter));
-			nodeByteCounter += sizeof(boundCenter);
-			skinnedMesh.boundCenter = boundCenter;
-
-			// Save bind poses (bindPoseLength * 16) but 99*16 floats have to be skipped in the end anyway
-			while (i < 99 && i < bindPoseLength) { // i starts from 0, initialized at line 261
-				glm::mat4 bindPose; memcpy(&bindPose, sceneNodeByteArray->sliced(nodeByteCounter, sizeof(bindPose)).data(), sizeof(bindPose)); // Copies byte values directly into the new variable, which interprets it as the correct type
-				skinnedMesh.bindPoses.push_back(bindPose);
-				nodeByteCounter += sizeof(bindPose); i++;
+			cursor.skip(24);
+			int32_t bindPoseLength = 0;
+			cursor.read(bindPoseLength);
+			int32_t skeletonRootID = -1;
+			cursor.read(skeletonRootID);
+			// Bounding box dimensions and center (3 floats each)
+			cursor.read(skinnedMesh.boundExtents);
+			cursor.read(skinnedMesh.boundCenter);
+
+			// Bind poses are stored in a fixed block of 99 matrices, the first bindPoseLength are valid
+			const int bindPoseCount = std::clamp(bindPoseLength, 0, maxSkinnedBones);
+			cursor.readArray(skinnedMesh.bindPoses, bindPoseCount);
+			cursor.skip(qsizetype(maxSkinnedBones - bindPoseCount) * sizeof(glm::mat4));
+
+			// SkinnedMeshObj-to-Bone Mapping in a fixed block of 99 IDs, terminated by -1 if shorter.
+			// It's going to be used to get parameterIDs for the parameter update messages
+			if (const char* boneMapField = cursor.take(maxSkinnedBones * sizeof(int32_t))) {
+				int32_t boneIDs[maxSkinnedBones];
+				memcpy(boneIDs, boneMapField, sizeof(boneIDs));
+				skinnedMesh.boneMapIDs.assign(boneIDs, std::find(boneIDs, boneIDs + maxSkinnedBones, -1));
 			}
-			nodeByteCounter += ((99 - i) * 16 * 4); // skipping unused bytes
-			i = 0; // resetting i for next loop
-			int32_t boneID;
-			// Read SkinnedMeshObj-to-Bone Mapping, it's going to be used to get parameterIDs for the parameter update messages
-			while (i < 99) {
-				memcpy(&boneID, sceneNodeByteArray->sliced(nodeByteCounter, sizeof(boneID)).data(), sizeof(boneID)); // Copies byte values directly into the new variable, which interprets it as the correct type
-				// if boneID reads -1 then ignore it and abort the loop
-				if (boneID == -1)
-					break;
-				// otherwise, save the value, and increment the counters
-				skinnedMesh.boneMapIDs.push_back(boneID);
-				nodeByteCounter += sizeof(boneID); i++;
+
+			if (!cursor.ok()) {
+				qWarning() << "Truncated skinned mesh received from TRACER at byte" << cursor.position() << ", ignoring the remaining data";
+				break;
 			}
-			// skip the remaining unused bytes
-			nodeByteCounter += ((99 - i) * 4);
 
 			// Double-check that the characterRootID of the skinnedMesh coincides with the one already present in the current character
 			// This proves that this skinnedMesh belogs to the current character
 			assert(skeletonRootID == currentChar->characterRootID);
 			// Add the filled SkinnedMeshRenderer object to the currently active CharacterObject
-			currentChar->skinnedMeshList.push_back(skinnedMesh);
+			currentChar->skinnedMeshList.push_back(std::move(skinnedMesh));
 
 			// Adding a barebone placeholder SceneNodeObject in order to retain the order of the received scene node list
 			sceneNode.sceneObjectID = -1;
 			sceneNode.characterRootID = currentChar->characterRootID;
-			sceneNode.objectName = nodeName.toStdString();
-			sceneNode.pos = objPos;
-			sceneNode.rot = objRot;
-			sceneNode.scl = objScale;
 
-			sceneNodeListOut->getData()->mSceneNodeObjectSequence.push_back(sceneNode);
+			sceneNodes.push_back(sceneNode);
 
 			break;
+		}
 		case GEO:
 			// skip Geometry Node fields
 			// Components: 1*int + 1*int + 4*float
@@ -434,17 +437,10 @@ void SceneReceiverNode::processSceneNodeByteData(QByteArray* sceneNodeByteArray)
 			// - int geoID
 			// - int  materialID
 			// - vec4 color
-			nodeByteCounter += 24;
+			cursor.skip(24);
 
 			// Create and populate GeometryNodeObject (for now skipping Mesh/Geometry specific fields)
-			sceneNode.sceneObjectID = (editableFlag ? editableSceneNodeCounter : -1); // If this node is editable assign sceneObjectID, otherwise assign -1 (non-editable)
-			sceneNode.characterRootID = -1; // This should/could be changed so that a descendent bone can have a "reference" to the character root
-			sceneNode.objectName = nodeName.toStdString();
-			sceneNode.pos = objPos;
-			sceneNode.rot = objRot;
-			sceneNode.scl = objScale;
-
-			sceneNodeListOut->getData()->mSceneNodeObjectSequence.push_back(sceneNode);
+			sceneNodes.push_back(sceneNode);
 			break;
 		case LIGHT:
 			// skip Light Node fields
@@ -456,17 +452,10 @@ void SceneReceiverNode::processSceneNodeByteData(QByteArray* sceneNodeByteArray)
 			// - float angle
 			// - float range
 			// - vec4 color
-			nodeByteCounter += 28;
+			cursor.skip(28);
 
 			// Create and populate LightNodeObject (for now skipping Light specific fields)
-			sceneNode.sceneObjectID = (editableFlag ? editableSceneNodeCounter : -1); // If this node is editable assign sceneObjectID, otherwise assign -1 (non-editable)
-			sceneNode.characterRootID = -1; // This should/could be changed so that a descendent bone can have a "reference" to the character root
-			sceneNode.objectName = nodeName.toStdString();
-			sceneNode.pos = objPos;
-			sceneNode.rot = objRot;
-			sceneNode.scl = objScale;
-
-			sceneNodeListOut->getData()->mSceneNodeObjectSequence.push_back(sceneNode);
+			sceneNodes.push_back(sceneNode);
 			break;
 		case CAMERA:
 			// skip Camera Node fields
@@ -479,29 +468,14 @@ void SceneReceiverNode::processSceneNodeByteData(QByteArray* sceneNodeByteArray)
 			// - float far
 			// - float focalDist
 			// - float aperture
-			nodeByteCounter += 24;
+			cursor.skip(24);
 
 			// Create and populate CameraNodeObject (for now skipping Camera specific fields)
-			sceneNode.sceneObjectID = (editableFlag ? editableSceneNodeCounter : -1); // If this node is editable assign sceneObjectID, otherwise assign -1 (non-editable)
-			sceneNode.characterRootID = -1; // This should/could be changed so that a descendent bone can have a "reference" to the character root
-			sceneNode.objectName = nodeName.toStdString();
-			sceneNode.pos = objPos;
-			sceneNode.rot = objRot;
-			sceneNode.scl = objScale;
-
-			sceneNodeListOut->getData()->mSceneNodeObjectSequence.push_back(sceneNode);
+			sceneNodes.push_back(sceneNode);
 			break;
 		case GROUP:
-			// Create and populate SceneNodeObject
-			sceneNode.sceneObjectID = (editableFlag ? editableSceneNodeCounter : -1); // If this node is editable assign sceneObjectID, otherwise assign -1 (non-editable)
-			sceneNode.characterRootID = -1; // This should/could be changed so that a descendent bone can have a "reference" to the character root
-			sceneNode.objectName = nodeName.toStdString();
-			sceneNode.pos = objPos;
-			sceneNode.rot = objRot;
-			sceneNode.scl = objScale;
-
 			// TODO: Add latest SceneNodeObject to the global SceneNodeSequence/SceneDescription (which should be accessible throughout AnimHost)
-			sceneNodeListOut->getData()->mSceneNodeObjectSequence.push_back(sceneNode);
+			sceneNodes.push_back(sceneNode);
 
 			break;
 		default:
@@ -511,23 +485,33 @@ void SceneReceiverNode::processSceneNodeByteData(QByteArray* sceneNodeByteArray)
 		// After processing the current SceneNode increment the counter
 		sceneNodeCounter++;
 	}
-	qInfo() << "TRACER Scene deserialized: " << sceneNodeListOut->getData()->mSceneNodeObjectSequence.size() <<  " Nodes | " 
-		<< characterListOut->getData()->mCharacterObjectSequence.size() << " Character(s)";
+	qInfo() << "TRACER Scene deserialized: " << sceneNodes.size() <<  " Nodes | " 
+		<< characters.size() << " Character(s)";
 	//qDebug() << "Number of character received from VPET:" << characterListOut->getData()->mCharacterObjectSequence.size();
 
+	// From now on parameter updates are applied to this state instead of requiring a new scene request
+	_sceneState.rebuild(characterListOut->getData(), sceneNodeListOut->getData());
+
 	_sceneReady = true;
 	emitDataUpdate(0);
 	checkDataReady();
 }
 
-void SceneReceiverNode::processHeaderByteData(QByteArray* headerByteArray) {
+void SceneReceiverNode::processHeaderByteData(const QByteArray& headerByteArray) {
 	// - float	lightIntensityFactor (skipped)
 	// - byte	senderID
 	// - byte	framerate
-	unsigned char senderID; memcpy(&senderID, headerByteArray->sliced(4, sizeof(senderID)).data(), sizeof(senderID)); // Copies byte values directly into the new variable, which interprets it as the correct type
+	ByteCursor cursor(headerByteArray);
+	cursor.skip(sizeof(float));
+
+	unsigned char senderID = 0;
+	unsigned char framerate = 0;
+	if (!cursor.read(senderID) || !cursor.read(framerate)) {
+		qWarning() << "Truncated scene header received from TRACER";
+		return;
+	}
 	ZMQMessageHandler::setTargetSceneID(senderID);
 
-	unsigned char framerate; memcpy(&framerate, headerByteArray->sliced(5, sizeof(framerate)).data(), sizeof(framerate)); // Copies byte values directly into the new variable, which interprets it as the correct type
 	// Set framerate only if a valid value (>0) is received
 	if (framerate > 0)
 		ZMQMessageHandler::setPlaybackFrameRate(framerate);
@@ -535,4 +519,48 @@ void SceneReceiverNode::processHeaderByteData(QByteArray* headerByteArray) {
 
 	_headerReady = true;
 	checkDataReady();
-}
\ No newline at end of file
+}
+
+void SceneReceiverNode::onSceneRequestTimedOut() {
+	qWarning() << "TRACER client at" << _ipAddress << "did not send the complete scene";
+	_signalLight->setColor(QColor(255, 0, 0));
+}
+
+void SceneReceiverNode::applyParameterUpdate(uint8_t sceneID, uint16_t objectID, uint16_t paramID, ZMQMessageHandler::ParameterType paramType, const QByteArray rawData) {
+	if (_sceneState.isEmpty() || sceneID != ZMQMessageHandler::getTargetSceneID())
+		return;
+
+	int changed = _sceneState.applyParameterUpdate(objectID, paramID, paramType, rawData);
+	if (changed == SceneStateCache::NONE)
+		return;
+
+	_pendingChanges |= changed;
+
+	// Report the object only in the lists that hold it
+	auto addPending = [objectID](std::vector<int>& pendingIDs) {
+		if (std::find(pendingIDs.begin(), pendingIDs.end(), objectID) == pendingIDs.end())
+			pendingIDs.push_back(objectID);
+	};
+	if (changed & SceneStateCache::CHARACTERS)
+		addPending(_pendingCharacterIDs);
+	if (changed & SceneStateCache::SCENENODES)
+		addPending(_pendingSceneNodeIDs);
+
+	if (!_deltaTimer->isActive())
+		_deltaTimer->start();
+}
+
+void SceneReceiverNode::flushSceneChanges() {
+	if (_pendingChanges & SceneStateCache::CHARACTERS) {
+		characterListOut->getData()->changedObjectIDs = _pendingCharacterIDs;
+		emitDataUpdate(0);
+	}
+	if (_pendingChanges & SceneStateCache::SCENENODES) {
+		sceneNodeListOut->getData()->changedObjectIDs = _pendingSceneNodeIDs;
+		emitDataUpdate(1);
+	}
+
+	_pendingChanges = SceneStateCache::NONE;
+	_pendingCharacterIDs.clear();
+	_pendingSceneNodeIDs.clear();
+}
@@ -40,6 +40,7 @@
 
 #include "../TRACERPlugin_global.h"
 #include "ZMQMessageHandler.h"
+#include "SceneStateCache.h"
 
 #include <QMetaType>
 #include <QThread>
@@ -58,6 +59,7 @@
 #include <zmq.hpp>
 
 class SceneReceiver;
+class TRACERUpdateReceiver;
 
 class TRACERPLUGINSHARED_EXPORT SceneReceiverNode : public PluginNodeInterface
 {
@@ -102,6 +104,15 @@ private:
     bool _sceneReady = false;
     bool _characterReady = false;
 
+    //! Scene state indexed by sceneObjectID, PARAMETERUPDATE messages are applied to it instead of re-requesting the whole scene
+    SceneStateCache _sceneState;
+    std::shared_ptr<TRACERUpdateReceiver> _updateReceiver = nullptr;   //!< Shared receiver of the TRACER update messages
+    QTimer* _deltaTimer = nullptr;                      //!< Coalesces bursts of parameter updates into one data update per interval
+    int _pendingChanges = SceneStateCache::NONE;        //!< ChangedData flags accumulated since the last data update
+    std::vector<int> _pendingCharacterIDs;              //!< sceneObjectIDs of characters modified since the last data update
+    std::vector<int> _pendingSceneNodeIDs;              //!< sceneObjectIDs of scene nodes modified since the last data update
+    static constexpr int deltaIntervalMs = 16;          //!< Interval in milliseconds at which accumulated changes are passed downstream
+
 public:
     //! Default constructor
     /*!
@@ -109,11 +120,11 @@ public:
      * - \c SceneReceiver::passCharacterByteArray() signal is connected to \c SceneReceiverNode::processCharacterByteData()
      * - \c SceneReceiver::passSceneNodeByteArray() signal is connected to \c SceneReceiverNode::processSceneNodeByteData()
      * - \c SceneReceiver::passHeaderByteArray() signal is connected to \c SceneReceiverNode::processHeaderByteData()
-     * - \c SceneReceiverNode::requestCharacterData() signal is connected to \c SceneReceiver::requestCharacterData()
-     * - \c SceneReceiverNode::requestSceneNodeData() signal is connected to \c SceneReceiver::requestSceneNodeData()
-     * - \c SceneReceiverNode::requestHeaderData() signal is connected to \c SceneReceiver::requestHeaderData()
+     * - \c SceneReceiver::sceneRequestTimedOut() signal is connected to \c SceneReceiverNode::onSceneRequestTimedOut()
+     * - \c SceneReceiverNode::requestSceneData() signal is connected to \c SceneReceiver::requestSceneData()
+     * - \c TRACERUpdateReceiver::parameterUpdateMessage() signal is connected to \c SceneReceiverNode::applyParameterUpdate()
      */
-    SceneReceiverNode(std::shared_ptr<zmq::context_t> zmqConext);
+    SceneReceiverNode(std::shared_ptr<zmq::context_t> zmqConext, std::shared_ptr<TRACERUpdateReceiver> updateReceiver);
     ~SceneReceiverNode() {};
     
     std::unique_ptr<NodeDelegateModel> Init() override { return  nullptr; };
@@ -178,15 +189,13 @@ public:
     enum NodeType { GROUP, GEO, LIGHT, CAMERA, SKINNEDMESH, CHARACTER };
 
 Q_SIGNALS:
-    void requestCharacterData();    //!< Triggers requesting scene character data
-    void requestSceneNodeData();    //!< Triggers requesting scene description data
-    void requestHeaderData();       //!< Triggers requesting scene header data
+    void requestSceneData();        //!< Triggers requesting scene header, character and description data in one go
     void requestControlPathData();       //!< Triggers requesting scene header data !!!TEMPORARY!!!
 
 private Q_SLOTS:
     //! Slot called when the "Request Data" button is clicked
     /*!
-    * Trigger the request of header, scene nodes and character data.
+    * Trigger the request of header, scene nodes and character data, which are issued together.
     * This starts the feedback-loop of requesting, receiving, processing, and updating the connected application plugins
     */
     void onButtonClicked();
@@ -196,20 +205,33 @@ private Q_SLOTS:
     * Unpacking the received byte array representing the characters (in the format of Character Packages) in the scene
     * and filling a [CharacterObjectSequence](@ref CharacterObjectSequence) with these data
     */
-    void processCharacterByteData(QByteArray* charByteArray);
+    void processCharacterByteData(const QByteArray& charByteArray);
     //! Processing the scene node byte sequence received from the external TRACER client
     /*!
     * Unpacking the received array of bytes representing all nodes in the scene (character nodes included)
     * and filling a [SceneNodeObjectSequence](@ref SceneNodeObjectSequence) with these data
     */
-    void processSceneNodeByteData(QByteArray* nodeByteArray);
+    void processSceneNodeByteData(const QByteArray& nodeByteArray);
     //! Processing the header byte sequence received from the external TRACER client
     /*!
     * Unpacking the received byte array representing the scene header data
     * and setting AnimHost-wide static variables in [ZMQMessageHandler](@ref ZMQMessageHandler) with these data:
     * for now only the \c targetSceneID is set
     */
-    void processHeaderByteData(QByteArray* headerByteArray);
+    void processHeaderByteData(const QByteArray& headerByteArray);
+
+    //! Called when the TRACER client didn't answer the scene requests in time, turns the signal light red
+    void onSceneRequestTimedOut();
+
+    //! Applies a PARAMETERUPDATE message of the target scene to the cached scene state
+    /*!
+    * Only position, rotation and scale of known scene objects are mirrored. The sequences are modified in place,
+    * the changed sceneObjectIDs are collected and passed downstream by \c flushSceneChanges()
+    */
+    void applyParameterUpdate(uint8_t sceneID, uint16_t objectID, uint16_t paramID, ZMQMessageHandler::ParameterType paramType, const QByteArray rawData);
+
+    //! Publishes the accumulated changes through \c changedObjectIDs and emits a data update on the modified ports
+    void flushSceneChanges();
 
 };
 
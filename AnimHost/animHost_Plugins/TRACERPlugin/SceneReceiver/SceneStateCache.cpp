@@ -0,0 +1,101 @@
+/*
+ ***************************************************************************************
+
+ *   Copyright (c) 2024 Filmakademie Baden-Wuerttemberg, Animationsinstitut R&D Labs
+ *   https://research.animationsinstitut.de/animhost
+ *   https://github.com/FilmakademieRnd/AnimHost
+ *    
+ *   AnimHost is a development by Filmakademie Baden-Wuerttemberg, Animationsinstitut
+ *   R&D Labs in the scope of the EU funded project MAX-R (101070072).
+ *    
+ *   This program is distributed in the hope that it will be useful, but WITHOUT
+ *   ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ *   FOR A PARTICULAR PURPOSE. See the MIT License for more details.
+ *   You should have received a copy of the MIT License along with this program; 
+ *   if not go to https://opensource.org/licenses/MIT
+
+ ***************************************************************************************
+ */
+
+ 
+
+#include "SceneStateCache.h"
+
+#include <QtEndian>
+
+//! Reads \c count little-endian floats from the start of \c rawData
+static bool readFloats(const QByteArray& rawData, float* values, int count) {
+	if (rawData.size() < static_cast<qsizetype>(count * sizeof(float)))
+		return false;
+
+	for (int i = 0; i < count; i++)
+		values[i] = qFromLittleEndian<float>(rawData.constData() + i * sizeof(float));
+	return true;
+}
+
+void SceneStateCache::rebuild(std::shared_ptr<CharacterObjectSequence> characters, std::shared_ptr<SceneNodeObjectSequence> sceneNodes) {
+	_entries.clear();
+	_characters = characters;
+	_sceneNodes = sceneNodes;
+
+	const auto& nodes = _sceneNodes->mSceneNodeObjectSequence;
+	_entries.reserve(static_cast<qsizetype>(nodes.size()));
+	for (int i = 0; i < static_cast<int>(nodes.size()); i++) {
+		if (nodes[i].sceneObjectID >= 0)
+			_entries[nodes[i].sceneObjectID].sceneNodeIndex = i;
+	}
+
+	const auto& chars = _characters->mCharacterObjectSequence;
+	for (int i = 0; i < static_cast<int>(chars.size()); i++) {
+		if (chars[i].sceneObjectID >= 0)
+			_entries[chars[i].sceneObjectID].characterIndex = i;
+	}
+}
+
+void SceneStateCache::clear() {
+	_entries.clear();
+	_characters.reset();
+	_sceneNodes.reset();
+}
+
+int SceneStateCache::applyParameterUpdate(uint16_t objectID, uint16_t paramID, ZMQMessageHandler::ParameterType paramType, const QByteArray& rawData) {
+	auto entry = _entries.constFind(objectID);
+	if (entry == _entries.constEnd())
+		return NONE;
+
+	// Decode the value once, then write it into every sequence holding the object
+	float values[4];
+	switch (paramID) {
+	case POSITION:
+	case SCALE:
+		if (paramType != ZMQMessageHandler::ParameterType::VECTOR3 || !readFloats(rawData, values, 3))
+			return NONE;
+		break;
+	case ROTATION:
+		// Sent as x, y, z, w like the rotations of the scene node package
+		if (paramType != ZMQMessageHandler::ParameterType::QUATERNION || !readFloats(rawData, values, 4))
+			return NONE;
+		break;
+	default:
+		return NONE;
+	}
+
+	auto apply = [&](SceneNodeObject& object) {
+		switch (paramID) {
+		case POSITION: object.pos = glm::vec3(values[0], values[1], values[2]); break;
+		case ROTATION: object.rot = glm::vec4(values[0], values[1], values[2], values[3]); break;
+		case SCALE:    object.scl = glm::vec3(values[0], values[1], values[2]); break;
+		}
+	};
+
+	int changed = NONE;
+	if (entry->sceneNodeIndex >= 0) {
+		apply(_sceneNodes->mSceneNodeObjectSequence[entry->sceneNodeIndex]);
+		changed |= SCENENODES;
+	}
+	if (entry->characterIndex >= 0) {
+		apply(_characters->mCharacterObjectSequence[entry->characterIndex]);
+		changed |= CHARACTERS;
+	}
+	return changed;
+}
@@ -0,0 +1,90 @@
+/*
+ ***************************************************************************************
+
+ *   Copyright (c) 2024 Filmakademie Baden-Wuerttemberg, Animationsinstitut R&D Labs
+ *   https://research.animationsinstitut.de/animhost
+ *   https://github.com/FilmakademieRnd/AnimHost
+ *    
+ *   AnimHost is a development by Filmakademie Baden-Wuerttemberg, Animationsinstitut
+ *   R&D Labs in the scope of the EU funded project MAX-R (101070072).
+ *    
+ *   This program is distributed in the hope that it will be useful, but WITHOUT
+ *   ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ *   FOR A PARTICULAR PURPOSE. See the MIT License for more details.
+ *   You should have received a copy of the MIT License along with this program; 
+ *   if not go to https://opensource.org/licenses/MIT
+
+ ***************************************************************************************
+ */
+
+ 
+
+//!
+//! \file "SceneStateCache.h"
+//! \brief Index over the received TRACER scene for applying parameter updates in place
+//!
+/*!
+ * ###The cache is rebuilt by the [SceneReceiverNode](@ref SceneReceiverNode) after every full scene receive.
+ * It maps TRACER sceneObjectIDs onto the entries of the CharacterObjectSequence and SceneNodeObjectSequence,
+ * so that a PARAMETERUPDATE message only touches the fields of the object it refers to.
+ */
+
+#ifndef SCENESTATECACHE_H
+#define SCENESTATECACHE_H
+
+#include "../TRACERPlugin_global.h"
+#include "ZMQMessageHandler.h"
+
+#include <QByteArray>
+#include <QHash>
+
+#include <commondatatypes.h>
+
+class TRACERPLUGINSHARED_EXPORT SceneStateCache {
+
+public:
+    //! Flags describing which of the scene sequences were modified by an update
+    enum ChangedData : int {
+        NONE = 0,
+        CHARACTERS = 1 << 0,
+        SCENENODES = 1 << 1
+    };
+
+    //! TRACER parameter IDs shared by every scene object
+    enum SceneObjectParameter : uint16_t {
+        POSITION = 0,
+        ROTATION = 1,
+        SCALE = 2
+    };
+
+    //! Indexes the given sequences by sceneObjectID. Non-editable nodes (sceneObjectID -1) are not indexed
+    void rebuild(std::shared_ptr<CharacterObjectSequence> characters, std::shared_ptr<SceneNodeObjectSequence> sceneNodes);
+
+    //! Drops the index, further updates are ignored until the next rebuild
+    void clear();
+
+    bool isEmpty() const { return _entries.isEmpty(); }
+
+    //! Applies a single parameter update to the cached objects
+    /*!
+    * \param[in]    objectID    The sceneObjectID the update refers to
+    * \param[in]    paramID     The parameter of the scene object, only POSITION, ROTATION and SCALE are mirrored
+    * \param[in]    paramType   The type of the encoded value, used to validate the payload
+    * \param[in]    rawData     The payload of the update, starting with the parameter value
+    * \returns A combination of ChangedData flags, NONE if the object or parameter isn't known
+    */
+    int applyParameterUpdate(uint16_t objectID, uint16_t paramID, ZMQMessageHandler::ParameterType paramType, const QByteArray& rawData);
+
+private:
+    //! Position of an object in the two sequences, -1 if it isn't part of it
+    struct Entry {
+        int sceneNodeIndex = -1;
+        int characterIndex = -1;
+    };
+
+    QHash<int, Entry> _entries;                                 //!< Entries keyed by sceneObjectID
+    std::shared_ptr<CharacterObjectSequence> _characters;       //!< Character sequence the entries point into
+    std::shared_ptr<SceneNodeObjectSequence> _sceneNodes;       //!< Scene node sequence the entries point into
+};
+
+#endif // SCENESTATECACHE_H
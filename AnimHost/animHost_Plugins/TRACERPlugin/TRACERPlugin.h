@@ -105,7 +105,7 @@ class TRACERPLUGINSHARED_EXPORT TRACERPlugin : public PluginNodeCollectionInterf
        void RegisterNodeCollection(NodeDelegateModelRegistry& nodeRegistry) override {
            // Register nodes here
            nodeRegistry.registerModel<CharacterSelectorNode>([this](){ return  std::make_unique<CharacterSelectorNode>();}, "TRACER");
-           nodeRegistry.registerModel<SceneReceiverNode>([this]() { return  std::make_unique<SceneReceiverNode>(_zmqContext); }, "TRACER");
+           nodeRegistry.registerModel<SceneReceiverNode>([this]() { return  std::make_unique<SceneReceiverNode>(_zmqContext, _updateReceiver); }, "TRACER");
            nodeRegistry.registerModel<AnimationSenderNode>([this]() { return  std::make_unique<AnimationSenderNode>(_globalTimer, _zmqContext); }, "TRACER");
            nodeRegistry.registerModel<UpdateReceiverNode>([this]() { return  std::make_unique<UpdateReceiverNode>(_updateReceiver); }, "TRACER");
            nodeRegistry.registerModel<RPCTriggerNode>([this, &nodeRegistry]() { return  std::make_unique<RPCTriggerNode>(nodeRegistry); }, "TRACER");
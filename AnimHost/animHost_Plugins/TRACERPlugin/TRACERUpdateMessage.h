@@ -7,6 +7,7 @@
 #include <commondatatypes.h>
 #include <ZMQMessageHandler.h>
 #include <QDataStream>
+#include <QtEndian>
 
 
 // VECTOR3
@@ -120,6 +121,21 @@ public:
         ZMQMessageHandler::ParameterType paramType, const QByteArray& rawData)
         : sceneID(sceneID), objectID(objectID), paramID(paramID), paramType(paramType), rawData(rawData) {};
 
+    /**
+     * Reads the parameter value at the start of the raw data in place, without a stream or payload object.
+     * Only valid for little-endian scalars, i.e. INT (int32_t) and FLOAT (float) parameters.
+     *
+     * \return false if the raw data is too short for the value.
+     */
+    template <typename T>
+    bool decodeValue(T& value) const {
+        if (rawData.size() < static_cast<qsizetype>(sizeof(T))) {
+            return false;
+        }
+        value = qFromLittleEndian<T>(rawData.constData());
+        return true;
+    }
+
 };
 
 class TRACERPLUGINSHARED_EXPORT ParameterUpdate : public UpdateMessage {
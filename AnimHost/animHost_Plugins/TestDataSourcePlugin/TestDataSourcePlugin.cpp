@@ -67,9 +67,9 @@ void TestDataSourcePlugin::run(QVariantList in, QVariantList& out)
     for (int frame = 0; frame < poseSequenceIn->mPoseSequence.size(); frame++) {
         for (int bone = 0; bone < skeletonIn->mNumBones; bone++) {
 
-            fileOut << poseSequenceIn->mPoseSequence[frame].mPositionData[bone].x << ",";
-            fileOut << poseSequenceIn->mPoseSequence[frame].mPositionData[bone].y << ",";
-            fileOut << poseSequenceIn->mPoseSequence[frame].mPositionData[bone].z;
+            fileOut << poseSequenceIn->mPoseSequence[frame][bone].x << ",";
+            fileOut << poseSequenceIn->mPoseSequence[frame][bone].y << ",";
+            fileOut << poseSequenceIn->mPoseSequence[frame][bone].z;
             if (bone != skeletonIn->mNumBones - 1)
                 fileOut << ",";
 
@@ -76,16 +76,17 @@ struct StarkeConfig {
     int gnn_epochs = 300;
     double gnn_learning_rate = 1e-4;
     double gnn_dropout = 0.3;
+    bool share_dataset = false;   // Publish the dataset matrices in shared memory for the trainer
 
-    auto tie() const { return std::tie(dataset_path, path_to_ai4anim, pae_epochs, pae_learning_rate, gnn_epochs, gnn_learning_rate, gnn_dropout); }
-    auto tie()       { return std::tie(dataset_path, path_to_ai4anim, pae_epochs, pae_learning_rate, gnn_epochs, gnn_learning_rate, gnn_dropout); }
+    auto tie() const { return std::tie(dataset_path, path_to_ai4anim, pae_epochs, pae_learning_rate, gnn_epochs, gnn_learning_rate, gnn_dropout, share_dataset); }
+    auto tie()       { return std::tie(dataset_path, path_to_ai4anim, pae_epochs, pae_learning_rate, gnn_epochs, gnn_learning_rate, gnn_dropout, share_dataset); }
 
     static constexpr auto field_names() {
-        return std::array{"dataset_path", "path_to_ai4anim", "pae_epochs", "pae_learning_rate", "gnn_epochs", "gnn_learning_rate", "gnn_dropout"};
+        return std::array{"dataset_path", "path_to_ai4anim", "pae_epochs", "pae_learning_rate", "gnn_epochs", "gnn_learning_rate", "gnn_dropout", "share_dataset"};
     }
 
     static constexpr auto display_names() {
-        return std::array{"Dataset Path", "AI4Animation Path", "PAE Epochs", "PAE Learning Rate", "GNN Epochs", "GNN Learning Rate", "GNN Dropout"};
+        return std::array{"Dataset Path", "AI4Animation Path", "PAE Epochs", "PAE Learning Rate", "GNN Epochs", "GNN Learning Rate", "GNN Dropout", "Share Dataset In Memory"};
     }
 
     QJsonObject toJson() const {
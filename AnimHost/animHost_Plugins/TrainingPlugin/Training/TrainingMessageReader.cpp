@@ -0,0 +1,154 @@
+/*
+ ***************************************************************************************
+
+ *   Copyright (c) 2024 Filmakademie Baden-Wuerttemberg, Animationsinstitut R&D Labs
+ *   https://research.animationsinstitut.de/animhost
+ *   https://github.com/FilmakademieRnd/AnimHost
+ *    
+ *   AnimHost is a development by Filmakademie Baden-Wuerttemberg, Animationsinstitut
+ *   R&D Labs in the scope of the EU funded project MAX-R (101070072).
+ *    
+ *   This program is distributed in the hope that it will be useful, but WITHOUT
+ *   ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ *   FOR A PARTICULAR PURPOSE. See the MIT License for more details.
+ *   You should have received a copy of the MIT License along with this program; 
+ *   if not go to https://opensource.org/licenses/MIT
+
+ ***************************************************************************************
+ */
+
+ 
+
+#include "TrainingMessageReader.h"
+
+#include <QDebug>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QtEndian>
+
+namespace MLFramework {
+
+void TrainingMessageReader::append(const QByteArray& data, std::vector<TrainingMessage>& messages, QStringList& textLines)
+{
+    // Only the new bytes can contain the newline completing the pending line
+    qsizetype lineStart = 0;
+    qsizetype newline = data.indexOf('\n');
+
+    if (newline < 0) {
+        _pending.append(data);
+        return;
+    }
+
+    _pending.append(data.constData(), newline);
+    parseLine(_pending, messages, textLines);
+    _pending.clear();
+    lineStart = newline + 1;
+
+    while ((newline = data.indexOf('\n', lineStart)) >= 0) {
+        parseLine(QByteArray::fromRawData(data.constData() + lineStart, newline - lineStart), messages, textLines);
+        lineStart = newline + 1;
+    }
+
+    _pending.append(data.constData() + lineStart, data.size() - lineStart);
+}
+
+void TrainingMessageReader::finish(std::vector<TrainingMessage>& messages, QStringList& textLines)
+{
+    if (!_pending.isEmpty()) {
+        parseLine(_pending, messages, textLines);
+        _pending.clear();
+    }
+}
+
+void TrainingMessageReader::reset()
+{
+    _pending.clear();
+    _schemas.clear();
+}
+
+void TrainingMessageReader::parseLine(const QByteArray& line, std::vector<TrainingMessage>& messages, QStringList& textLines)
+{
+    QByteArray trimmedLine = line.trimmed();
+    if (trimmedLine.isEmpty()) {
+        return;
+    }
+
+    if (trimmedLine.front() == binaryRecordPrefix) {
+        TrainingMessage msg;
+        if (parseBinaryRecord(trimmedLine, msg)) {
+            messages.push_back(std::move(msg));
+        }
+        return;
+    }
+
+    if (trimmedLine.front() == '{') {
+        QJsonParseError parseError;
+        QJsonDocument doc = QJsonDocument::fromJson(trimmedLine, &parseError);
+
+        if (parseError.error == QJsonParseError::NoError && doc.isObject()) {
+            QJsonObject obj = doc.object();
+
+            if (obj.contains("binary_schema")) {
+                registerSchema(obj["binary_schema"].toObject());
+                if (!obj.contains("status")) {
+                    return;
+                }
+            }
+
+            messages.push_back(TrainingMessage::fromJson(obj));
+            return;
+        }
+    }
+
+    textLines << QString::fromUtf8(trimmedLine);
+}
+
+bool TrainingMessageReader::parseBinaryRecord(const QByteArray& line, TrainingMessage& msg) const
+{
+    auto decoded = QByteArray::fromBase64Encoding(line.mid(1), QByteArray::AbortOnBase64DecodingErrors);
+    if (!decoded || decoded.decoded.isEmpty()) {
+        qWarning() << "Malformed binary metrics record from training process";
+        return false;
+    }
+
+    const QByteArray& record = decoded.decoded;
+    int schemaId = static_cast<unsigned char>(record[0]);
+
+    auto schema = _schemas.constFind(schemaId);
+    if (schema == _schemas.constEnd()) {
+        qWarning() << "Binary metrics record with undeclared schema" << schemaId;
+        return false;
+    }
+
+    const qsizetype fieldCount = schema->fields.size();
+    if (record.size() != 1 + fieldCount * qsizetype(sizeof(double))) {
+        qWarning() << "Binary metrics record of schema" << schemaId << "has" << record.size()
+                   << "bytes, expected" << 1 + fieldCount * sizeof(double);
+        return false;
+    }
+
+    msg.status = schema->status;
+    for (qsizetype i = 0; i < fieldCount; i++) {
+        double value = qFromLittleEndian<double>(record.constData() + 1 + i * sizeof(double));
+        msg.metrics.insert(schema->fields[i], value);
+    }
+    return true;
+}
+
+void TrainingMessageReader::registerSchema(const QJsonObject& schema)
+{
+    int schemaId = schema["id"].toInt(-1);
+    if (schemaId < 0 || schemaId > 255) {
+        qWarning() << "Binary metrics schema without valid id:" << schema;
+        return;
+    }
+
+    BinarySchema& entry = _schemas[schemaId];
+    entry.status = schema["status"].toString();
+    entry.fields.clear();
+    for (const QJsonValue& field : schema["fields"].toArray()) {
+        entry.fields << field.toString();
+    }
+}
+
+} // namespace MLFramework
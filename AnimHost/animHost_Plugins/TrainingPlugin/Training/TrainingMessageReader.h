@@ -0,0 +1,86 @@
+/*
+ ***************************************************************************************
+
+ *   Copyright (c) 2024 Filmakademie Baden-Wuerttemberg, Animationsinstitut R&D Labs
+ *   https://research.animationsinstitut.de/animhost
+ *   https://github.com/FilmakademieRnd/AnimHost
+ *    
+ *   AnimHost is a development by Filmakademie Baden-Wuerttemberg, Animationsinstitut
+ *   R&D Labs in the scope of the EU funded project MAX-R (101070072).
+ *    
+ *   This program is distributed in the hope that it will be useful, but WITHOUT
+ *   ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ *   FOR A PARTICULAR PURPOSE. See the MIT License for more details.
+ *   You should have received a copy of the MIT License along with this program; 
+ *   if not go to https://opensource.org/licenses/MIT
+
+ ***************************************************************************************
+ */
+
+ 
+
+#ifndef TRAININGMESSAGEREADER_H
+#define TRAININGMESSAGEREADER_H
+
+#include <QByteArray>
+#include <QHash>
+#include <QStringList>
+#include <vector>
+#include "MLFrameworkTypes.h"
+
+namespace MLFramework {
+
+/**
+ * @brief Incremental reader for the line framed stdout channel of the Python ML framework
+ *
+ * Output of the training process is appended as it arrives. Only complete lines are parsed,
+ * the bytes of a line split across reads are kept until its newline arrives. Each line is
+ *
+ * - a JSON TrainingMessage. A message may declare a binary metrics schema in its
+ *   "binary_schema" object: {"id": int, "status": string, "fields": [string, ...]}
+ * - a binary metrics record: '!' followed by the base64 encoding of a uint8 schema id and
+ *   one little-endian float64 per schema field. It is decoded into a TrainingMessage with the
+ *   schema's status and the values as metrics.
+ * - any other text, which is returned as plain output.
+ *
+ * Binary records are base64 encoded since the launcher script may re-encode stdout as text.
+ *
+ * @see ExperimentTracker.declare_binary_metrics() and log_binary_metrics() in Python ML framework
+ */
+class TrainingMessageReader {
+public:
+    static constexpr char binaryRecordPrefix = '!';
+
+private:
+    struct BinarySchema {
+        QString status;
+        QStringList fields;
+    };
+
+    QByteArray _pending;            //!< Bytes of the incomplete last line
+    QHash<int, BinarySchema> _schemas;
+
+    void parseLine(const QByteArray& line, std::vector<TrainingMessage>& messages, QStringList& textLines);
+    bool parseBinaryRecord(const QByteArray& line, TrainingMessage& msg) const;
+    void registerSchema(const QJsonObject& schema);
+
+public:
+    /**
+     * @brief Appends output of the training process and parses all lines completed by it.
+     *
+     * @param data Bytes read from stdout
+     * @param messages Receives the parsed messages in order
+     * @param textLines Receives lines that are not messages
+     */
+    void append(const QByteArray& data, std::vector<TrainingMessage>& messages, QStringList& textLines);
+
+    //! Parses the remaining partial line, e.g. once the process has finished
+    void finish(std::vector<TrainingMessage>& messages, QStringList& textLines);
+
+    //! Drops the partial line and all schemas, e.g. before a new process is started
+    void reset();
+};
+
+} // namespace MLFramework
+
+#endif // TRAININGMESSAGEREADER_H
@@ -20,6 +20,87 @@
 #include "TrainingNode.h"
 #include "TrainingNodeWidget.h"
 #include <QApplication>
+#include <QtConcurrent/QtConcurrentRun>
+#include <Logger.h>
+
+namespace {
+
+// Log lines start with "yyyy-MM-dd hh:mm:ss", which orders the same as the time it represents
+constexpr int logTimestampLength = 19;
+constexpr int sliceWriteSize = 4 * 1024 * 1024;
+
+bool hasLogTimestamp(const QByteArray& line)
+{
+    if (line.size() < logTimestampLength)
+        return false;
+
+    for (int i = 0; i < logTimestampLength; i++) {
+        char c = line[i];
+        bool separator = (i == 4 || i == 7) ? c == '-' : (i == 10) ? c == ' ' : (i == 13 || i == 16) ? c == ':' : (c >= '0' && c <= '9');
+        if (!separator)
+            return false;
+    }
+    return true;
+}
+
+/**
+ * Copies the lines of mainLogPath with a timestamp in [startTime, endTime] to runLogPath,
+ * starting at byte offset and stopping at the first line logged after endTime.
+ */
+void copyLogSlice(const QString& mainLogPath, const QString& runLogPath, qint64 offset,
+                  const QDateTime& startTime, const QDateTime& endTime)
+{
+    QFile mainLog(mainLogPath);
+    if (!mainLog.open(QIODevice::ReadOnly)) {
+        qWarning() << "Failed to open main log file for reading:" << mainLogPath;
+        return;
+    }
+
+    QFile runLog(runLogPath);
+    if (!runLog.open(QIODevice::WriteOnly)) {
+        qWarning() << "Failed to create run log file:" << runLogPath;
+        return;
+    }
+
+    if (offset > 0 && !mainLog.seek(offset)) {
+        mainLog.seek(0);
+    }
+
+    const QByteArray start = startTime.toString("yyyy-MM-dd hh:mm:ss").toLatin1();
+    const QByteArray end = endTime.toString("yyyy-MM-dd hh:mm:ss").toLatin1();
+    // Concurrent producers can log slightly out of order, only stop once a line is a second past the end
+    const QByteArray stop = endTime.addSecs(1).toString("yyyy-MM-dd hh:mm:ss").toLatin1();
+
+    QByteArray slice;
+    int linesCopied = 0;
+
+    while (!mainLog.atEnd()) {
+        QByteArray line = mainLog.readLine();
+
+        if (!hasLogTimestamp(line))
+            continue;
+
+        QByteArray timestamp = QByteArray::fromRawData(line.constData(), logTimestampLength);
+        if (timestamp > stop)
+            break;
+
+        if (timestamp >= start && timestamp <= end) {
+            slice += line;
+            linesCopied++;
+
+            if (slice.size() >= sliceWriteSize) {
+                runLog.write(slice);
+                slice.clear();
+            }
+        }
+    }
+
+    runLog.write(slice);
+
+    qDebug() << "Copied" << linesCopied << "log lines to run directory:" << runLogPath;
+}
+
+}
 
 TrainingNode::TrainingNode()
 {
@@ -41,6 +122,11 @@ TrainingNode::TrainingNode()
             this, &TrainingNode::onTrainingFinished);
     connect(_trainingProcess, &QProcess::errorOccurred,
             this, &TrainingNode::onTrainingProcessError);
+
+    // Coalesce high rate training messages to one UI refresh per frame
+    _uiRefreshTimer.setSingleShot(true);
+    _uiRefreshTimer.setInterval(uiRefreshIntervalMs);
+    connect(&_uiRefreshTimer, &QTimer::timeout, this, &TrainingNode::flushPendingMessages);
     
     qDebug() << "TrainingNode created with Python script path:" << _trainingScriptPath;
 }
@@ -54,6 +140,7 @@ TrainingNode::~TrainingNode()
             _trainingProcess->kill();
         }
     }
+    _logCopy.waitForFinished();
     qDebug() << "~TrainingNode()";
 }
 
@@ -158,6 +245,10 @@ void TrainingNode::run()
         _widget->resetProgress();
     }
 
+    _outputReader.reset();
+    _pendingMessages.clear();
+    _uiRefreshTimer.stop();
+
     // Get current config from input
     auto configData = _configIn.lock();
     auto configPtr = configData->getData();
@@ -182,6 +273,14 @@ void TrainingNode::run()
     } else {
         qWarning() << "Run directory generation failed, artifact preservation will be skipped";
     }
+
+    // Hand the dataset to the trainer through shared memory, the trainer falls back to the files without it
+    if (currentConfig.share_dataset && _datasetPublisher.publishDirectory(currentConfig.dataset_path)) {
+        configJson["shared_dataset"] = _datasetPublisher.segmentName();
+        qDebug() << "Added shared_dataset to config:" << _datasetPublisher.segmentName();
+    } else if (!currentConfig.share_dataset) {
+        _datasetPublisher.release();
+    }
     QJsonDocument doc(configJson);
     QFile configFile(configPath);
     if (configFile.open(QIODevice::WriteOnly)) {
@@ -224,40 +323,67 @@ QWidget* TrainingNode::embeddedWidget()
 /**
  * @brief Handle stdout from the Python training process.
  *
- * Reads and parses JSON-formatted training messages from the Python training
- * script's stdout. Each message contains status updates, progress information,
- * and training metrics (epoch, loss, etc.).
+ * Reads the training script's stdout into the framed message reader. Each complete
+ * line is a JSON message or binary metrics record with status updates, progress
+ * information and training metrics (epoch, loss, etc.), see TrainingMessageReader.
  *
- * Messages are parsed line-by-line to handle multiple JSON objects in a single
- * output batch. Non-JSON output is logged as debug information but ignored.
- * Parsed messages are forwarded to the widget for UI updates.
+ * Lines split across reads are completed by later reads. Non-message output is logged
+ * as debug information but ignored. Parsed messages are forwarded to the widget at
+ * most once per UI frame.
  */
 void TrainingNode::onTrainingOutput()
 {
-    QByteArray data = _trainingProcess->readAllStandardOutput();
-    QString output = QString::fromUtf8(data);
-    if (output.isEmpty() && !data.isEmpty()) {
-        qWarning() << "Failed to decode training process message as UTF-8 data.";
-        return;
+    readTrainingOutput(false);
+}
+
+void TrainingNode::readTrainingOutput(bool processFinished)
+{
+    std::vector<MLFramework::TrainingMessage> messages;
+    QStringList textLines;
+
+    _outputReader.append(_trainingProcess->readAllStandardOutput(), messages, textLines);
+    if (processFinished) {
+        _outputReader.finish(messages, textLines);
     }
-    
-    // Process each line separately (in case multiple JSON objects are received)
-    QStringList lines = output.split('\n', Qt::SkipEmptyParts);
-    for (const QString& line : lines) {
-        QString trimmedLine = line.trimmed();
-        if (!trimmedLine.isEmpty()) {         
-            QJsonParseError parseError;
-            QJsonDocument doc = QJsonDocument::fromJson(trimmedLine.toUtf8(), &parseError);
-            
-            if (parseError.error != QJsonParseError::NoError) {
-                qDebug() << "Non-JSON stdout:" << trimmedLine;
-                continue;
+
+    for (const QString& line : textLines) {
+        qDebug() << "Non-JSON stdout:" << line;
+    }
+
+    queueMessages(messages);
+}
+
+void TrainingNode::queueMessages(std::vector<MLFramework::TrainingMessage>& messages)
+{
+    for (MLFramework::TrainingMessage& msg : messages) {
+        // Only the latest metrics of a status are shown, errors are forwarded one by one
+        if (!_pendingMessages.empty() && _pendingMessages.back().status == msg.status && msg.status != "Error") {
+            MLFramework::TrainingMessage& pending = _pendingMessages.back();
+            for (auto it = msg.metrics.constBegin(); it != msg.metrics.constEnd(); ++it) {
+                pending.metrics.insert(it.key(), it.value());
             }
-            
-            MLFramework::TrainingMessage msg = MLFramework::TrainingMessage::fromJson(doc.object());
-            updateFromMessage(msg);
+            if (!msg.text.isEmpty()) {
+                pending.text = msg.text;
+            }
+        }
+        else {
+            _pendingMessages.push_back(std::move(msg));
         }
     }
+
+    if (!_pendingMessages.empty() && !_uiRefreshTimer.isActive()) {
+        _uiRefreshTimer.start();
+    }
+}
+
+void TrainingNode::flushPendingMessages()
+{
+    std::vector<MLFramework::TrainingMessage> messages;
+    messages.swap(_pendingMessages);
+
+    for (const MLFramework::TrainingMessage& msg : messages) {
+        updateFromMessage(msg);
+    }
 }
 
 /**
@@ -279,6 +405,11 @@ void TrainingNode::onTrainingFinished(int exitCode, QProcess::ExitStatus exitSta
 {
     qDebug() << "Training process finished with exit code:" << exitCode << "status:" << exitStatus;
 
+    // Deliver the remaining output, including a last line without newline, before the final status
+    readTrainingOutput(true);
+    _uiRefreshTimer.stop();
+    flushPendingMessages();
+
     // Copy log slice to run directory
     QDateTime endTime = QDateTime::currentDateTime();
     copyLogSliceToRunDir(_trainingStartTime, endTime);
@@ -416,9 +547,12 @@ QString TrainingNode::generateRunDir()
  * @brief Copy log entries from the main log file to the run directory.
  *
  * Extracts log entries between startTime and endTime from LogOutput.txt
- * and writes them to <run_dir>/LogOutput.txt. This preserves a training-specific
+ * and writes them to <run_dir>/RunLogOutput.txt. This preserves a training-specific
  * log slice without affecting the main application log.
  *
+ * The logger's time index gives the byte offset to start reading at, so only the
+ * training window is read instead of the whole log. The copy runs on a worker thread.
+ *
  * Log format expected: "yyyy-MM-dd hh:mm:ss || ..."
  */
 void TrainingNode::copyLogSliceToRunDir(const QDateTime& startTime, const QDateTime& endTime)
@@ -429,45 +563,20 @@ void TrainingNode::copyLogSliceToRunDir(const QDateTime& startTime, const QDateT
         return;
     }
 
-    // Open main log file
-    QString mainLogPath = QApplication::applicationDirPath() + "/LogOutput.txt";
-    QFile mainLog(mainLogPath);
-    if (!mainLog.open(QIODevice::ReadOnly | QIODevice::Text)) {
-        qWarning() << "Failed to open main log file for reading:" << mainLogPath;
-        return;
-    }
+    // The index is only valid for the file the logger writes to
+    QString mainLogPath = Logger::logFilePath();
+    qint64 offset = 0;
 
-    // Create run-specific log file
-    QString runLogPath = _currentRunDir + "/RunLogOutput.txt";
-    QFile runLog(runLogPath);
-    if (!runLog.open(QIODevice::WriteOnly | QIODevice::Text)) {
-        qWarning() << "Failed to create run log file:" << runLogPath;
-        mainLog.close();
-        return;
+    if (mainLogPath.isEmpty()) {
+        mainLogPath = QApplication::applicationDirPath() + "/LogOutput.txt";
     }
-
-    // Read and filter log lines
-    QTextStream in(&mainLog);
-    QTextStream out(&runLog);
-    int linesCopied = 0;
-
-    while (!in.atEnd()) {
-        QString line = in.readLine();
-
-        // Parse timestamp from log line format: "yyyy-MM-dd hh:mm:ss || ..."
-        if (line.length() >= 19) {
-            QString timestampStr = line.left(19);
-            QDateTime lineTime = QDateTime::fromString(timestampStr, "yyyy-MM-dd hh:mm:ss");
-
-            if (lineTime.isValid() && lineTime >= startTime && lineTime <= endTime) {
-                out << line << "\n";
-                linesCopied++;
-            }
-        }
+    else {
+        Logger::Flush();
+        offset = Logger::logOffsetBefore(startTime);
     }
 
-    mainLog.close();
-    runLog.close();
+    QString runLogPath = _currentRunDir + "/RunLogOutput.txt";
 
-    qDebug() << "Copied" << linesCopied << "log lines to run directory:" << runLogPath;
+    _logCopy.waitForFinished();
+    _logCopy = QtConcurrent::run(copyLogSlice, mainLogPath, runLogPath, offset, startTime, endTime);
 }
@@ -26,11 +26,14 @@
 #include <QtWidgets>
 #include <QTimer>
 #include <QProcess>
+#include <QFuture>
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <pluginnodeinterface.h>
 #include <nodedatatypes.h>
 #include "MLFrameworkTypes.h"
+#include "TrainingMessageReader.h"
+#include <SharedDatasetPublisher.h>
 
 class TrainingNodeWidget;
 
@@ -55,6 +58,20 @@ private:
     // Training start time for log slicing
     QDateTime _trainingStartTime;
 
+    // Pending copy of the training's log slice
+    QFuture<void> _logCopy;
+
+    // Dataset matrices shared with the training process, kept across runs on unchanged data
+    SharedDatasetPublisher _datasetPublisher;
+
+    // Framed reader of the training process stdout
+    MLFramework::TrainingMessageReader _outputReader;
+
+    // Messages received since the last UI refresh, consecutive messages of one status are merged
+    std::vector<MLFramework::TrainingMessage> _pendingMessages;
+    QTimer _uiRefreshTimer;
+    static constexpr int uiRefreshIntervalMs = 16;
+
     // Framework automatically provides RunSignal input at port 0
 
 public:
@@ -86,10 +103,13 @@ private Q_SLOTS:
     void onTrainingFinished(int exitCode, QProcess::ExitStatus exitStatus);
     void onTrainingError();
     void onTrainingProcessError(QProcess::ProcessError error);
+    void flushPendingMessages();
 
 private:
     void updateConnectionStatus(const QString& status, const QColor& signalColor);
     void updateFromMessage(const MLFramework::TrainingMessage& msg);
+    void readTrainingOutput(bool processFinished);
+    void queueMessages(std::vector<MLFramework::TrainingMessage>& messages);
     QString generateRunDir();
     void copyLogSliceToRunDir(const QDateTime& startTime, const QDateTime& endTime);
 
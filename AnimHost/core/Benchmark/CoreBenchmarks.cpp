@@ -0,0 +1,310 @@
+/*
+ ***************************************************************************************
+
+ *   Copyright (c) 2024 Filmakademie Baden-Wuerttemberg, Animationsinstitut R&D Labs
+ *   https://research.animationsinstitut.de/animhost
+ *   https://github.com/FilmakademieRnd/AnimHost
+ *    
+ *   AnimHost is a development by Filmakademie Baden-Wuerttemberg, Animationsinstitut
+ *   R&D Labs in the scope of the EU funded project MAX-R (101070072).
+ *    
+ *   This program is distributed in the hope that it will be useful, but WITHOUT
+ *   ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ *   FOR A PARTICULAR PURPOSE. See the MIT License for more details.
+ *   You should have received a copy of the MIT License along with this program; 
+ *   if not go to https://opensource.org/licenses/MIT
+
+ ***************************************************************************************
+ */
+
+ 
+/**
+ * @file CoreBenchmarks.cpp
+ * @brief Micro-benchmarks of the core math and keyframe sampling hot paths.
+ *
+ * Clips come from ProceduralAnimation and are parameterized by bone count (26, 65, 150), clip length
+ * and key stride. Besides the Google Benchmark timings every kernel reports heap allocations per
+ * operation as the allocs/op and bytes/op counters.
+ *
+ * Allocations are counted by replacing the global operator new of this executable. The core sources
+ * of the measured kernels are compiled into the benchmark for that reason.
+ *
+ * Usage:
+ *   CoreBenchmarks [--benchmark_filter=<regex>] [--benchmark_format=json] [--benchmark_out=results.json]
+ */
+
+#include "ProceduralAnimation.h"
+
+#include <animhosthelper.h>
+#include <commondatatypes.h>
+#include <FrameRange.h>
+#include <MathUtils.h>
+
+#include <benchmark/benchmark.h>
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <random>
+
+
+namespace {
+
+	std::atomic<std::uint64_t> allocationCount{ 0 };
+	std::atomic<std::uint64_t> allocatedBytes{ 0 };
+
+	void* countedAlloc(std::size_t size)
+	{
+		allocationCount.fetch_add(1, std::memory_order_relaxed);
+		allocatedBytes.fetch_add(size, std::memory_order_relaxed);
+
+		if (void* ptr = std::malloc(size ? size : 1)) {
+			return ptr;
+		}
+		throw std::bad_alloc();
+	}
+
+	/**
+	 * Counts the allocations between construction and report(), which adds them as per iteration counters.
+	 */
+	class AllocationScope {
+		std::uint64_t startCount;
+		std::uint64_t startBytes;
+
+	public:
+		AllocationScope()
+			: startCount(allocationCount.load(std::memory_order_relaxed)), startBytes(allocatedBytes.load(std::memory_order_relaxed)) {}
+
+		void report(benchmark::State& state) const
+		{
+			double count = static_cast<double>(allocationCount.load(std::memory_order_relaxed) - startCount);
+			double bytes = static_cast<double>(allocatedBytes.load(std::memory_order_relaxed) - startBytes);
+
+			state.counters["allocs/op"] = benchmark::Counter(count, benchmark::Counter::kAvgIterations);
+			state.counters["bytes/op"] = benchmark::Counter(bytes, benchmark::Counter::kAvgIterations);
+		}
+	};
+
+	constexpr std::uint32_t ClipSeed = 2024;
+
+	// Bone counts of a reduced biped, a full mocap skeleton and a skeleton with fingers and face joints
+	const std::vector<std::int64_t> BoneCounts = { 26, 65, 150 };
+	const std::vector<std::int64_t> ClipLengths = { 120, 1200 };
+	const std::vector<std::int64_t> KeyStrides = { 1, 4 };
+
+	/**
+	 * Procedural clip shared by the skeleton benchmarks.
+	 * Arguments: bone count, clip length in frames, key stride.
+	 */
+	class ClipFixture : public benchmark::Fixture {
+	public:
+		Skeleton skeleton;
+		Animation animation;
+		int frameCount = 0;
+
+		void SetUp(const benchmark::State& state) override
+		{
+			frameCount = static_cast<int>(state.range(1));
+			ProceduralAnimation::BuildSkeleton(static_cast<int>(state.range(0)), skeleton);
+			ProceduralAnimation::BuildAnimation(skeleton, frameCount, static_cast<int>(state.range(2)), ClipSeed, animation);
+		}
+
+		void TearDown(const benchmark::State&) override
+		{
+			animation.mBones.clear();
+		}
+
+		//! Bone of the first chain halfway down, channels of all bones are built the same way
+		const Bone& sampleBone() const
+		{
+			return animation.mBones[skeleton.mNumBones / 2];
+		}
+	};
+
+	std::vector<glm::quat> randomRotations(size_t count)
+	{
+		std::mt19937 rng(ClipSeed);
+		std::vector<glm::quat> rotations;
+		rotations.reserve(count);
+
+		for (size_t i = 0; i < count; i++) {
+			glm::vec4 v(rng() % 2001, rng() % 2001, rng() % 2001, rng() % 2001);
+			v = v / 1000.f - 1.f;
+			rotations.push_back(glm::normalize(glm::quat(v.w + 2.f, v.x, v.y, v.z)));
+		}
+		return rotations;
+	}
+
+	std::vector<glm::mat4> randomTransforms(size_t count)
+	{
+		std::vector<glm::quat> rotations = randomRotations(count);
+		std::vector<glm::mat4> transforms;
+		transforms.reserve(count);
+
+		for (size_t i = 0; i < count; i++) {
+			glm::vec3 position(static_cast<float>(i % 17), static_cast<float>(i % 5), static_cast<float>(i % 29));
+			transforms.push_back(glm::translate(glm::mat4(1.0f), position) * glm::toMat4(rotations[i]));
+		}
+		return transforms;
+	}
+
+	constexpr size_t MathBatchSize = 1024;
+}
+
+
+void* operator new(std::size_t size) { return countedAlloc(size); }
+void* operator new[](std::size_t size) { return countedAlloc(size); }
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+void operator delete[](void* ptr) noexcept { std::free(ptr); }
+void operator delete(void* ptr, std::size_t) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, std::size_t) noexcept { std::free(ptr); }
+
+
+// ============================================================================================================
+// Keyframe sampling
+// ============================================================================================================
+
+BENCHMARK_DEFINE_F(ClipFixture, BoneGetOrientation)(benchmark::State& state)
+{
+	const Bone& bone = sampleBone();
+	int frame = 0;
+
+	AllocationScope allocations;
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(bone.GetOrientation(frame));
+		frame = frame + 1 < frameCount ? frame + 1 : 0;
+	}
+	allocations.report(state);
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK_REGISTER_F(ClipFixture, BoneGetOrientation)->ArgsProduct({ { 26 }, ClipLengths, KeyStrides });
+
+BENCHMARK_DEFINE_F(ClipFixture, BoneGetPosition)(benchmark::State& state)
+{
+	const Bone& bone = sampleBone();
+	int frame = 0;
+
+	AllocationScope allocations;
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(bone.GetPosition(frame));
+		frame = frame + 1 < frameCount ? frame + 1 : 0;
+	}
+	allocations.report(state);
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK_REGISTER_F(ClipFixture, BoneGetPosition)->ArgsProduct({ { 26 }, ClipLengths, KeyStrides });
+
+// ============================================================================================================
+// Skeleton kernels, one operation is one frame of the clip
+// ============================================================================================================
+
+BENCHMARK_DEFINE_F(ClipFixture, ForwardKinematics)(benchmark::State& state)
+{
+	std::vector<glm::mat4> transforms;
+	AnimHostHelper::ForwardKinematics(skeleton, animation, transforms, 0);
+	int frame = 0;
+
+	AllocationScope allocations;
+	for (auto _ : state) {
+		AnimHostHelper::ForwardKinematics(skeleton, animation, transforms, frame);
+		benchmark::DoNotOptimize(transforms.data());
+		benchmark::ClobberMemory();
+		frame = frame + 1 < frameCount ? frame + 1 : 0;
+	}
+	allocations.report(state);
+	state.SetItemsProcessed(state.iterations() * skeleton.mNumBones);
+}
+BENCHMARK_REGISTER_F(ClipFixture, ForwardKinematics)->ArgsProduct({ BoneCounts, ClipLengths, KeyStrides });
+
+BENCHMARK_DEFINE_F(ClipFixture, CalculateRootTransform)(benchmark::State& state)
+{
+	int frame = 0;
+
+	AllocationScope allocations;
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(animation.CalculateRootTransform(frame, 0));
+		frame = frame + 1 < frameCount ? frame + 1 : 0;
+	}
+	allocations.report(state);
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK_REGISTER_F(ClipFixture, CalculateRootTransform)->ArgsProduct({ { 26 }, ClipLengths, KeyStrides });
+
+// ============================================================================================================
+// MathUtils, one operation is one element of a batch of MathBatchSize inputs
+// ============================================================================================================
+
+static void BM_MixTransform(benchmark::State& state)
+{
+	const std::vector<glm::mat4> from = randomTransforms(MathBatchSize);
+	std::vector<glm::mat4> to(from.rbegin(), from.rend());
+	size_t i = 0;
+
+	AllocationScope allocations;
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(MathUtils::MixTransform(from[i], to[i], 0.3f, 0.6f, 1.f));
+		i = (i + 1) & (MathBatchSize - 1);
+	}
+	allocations.report(state);
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_MixTransform);
+
+static void BM_ConvertRotationTo6D(benchmark::State& state)
+{
+	const std::vector<glm::quat> rotations = randomRotations(MathBatchSize);
+	size_t i = 0;
+
+	AllocationScope allocations;
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(MathUtils::ConvertRotationTo6D(rotations[i]));
+		i = (i + 1) & (MathBatchSize - 1);
+	}
+	allocations.report(state);
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ConvertRotationTo6D);
+
+static void BM_Convert6DToRotation(benchmark::State& state)
+{
+	std::vector<Rotation6D> rotations;
+	for (const glm::quat& rotation : randomRotations(MathBatchSize)) {
+		rotations.push_back(MathUtils::ConvertRotationTo6D(rotation));
+	}
+	size_t i = 0;
+
+	AllocationScope allocations;
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(MathUtils::Convert6DToRotation(rotations[i]));
+		i = (i + 1) & (MathBatchSize - 1);
+	}
+	allocations.report(state);
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_Convert6DToRotation);
+
+// ============================================================================================================
+// FrameRange, one operation is a full iteration of the trajectory window. Argument: number of samples
+// ============================================================================================================
+
+static void BM_FrameRangeIteration(benchmark::State& state)
+{
+	const int numSamples = static_cast<int>(state.range(0));
+	int referenceFrame = 60;
+
+	AllocationScope allocations;
+	for (auto _ : state) {
+		int sum = 0;
+		for (int frame : FrameRange(numSamples, 60, referenceFrame)) {
+			sum += frame;
+		}
+		benchmark::DoNotOptimize(sum);
+		referenceFrame = referenceFrame < 1000 ? referenceFrame + 1 : 60;
+	}
+	allocations.report(state);
+	state.SetItemsProcessed(state.iterations() * numSamples);
+}
+BENCHMARK(BM_FrameRangeIteration)->Arg(7)->Arg(13)->Arg(61);
+
+
+BENCHMARK_MAIN();
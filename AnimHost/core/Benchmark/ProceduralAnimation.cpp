@@ -0,0 +1,129 @@
+/*
+ ***************************************************************************************
+
+ *   Copyright (c) 2024 Filmakademie Baden-Wuerttemberg, Animationsinstitut R&D Labs
+ *   https://research.animationsinstitut.de/animhost
+ *   https://github.com/FilmakademieRnd/AnimHost
+ *    
+ *   AnimHost is a development by Filmakademie Baden-Wuerttemberg, Animationsinstitut
+ *   R&D Labs in the scope of the EU funded project MAX-R (101070072).
+ *    
+ *   This program is distributed in the hope that it will be useful, but WITHOUT
+ *   ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ *   FOR A PARTICULAR PURPOSE. See the MIT License for more details.
+ *   You should have received a copy of the MIT License along with this program; 
+ *   if not go to https://opensource.org/licenses/MIT
+
+ ***************************************************************************************
+ */
+
+ 
+#include "ProceduralAnimation.h"
+
+#include <glm/gtc/constants.hpp>
+#include <glm/gtx/quaternion.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <string>
+
+
+namespace {
+
+	constexpr int NumChains = 5;
+
+	// mt19937 output is specified by the standard, unlike the std distributions
+	float uniform(std::mt19937& rng, float min, float max)
+	{
+		float t = static_cast<float>(rng() & 0xFFFFFF) / static_cast<float>(0xFFFFFF);
+		return min + t * (max - min);
+	}
+
+	std::vector<int> keyFrames(int frameCount, int keyStride)
+	{
+		std::vector<int> frames;
+		for (int frame = 0; frame < frameCount; frame += keyStride) {
+			frames.push_back(frame);
+		}
+		if (frames.back() != frameCount - 1) {
+			frames.push_back(frameCount - 1);
+		}
+		return frames;
+	}
+}
+
+void ProceduralAnimation::BuildSkeleton(int boneCount, Skeleton& skeleton)
+{
+	skeleton = Skeleton();
+	skeleton.mNumBones = std::max(1, boneCount);
+	skeleton.rootBoneID = 0;
+
+	std::vector<int> chainTips(NumChains, 0);
+
+	for (int id = 0; id < skeleton.mNumBones; id++) {
+		std::string name = id == 0 ? "root" : "bone_" + std::to_string(id);
+		skeleton.bone_names[name] = id;
+		skeleton.bone_names_reverse[id] = name;
+		skeleton.bone_hierarchy[id] = std::vector<int>();
+
+		if (id > 0) {
+			int& tip = chainTips[(id - 1) % NumChains];
+			skeleton.bone_hierarchy[tip].push_back(id);
+			tip = id;
+		}
+	}
+
+	skeleton.buildLookupTables();
+}
+
+void ProceduralAnimation::BuildAnimation(const Skeleton& skeleton, int frameCount, int keyStride, std::uint32_t seed, Animation& animation)
+{
+	frameCount = std::max(2, frameCount);
+	keyStride = std::max(1, keyStride);
+
+	std::mt19937 rng(seed);
+	const std::vector<int> frames = keyFrames(frameCount, keyStride);
+	const float frameRate = 60.f;
+
+	animation.mBones = std::vector<Bone>(skeleton.mNumBones, Bone());
+	animation.mDurationFrames = frameCount;
+	animation.mDuration = static_cast<float>(frameCount);
+
+	for (int id = 0; id < skeleton.mNumBones; id++) {
+		Bone& bone = animation.mBones[id];
+
+		float frequency = uniform(rng, 0.5f, 2.f);
+		float amplitude = glm::radians(uniform(rng, 5.f, 30.f));
+		float phase = uniform(rng, 0.f, glm::two_pi<float>());
+		glm::vec3 axis = glm::normalize(glm::vec3(uniform(rng, -1.f, 1.f), uniform(rng, -1.f, 1.f), uniform(rng, -1.f, 1.f)) + glm::vec3(0.f, 0.f, 1e-3f));
+		glm::vec3 offset = id == 0 ? glm::vec3(0.f, 90.f, 0.f) : glm::vec3(0.f, uniform(rng, 5.f, 20.f), 0.f);
+
+		bone.mName = skeleton.bone_names_reverse.at(id);
+		bone.mID = id;
+		bone.mRestingTransform = glm::translate(glm::mat4(1.0f), offset);
+		bone.restingRotation = glm::quat(1.0f, 0.0f, 0.0f, 0.0f);
+
+		bone.mRotationKeys.reserve(frames.size());
+		bone.mPositonKeys.reserve(frames.size());
+
+		for (int frame : frames) {
+			float t = frame / frameRate;
+			float angle = amplitude * std::sin(glm::two_pi<float>() * frequency * t + phase);
+			bone.mRotationKeys.emplace_back(static_cast<float>(frame), glm::angleAxis(angle, axis));
+
+			glm::vec3 position = offset;
+			if (id == 0) {
+				position += glm::vec3(0.f, 2.f * std::sin(glm::two_pi<float>() * 2.f * t), 120.f * t);
+			}
+			bone.mPositonKeys.emplace_back(static_cast<float>(frame), position);
+		}
+
+		bone.mNumKeysRotation = static_cast<int>(bone.mRotationKeys.size());
+		bone.mNumKeysPosition = static_cast<int>(bone.mPositonKeys.size());
+		// Constant unit scale, a clip without scale keys would sample a zero scale
+		bone.mScaleKeys.push_back({ 0.0f, glm::vec3(1.0f) });
+		bone.mNumKeysScale = 1;
+		bone.UpdateSampling();
+	}
+}
@@ -0,0 +1,60 @@
+/*
+ ***************************************************************************************
+
+ *   Copyright (c) 2024 Filmakademie Baden-Wuerttemberg, Animationsinstitut R&D Labs
+ *   https://research.animationsinstitut.de/animhost
+ *   https://github.com/FilmakademieRnd/AnimHost
+ *    
+ *   AnimHost is a development by Filmakademie Baden-Wuerttemberg, Animationsinstitut
+ *   R&D Labs in the scope of the EU funded project MAX-R (101070072).
+ *    
+ *   This program is distributed in the hope that it will be useful, but WITHOUT
+ *   ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ *   FOR A PARTICULAR PURPOSE. See the MIT License for more details.
+ *   You should have received a copy of the MIT License along with this program; 
+ *   if not go to https://opensource.org/licenses/MIT
+
+ ***************************************************************************************
+ */
+
+ 
+#ifndef PROCEDURALANIMATION_H
+#define PROCEDURALANIMATION_H
+
+#include "commondatatypes.h"
+
+#include <cstdint>
+
+
+/**
+ * @class ProceduralAnimation
+ *
+ * @brief Deterministic synthetic skeletons and clips for the core benchmarks.
+ *
+ * The generated data only depends on the parameters, so benchmark results are comparable between
+ * machines and releases without shipping motion capture data.
+ */
+class ProceduralAnimation {
+
+public:
+
+	/**
+	 * @brief Builds a skeleton of boneCount bones.
+	 *
+	 * Bone 0 is the root, the remaining bones are distributed round robin over five chains starting
+	 * at the root (spine, legs and arms of a humanoid). Lookup tables are built.
+	 */
+	static void BuildSkeleton(int boneCount, Skeleton& skeleton);
+
+	/**
+	 * @brief Fills animation with frameCount frames of oscillating joint rotations for skeleton.
+	 *
+	 * The root bone moves forward along +z, scale is constant. Keys are written every keyStride frames, plus a key at the last frame.
+	 * A stride of 1 produces uniform channels that are sampled by index, larger strides are interpolated.
+	 *
+	 * @param seed Seed of the joint frequencies, amplitudes and axes.
+	 */
+	static void BuildAnimation(const Skeleton& skeleton, int frameCount, int keyStride, std::uint32_t seed, Animation& animation);
+};
+
+#endif // PROCEDURALANIMATION_H
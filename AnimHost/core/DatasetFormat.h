@@ -0,0 +1,107 @@
+/*
+ ***************************************************************************************
+
+ *   Copyright (c) 2024 Filmakademie Baden-Wuerttemberg, Animationsinstitut R&D Labs
+ *   https://research.animationsinstitut.de/animhost
+ *   https://github.com/FilmakademieRnd/AnimHost
+ *    
+ *   AnimHost is a development by Filmakademie Baden-Wuerttemberg, Animationsinstitut
+ *   R&D Labs in the scope of the EU funded project MAX-R (101070072).
+ *    
+ *   This program is distributed in the hope that it will be useful, but WITHOUT
+ *   ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ *   FOR A PARTICULAR PURPOSE. See the MIT License for more details.
+ *   You should have received a copy of the MIT License along with this program; 
+ *   if not go to https://opensource.org/licenses/MIT
+
+ ***************************************************************************************
+ */
+
+ 
+#ifndef DATASETFORMAT_H
+#define DATASETFORMAT_H
+
+#include "animhostcore_global.h"
+
+#include <QString>
+#include <QStringList>
+#include <QByteArray>
+#include <QtGlobal>
+
+
+/**
+ * @brief On-disk layout of the indexed training dataset container (*.ahds).
+ *
+ * A container holds one feature matrix (e.g. the network input or output) and is laid out as
+ *
+ *   [FileHeader][rows: rowCount x featureCount values][sequence index][statistics]
+ *
+ * All values are little endian. Rows start at dataOffset, which is aligned to 64 bytes, so the data
+ * block can be memory mapped and used as a (rowCount, featureCount) array without copying.
+ * The sequence index lists the first row and row count of every exported sequence. The statistics block
+ * holds the running per feature statistics of all rows as written by FeatureStatistics::toByteArray().
+ * Index and statistics start at 8 byte aligned offsets.
+ * Index and statistics are rewritten at the end of every export run. While rows are being appended
+ * indexOffset and statsOffset are 0. rowCount is kept up to date on every flush, so the rows of an
+ * unfinished file stay readable.
+ */
+namespace DatasetFormat {
+
+	static constexpr char Magic[4] = { 'A', 'H', 'D', 'S' };
+	static constexpr quint32 Version = 1;
+	static constexpr quint64 DataAlignment = 64;
+
+	enum DataType : quint32 {
+		Float32 = 0,
+	};
+
+	struct FileHeader {
+		char magic[4];          //!< Always "AHDS"
+		quint32 version;        //!< Format version, see DatasetFormat::Version
+		quint32 dataType;       //!< Element type of the rows, see DatasetFormat::DataType
+		quint32 featureCount;   //!< Number of values per row
+		quint64 labelsHash;     //!< hashLabels() of the feature labels, 0 if unknown
+		quint64 rowCount;       //!< Number of rows in the data block
+		quint64 dataOffset;     //!< Byte offset of the first row
+		quint64 indexOffset;    //!< Byte offset of the sequence index, 0 if not written
+		quint64 sequenceCount;  //!< Number of entries in the sequence index
+		quint64 statsOffset;    //!< Byte offset of the per feature statistics, 0 if not written
+	};
+	static_assert(sizeof(FileHeader) == 64, "DatasetFormat::FileHeader must be 64 bytes");
+
+	struct SequenceEntry {
+		qint32 sequenceID;      //!< Sequence identifier as written to the sequences file
+		qint32 firstFrame;      //!< Source frame of the first row
+		quint64 firstRow;       //!< Index of the first row of this sequence
+		quint64 rowCount;       //!< Number of consecutive rows belonging to this sequence
+	};
+	static_assert(sizeof(SequenceEntry) == 24, "DatasetFormat::SequenceEntry must be 24 bytes");
+
+	/**
+	 * @brief 64 bit FNV-1a hash over the comma separated feature labels.
+	 *
+	 * Used to detect appending rows with a different feature layout to an existing container.
+	 */
+	inline quint64 hashLabels(const QStringList& labels) {
+		QByteArray bytes = labels.join(',').toUtf8();
+
+		quint64 hash = 14695981039346656037ull;
+		for (char c : bytes) {
+			hash ^= static_cast<quint8>(c);
+			hash *= 1099511628211ull;
+		}
+		return hash;
+	}
+
+	inline quint64 alignOffset(quint64 offset, quint64 alignment = 8) {
+		return (offset + alignment - 1) / alignment * alignment;
+	}
+
+	inline bool isValidHeader(const FileHeader& header) {
+		return header.magic[0] == Magic[0] && header.magic[1] == Magic[1]
+			&& header.magic[2] == Magic[2] && header.magic[3] == Magic[3]
+			&& header.version == Version && header.dataType == Float32;
+	}
+}
+
+#endif // DATASETFORMAT_H
@@ -0,0 +1,173 @@
+/*
+ ***************************************************************************************
+
+ *   Copyright (c) 2024 Filmakademie Baden-Wuerttemberg, Animationsinstitut R&D Labs
+ *   https://research.animationsinstitut.de/animhost
+ *   https://github.com/FilmakademieRnd/AnimHost
+ *    
+ *   AnimHost is a development by Filmakademie Baden-Wuerttemberg, Animationsinstitut
+ *   R&D Labs in the scope of the EU funded project MAX-R (101070072).
+ *    
+ *   This program is distributed in the hope that it will be useful, but WITHOUT
+ *   ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ *   FOR A PARTICULAR PURPOSE. See the MIT License for more details.
+ *   You should have received a copy of the MIT License along with this program; 
+ *   if not go to https://opensource.org/licenses/MIT
+
+ ***************************************************************************************
+ */
+
+ 
+#include "DatasetReader.h"
+
+#include <QDebug>
+#include <cstring>
+
+
+DatasetReader::~DatasetReader()
+{
+	close();
+}
+
+bool DatasetReader::open(const QString& path)
+{
+	close();
+
+	_file.setFileName(path);
+	if (!_file.open(QIODevice::ReadOnly)) {
+		qWarning() << "DatasetReader: Problem opening" << path << _file.errorString();
+		return false;
+	}
+
+	qint64 fileSize = _file.size();
+	if (fileSize < static_cast<qint64>(sizeof(DatasetFormat::FileHeader))) {
+		qWarning() << "DatasetReader:" << path << "is too small for a dataset container";
+		_file.close();
+		return false;
+	}
+
+	_mapped = _file.map(0, fileSize);
+	if (!_mapped) {
+		qWarning() << "DatasetReader: Could not map" << path << _file.errorString();
+		_file.close();
+		return false;
+	}
+
+	std::memcpy(&_header, _mapped, sizeof(_header));
+
+	QString error;
+	if (!DatasetFormat::isValidHeader(_header) || !verify(&error)) {
+		qWarning() << "DatasetReader:" << path << "is not a valid dataset container" << error;
+		close();
+		return false;
+	}
+
+	_rows = reinterpret_cast<const float*>(_mapped + _header.dataOffset);
+	if (_header.indexOffset != 0) {
+		_index = reinterpret_cast<const DatasetFormat::SequenceEntry*>(_mapped + _header.indexOffset);
+	}
+
+	return true;
+}
+
+void DatasetReader::close()
+{
+	if (_mapped) {
+		_file.unmap(const_cast<uchar*>(_mapped));
+		_mapped = nullptr;
+	}
+
+	_file.close();
+
+	_header = DatasetFormat::FileHeader{};
+	_rows = nullptr;
+	_index = nullptr;
+}
+
+const float* DatasetReader::row(quint64 rowIndex) const
+{
+	if (!_rows || rowIndex >= _header.rowCount) {
+		return nullptr;
+	}
+
+	return _rows + rowIndex * _header.featureCount;
+}
+
+const DatasetFormat::SequenceEntry* DatasetReader::findSequence(int sequenceID) const
+{
+	for (int i = 0; i < sequenceCount(); i++) {
+		if (_index[i].sequenceID == sequenceID) {
+			return &_index[i];
+		}
+	}
+
+	return nullptr;
+}
+
+bool DatasetReader::readStatistics(FeatureStatistics& statistics) const
+{
+	if (!_mapped || _header.statsOffset == 0) {
+		return false;
+	}
+
+	qint64 size = _file.size() - static_cast<qint64>(_header.statsOffset);
+	if (!statistics.fromByteArray(reinterpret_cast<const char*>(_mapped + _header.statsOffset), size)) {
+		return false;
+	}
+
+	return statistics.featureCount() == featureCount() && statistics.count() == rowCount();
+}
+
+bool DatasetReader::verify(QString* error) const
+{
+	auto fail = [error](const QString& message) {
+		if (error) {
+			*error = message;
+		}
+		return false;
+	};
+
+	if (!_mapped) {
+		return fail("not open");
+	}
+
+	quint64 fileSize = static_cast<quint64>(_file.size());
+
+	if (_header.dataOffset < sizeof(DatasetFormat::FileHeader) || _header.dataOffset % sizeof(float) != 0) {
+		return fail("invalid data offset");
+	}
+
+	quint64 dataEnd = _header.dataOffset + _header.rowCount * _header.featureCount * sizeof(float);
+	if (dataEnd > fileSize) {
+		return fail("data block exceeds file size");
+	}
+
+	if (_header.statsOffset != 0 && (_header.statsOffset < dataEnd || _header.statsOffset > fileSize)) {
+		return fail("statistics block exceeds file size");
+	}
+
+	if (_header.indexOffset == 0) {
+		return true;
+	}
+
+	quint64 indexEnd = _header.indexOffset + _header.sequenceCount * sizeof(DatasetFormat::SequenceEntry);
+	if (_header.indexOffset < dataEnd || _header.indexOffset % alignof(DatasetFormat::SequenceEntry) != 0 || indexEnd > fileSize) {
+		return fail("sequence index exceeds file size");
+	}
+
+	const DatasetFormat::SequenceEntry* index = reinterpret_cast<const DatasetFormat::SequenceEntry*>(_mapped + _header.indexOffset);
+
+	quint64 expectedRow = 0;
+	for (quint64 i = 0; i < _header.sequenceCount; i++) {
+		if (index[i].firstRow != expectedRow) {
+			return fail(QString("sequence %1 does not start at row %2").arg(index[i].sequenceID).arg(expectedRow));
+		}
+		expectedRow += index[i].rowCount;
+	}
+
+	if (expectedRow != _header.rowCount) {
+		return fail("sequence index does not cover all rows");
+	}
+
+	return true;
+}
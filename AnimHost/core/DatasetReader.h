@@ -0,0 +1,104 @@
+/*
+ ***************************************************************************************
+
+ *   Copyright (c) 2024 Filmakademie Baden-Wuerttemberg, Animationsinstitut R&D Labs
+ *   https://research.animationsinstitut.de/animhost
+ *   https://github.com/FilmakademieRnd/AnimHost
+ *    
+ *   AnimHost is a development by Filmakademie Baden-Wuerttemberg, Animationsinstitut
+ *   R&D Labs in the scope of the EU funded project MAX-R (101070072).
+ *    
+ *   This program is distributed in the hope that it will be useful, but WITHOUT
+ *   ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ *   FOR A PARTICULAR PURPOSE. See the MIT License for more details.
+ *   You should have received a copy of the MIT License along with this program; 
+ *   if not go to https://opensource.org/licenses/MIT
+
+ ***************************************************************************************
+ */
+
+ 
+#ifndef DATASETREADER_H
+#define DATASETREADER_H
+
+#include "animhostcore_global.h"
+#include "DatasetFormat.h"
+#include "FeatureStatistics.h"
+
+#include <QFile>
+#include <QString>
+
+
+/**
+ * @class DatasetReader
+ * @brief Read-only, memory mapped view of an indexed dataset container written by DatasetWriter.
+ *
+ * The file is mapped as a whole, rows and sequence index are accessed in place without copying.
+ * Pointers returned by the reader are valid until close() is called or the reader is destroyed.
+ */
+class ANIMHOSTCORESHARED_EXPORT DatasetReader
+{
+	QFile _file;
+	const uchar* _mapped = nullptr;
+
+	DatasetFormat::FileHeader _header{};
+	const float* _rows = nullptr;
+	const DatasetFormat::SequenceEntry* _index = nullptr;
+
+public:
+	DatasetReader() = default;
+	~DatasetReader();
+
+	DatasetReader(const DatasetReader&) = delete;
+	DatasetReader& operator=(const DatasetReader&) = delete;
+
+	/**
+	 * @brief Maps the container at path and validates its header.
+	 * @return false if the file can not be mapped or is not a valid container.
+	 */
+	bool open(const QString& path);
+
+	void close();
+
+	bool isOpen() const { return _mapped != nullptr; }
+
+	const DatasetFormat::FileHeader& header() const { return _header; }
+
+	quint64 rowCount() const { return _header.rowCount; }
+	int featureCount() const { return static_cast<int>(_header.featureCount); }
+
+	/**
+	 * @brief Returns a pointer to the first value of all rows, stored row major.
+	 */
+	const float* data() const { return _rows; }
+
+	/**
+	 * @brief Returns a pointer to the features of one row or nullptr if rowIndex is out of range.
+	 */
+	const float* row(quint64 rowIndex) const;
+
+	int sequenceCount() const { return _index ? static_cast<int>(_header.sequenceCount) : 0; }
+
+	const DatasetFormat::SequenceEntry& sequence(int index) const { return _index[index]; }
+
+	/**
+	 * @brief Looks up the index entry of a sequence by its identifier.
+	 * @return nullptr if the sequence is not part of the container.
+	 */
+	const DatasetFormat::SequenceEntry* findSequence(int sequenceID) const;
+
+	/**
+	 * @brief Reads the per feature statistics stored in the container.
+	 * @return false if the container has no complete statistics block.
+	 */
+	bool readStatistics(FeatureStatistics& statistics) const;
+
+	/**
+	 * @brief Checks that all offsets lie inside the file and the sequence index covers the rows consecutively.
+	 *
+	 * @param error Receives a description of the first problem found, may be nullptr.
+	 */
+	bool verify(QString* error = nullptr) const;
+};
+
+#endif // DATASETREADER_H
@@ -0,0 +1,476 @@
+/*
+ ***************************************************************************************
+
+ *   Copyright (c) 2024 Filmakademie Baden-Wuerttemberg, Animationsinstitut R&D Labs
+ *   https://research.animationsinstitut.de/animhost
+ *   https://github.com/FilmakademieRnd/AnimHost
+ *    
+ *   AnimHost is a development by Filmakademie Baden-Wuerttemberg, Animationsinstitut
+ *   R&D Labs in the scope of the EU funded project MAX-R (101070072).
+ *    
+ *   This program is distributed in the hope that it will be useful, but WITHOUT
+ *   ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ *   FOR A PARTICULAR PURPOSE. See the MIT License for more details.
+ *   You should have received a copy of the MIT License along with this program; 
+ *   if not go to https://opensource.org/licenses/MIT
+
+ ***************************************************************************************
+ */
+
+ 
+#include "DatasetWriter.h"
+
+#include <QDebug>
+#include <algorithm>
+#include <cstring>
+
+
+DatasetWriter::DatasetWriter(qint64 bufferSize) : _bufferSize(bufferSize)
+{
+}
+
+DatasetWriter::~DatasetWriter()
+{
+	close();
+}
+
+bool DatasetWriter::open(const QString& inputPath, const QString& outputPath, const QString& sequencesPath, Format format)
+{
+	close();
+
+	_format = format;
+
+	bool success = false;
+	if (_format == Format::Indexed) {
+		// Both containers hold the same rows, the sequence index is restored from the input file
+		success = openIndexed(_input, inputPath, true);
+		success = openIndexed(_output, outputPath, false) && success;
+
+		if (success && _input.rowCount != _output.rowCount) {
+			qWarning() << "DatasetWriter: Row count mismatch between" << inputPath << "and" << outputPath;
+			success = false;
+		}
+	}
+	else {
+		success = openRaw(_input, inputPath);
+		success = openRaw(_output, outputPath) && success;
+	}
+
+	_sequencesFile.setFileName(sequencesPath);
+	QIODevice::OpenMode mode = _sequencesFile.exists() ? QIODevice::Append : QIODevice::WriteOnly;
+	if (!_sequencesFile.open(mode | QIODevice::Text)) {
+		qWarning() << "DatasetWriter: Problem opening" << sequencesPath << _sequencesFile.errorString();
+		success = false;
+	}
+
+	if (!success) {
+		close();
+		return false;
+	}
+
+	_sequencesBuffer.reserve(static_cast<qsizetype>(_bufferSize / 16));
+	_rowsWritten = 0;
+
+	return true;
+}
+
+void DatasetWriter::close()
+{
+	flush();
+
+	for (Channel* channel : { &_input, &_output }) {
+		channel->file.close();
+		// Release buffer memory between batches
+		channel->buffer = std::vector<float>();
+		channel->used = 0;
+		channel->featureCount = 0;
+		channel->labelsHash = 0;
+		channel->rowCount = 0;
+		channel->dataOffset = 0;
+		channel->hasExistingRows = false;
+		channel->hasTrailer = false;
+		channel->existingBytes = 0;
+		channel->statistics.reset(0);
+	}
+
+	_sequencesFile.close();
+	_sequencesBuffer = QByteArray();
+	_sequenceIndex.clear();
+}
+
+bool DatasetWriter::openRaw(Channel& channel, const QString& path)
+{
+	channel.file.setFileName(path);
+
+	QIODevice::OpenMode mode = channel.file.exists() ? QIODevice::Append : QIODevice::WriteOnly;
+	if (!channel.file.open(mode)) {
+		qWarning() << "DatasetWriter: Problem opening" << path << channel.file.errorString();
+		return false;
+	}
+
+	channel.existingBytes = channel.file.size();
+
+	// Continue the statistics of rows written by earlier runs
+	QFile statisticsFile(statisticsPath(path));
+	if (channel.existingBytes > 0 && statisticsFile.open(QIODevice::ReadOnly)) {
+		QByteArray state = statisticsFile.readAll();
+		channel.statistics.fromByteArray(state.constData(), state.size());
+	}
+
+	return true;
+}
+
+bool DatasetWriter::openIndexed(Channel& channel, const QString& path, bool readIndex)
+{
+	channel.file.setFileName(path);
+
+	bool hasContent = channel.file.exists() && channel.file.size() > 0;
+
+	if (!channel.file.open(QIODevice::ReadWrite)) {
+		qWarning() << "DatasetWriter: Problem opening" << path << channel.file.errorString();
+		return false;
+	}
+
+	channel.dataOffset = sizeof(DatasetFormat::FileHeader);
+	channel.rowCount = 0;
+
+	if (!hasContent) {
+		return true;
+	}
+
+	DatasetFormat::FileHeader header;
+	if (channel.file.read(reinterpret_cast<char*>(&header), sizeof(header)) != sizeof(header) || !DatasetFormat::isValidHeader(header)) {
+		qWarning() << "DatasetWriter:" << path << "is not a dataset container of version" << DatasetFormat::Version;
+		channel.file.close();
+		return false;
+	}
+
+	quint64 dataEnd = header.dataOffset + header.rowCount * header.featureCount * sizeof(float);
+	if (dataEnd > static_cast<quint64>(channel.file.size())) {
+		qWarning() << "DatasetWriter:" << path << "is truncated";
+		channel.file.close();
+		return false;
+	}
+
+	channel.featureCount = static_cast<int>(header.featureCount);
+	channel.labelsHash = header.labelsHash;
+	channel.rowCount = header.rowCount;
+	channel.dataOffset = header.dataOffset;
+	channel.hasExistingRows = header.rowCount > 0;
+
+	if (readIndex && header.indexOffset != 0 && header.sequenceCount > 0) {
+		_sequenceIndex.resize(header.sequenceCount);
+		qint64 indexBytes = static_cast<qint64>(header.sequenceCount * sizeof(DatasetFormat::SequenceEntry));
+
+		if (!channel.file.seek(header.indexOffset)
+			|| channel.file.read(reinterpret_cast<char*>(_sequenceIndex.data()), indexBytes) != indexBytes) {
+			qWarning() << "DatasetWriter: Could not read sequence index of" << path;
+			_sequenceIndex.clear();
+		}
+	}
+
+	// Rows of an interrupted export have no index, keep them covered by an anonymous sequence
+	if (readIndex && _sequenceIndex.empty() && header.rowCount > 0) {
+		_sequenceIndex.push_back({ -1, 0, 0, header.rowCount });
+	}
+
+	if (header.statsOffset != 0) {
+		channel.file.seek(header.statsOffset);
+		QByteArray state = channel.file.read(channel.file.size() - header.statsOffset);
+		channel.statistics.fromByteArray(state.constData(), state.size());
+	}
+
+	// Index and statistics are rewritten by flush(), new rows go directly behind the existing ones
+	channel.file.resize(static_cast<qint64>(dataEnd));
+
+	// The old offsets point past the truncated end, keep the file readable until the next flush
+	writeHeader(channel);
+
+	return true;
+}
+
+void DatasetWriter::setFeatureCounts(int inputFeatureCount, int outputFeatureCount)
+{
+	setChannelLayout(_input, inputFeatureCount, 0);
+	setChannelLayout(_output, outputFeatureCount, 0);
+}
+
+bool DatasetWriter::setFeatureLabels(const QStringList& inputLabels, const QStringList& outputLabels)
+{
+	bool success = setChannelLayout(_input, inputLabels.size(), DatasetFormat::hashLabels(inputLabels));
+	success = setChannelLayout(_output, outputLabels.size(), DatasetFormat::hashLabels(outputLabels)) && success;
+	return success;
+}
+
+bool DatasetWriter::setChannelLayout(Channel& channel, int featureCount, quint64 labelsHash)
+{
+	if (channel.hasExistingRows) {
+		bool hashMismatch = labelsHash != 0 && channel.labelsHash != 0 && labelsHash != channel.labelsHash;
+
+		if (featureCount != channel.featureCount || hashMismatch) {
+			qWarning() << "DatasetWriter: Feature layout does not match existing dataset" << channel.file.fileName();
+			return false;
+		}
+	}
+
+	if (featureCount != channel.featureCount) {
+		flushChannel(channel);
+		channel.featureCount = featureCount;
+	}
+
+	if (channel.statistics.featureCount() != featureCount) {
+		channel.statistics.reset(featureCount);
+	}
+
+	if (labelsHash != 0) {
+		channel.labelsHash = labelsHash;
+	}
+
+	return true;
+}
+
+void DatasetWriter::beginSequence(int sequenceID, int firstFrame)
+{
+	quint64 firstRow = inputRowsTotal();
+
+	// A sequence without any rows is replaced instead of being kept as an empty entry
+	if (!_sequenceIndex.empty() && _sequenceIndex.back().firstRow == firstRow) {
+		_sequenceIndex.pop_back();
+	}
+
+	_sequenceIndex.push_back({ sequenceID, firstFrame, firstRow, 0 });
+}
+
+float* DatasetWriter::reserveInputRows(int rowCount)
+{
+	float* rows = reserveRows(_input, rowCount);
+	if (rows) {
+		_rowsWritten += rowCount;
+	}
+	return rows;
+}
+
+float* DatasetWriter::reserveOutputRows(int rowCount)
+{
+	return reserveRows(_output, rowCount);
+}
+
+float* DatasetWriter::reserveRows(Channel& channel, int rowCount)
+{
+	if (!channel.file.isOpen() || channel.featureCount <= 0 || rowCount <= 0) {
+		return nullptr;
+	}
+
+	size_t required = static_cast<size_t>(channel.featureCount) * static_cast<size_t>(rowCount);
+
+	if (channel.buffer.empty()) {
+		channel.buffer.resize(std::max(static_cast<size_t>(_bufferSize) / sizeof(float), required));
+	}
+
+	if (channel.used + required > channel.buffer.size()) {
+		flushChannel(channel);
+
+		// A single request larger than the buffer grows it instead of being split
+		if (required > channel.buffer.size()) {
+			channel.buffer.resize(required);
+		}
+	}
+
+	float* rows = channel.buffer.data() + channel.used;
+	channel.used += required;
+
+	return rows;
+}
+
+void DatasetWriter::writeSequenceEntry(int sequenceID, int frame, const QString& label, const QString& sourceName, const QString& dataSetID)
+{
+	if (!_sequencesFile.isOpen()) {
+		return;
+	}
+
+	_sequencesBuffer.append(QByteArray::number(sequenceID)).append(' ');
+	_sequencesBuffer.append(QByteArray::number(frame)).append(' ');
+	_sequencesBuffer.append(label.toUtf8()).append(' ');
+	_sequencesBuffer.append(sourceName.toUtf8()).append(' ');
+	_sequencesBuffer.append(dataSetID.toUtf8());
+	_sequencesBuffer.append('\n');
+
+	if (_sequencesBuffer.size() >= _bufferSize) {
+		_sequencesFile.write(_sequencesBuffer);
+		_sequencesBuffer.clear();
+	}
+}
+
+void DatasetWriter::flushChannel(Channel& channel)
+{
+	if (channel.used == 0 || !channel.file.isOpen()) {
+		channel.used = 0;
+		return;
+	}
+
+	if (_format == Format::Indexed) {
+		// The new rows overwrite the trailer of the last flush, unlink it from the header first
+		if (channel.hasTrailer) {
+			writeHeader(channel);
+			channel.hasTrailer = false;
+		}
+		channel.file.seek(static_cast<qint64>(channel.dataOffset + channel.rowCount * channel.featureCount * sizeof(float)));
+	}
+
+	quint64 rowCount = channel.used / channel.featureCount;
+	channel.statistics.addRows(channel.buffer.data(), rowCount);
+
+	qint64 byteCount = static_cast<qint64>(channel.used * sizeof(float));
+	qint64 written = channel.file.write(reinterpret_cast<const char*>(channel.buffer.data()), byteCount);
+
+	if (written != byteCount) {
+		qWarning() << "DatasetWriter: Incomplete write to" << channel.file.fileName() << channel.file.errorString();
+	}
+
+	channel.rowCount += rowCount;
+	channel.used = 0;
+
+	if (_format == Format::Indexed) {
+		writeHeader(channel);
+	}
+	else {
+		writeStatisticsFile(channel);
+	}
+}
+
+void DatasetWriter::writeHeader(Channel& channel, quint64 indexOffset, quint64 sequenceCount, quint64 statsOffset)
+{
+	DatasetFormat::FileHeader header{};
+	std::memcpy(header.magic, DatasetFormat::Magic, sizeof(header.magic));
+	header.version = DatasetFormat::Version;
+	header.dataType = DatasetFormat::Float32;
+	header.featureCount = static_cast<quint32>(channel.featureCount);
+	header.labelsHash = channel.labelsHash;
+	header.rowCount = channel.rowCount;
+	header.dataOffset = channel.dataOffset;
+	header.indexOffset = indexOffset;
+	header.sequenceCount = sequenceCount;
+	header.statsOffset = statsOffset;
+
+	channel.file.seek(0);
+	if (channel.file.write(reinterpret_cast<const char*>(&header), sizeof(header)) != sizeof(header)) {
+		qWarning() << "DatasetWriter: Could not write header of" << channel.file.fileName() << channel.file.errorString();
+	}
+}
+
+void DatasetWriter::writeTrailer(Channel& channel)
+{
+	if (!channel.file.isOpen() || channel.featureCount <= 0) {
+		return;
+	}
+
+	// Close the last sequence and drop sequences that did not receive any rows
+	std::vector<DatasetFormat::SequenceEntry> index;
+	index.reserve(_sequenceIndex.size());
+	for (size_t i = 0; i < _sequenceIndex.size(); i++) {
+		DatasetFormat::SequenceEntry entry = _sequenceIndex[i];
+		quint64 endRow = (i + 1 < _sequenceIndex.size()) ? _sequenceIndex[i + 1].firstRow : channel.rowCount;
+		entry.rowCount = endRow - entry.firstRow;
+		if (entry.rowCount > 0) {
+			index.push_back(entry);
+		}
+	}
+
+	quint64 dataEnd = channel.dataOffset + channel.rowCount * channel.featureCount * sizeof(float);
+	quint64 indexOffset = DatasetFormat::alignOffset(dataEnd);
+	qint64 indexBytes = static_cast<qint64>(index.size() * sizeof(DatasetFormat::SequenceEntry));
+
+	QByteArray statistics = channel.statistics.toByteArray();
+	quint64 statsOffset = DatasetFormat::alignOffset(indexOffset + indexBytes);
+
+	// Padding between the blocks is zero filled
+	QByteArray trailer(static_cast<qsizetype>(statsOffset - dataEnd), '\0');
+	trailer.replace(static_cast<qsizetype>(indexOffset - dataEnd), indexBytes, reinterpret_cast<const char*>(index.data()), indexBytes);
+	trailer.append(statistics);
+
+	channel.file.seek(static_cast<qint64>(dataEnd));
+	if (channel.file.write(trailer) != trailer.size()) {
+		qWarning() << "DatasetWriter: Could not write sequence index of" << channel.file.fileName() << channel.file.errorString();
+		writeHeader(channel);
+		channel.hasTrailer = false;
+		return;
+	}
+
+	// Drop what is left of a longer trailer written before
+	channel.file.resize(static_cast<qint64>(dataEnd) + trailer.size());
+
+	bool statisticsComplete = hasCompleteStatistics(channel);
+	writeHeader(channel, index.empty() ? 0 : indexOffset, index.size(), statisticsComplete ? statsOffset : 0);
+	channel.hasTrailer = true;
+	channel.file.flush();
+}
+
+void DatasetWriter::writeStatisticsFile(Channel& channel)
+{
+	QFile file(statisticsPath(channel.file.fileName()));
+	if (!file.open(QIODevice::WriteOnly)) {
+		qWarning() << "DatasetWriter: Problem opening" << file.fileName() << file.errorString();
+		return;
+	}
+
+	file.write(channel.statistics.toByteArray());
+}
+
+bool DatasetWriter::hasCompleteStatistics(const Channel& channel) const
+{
+	if (channel.featureCount <= 0 || channel.statistics.featureCount() != channel.featureCount) {
+		return false;
+	}
+
+	quint64 rowCount = channel.rowCount;
+	if (_format == Format::Raw) {
+		rowCount += static_cast<quint64>(channel.existingBytes) / (channel.featureCount * sizeof(float));
+	}
+
+	return channel.statistics.count() == rowCount;
+}
+
+bool DatasetWriter::writeNormalization(const QString& inputPath, const QString& outputPath)
+{
+	flush();
+
+	for (const Channel* channel : { &_input, &_output }) {
+		if (!hasCompleteStatistics(*channel)) {
+			qWarning() << "DatasetWriter: Statistics do not cover all rows of" << channel->file.fileName()
+				<< "- overwrite the dataset to regenerate the normalization";
+			return false;
+		}
+	}
+
+	bool success = _input.statistics.writeNormalizationFile(inputPath);
+	success = _output.statistics.writeNormalizationFile(outputPath) && success;
+	return success;
+}
+
+quint64 DatasetWriter::inputRowsTotal() const
+{
+	quint64 pendingRows = _input.featureCount > 0 ? _input.used / _input.featureCount : 0;
+	return _input.rowCount + pendingRows;
+}
+
+void DatasetWriter::flush()
+{
+	for (Channel* channel : { &_input, &_output }) {
+		if (channel->file.isOpen()) {
+			flushChannel(*channel);
+			channel->file.flush();
+		}
+	}
+
+	// Complete the containers after every run, they stay open for the next one and may never be closed cleanly
+	if (_format == Format::Indexed) {
+		writeTrailer(_input);
+		writeTrailer(_output);
+	}
+
+	if (_sequencesFile.isOpen() && !_sequencesBuffer.isEmpty()) {
+		_sequencesFile.write(_sequencesBuffer);
+		_sequencesBuffer.clear();
+		_sequencesFile.flush();
+	}
+}
@@ -0,0 +1,209 @@
+/*
+ ***************************************************************************************
+
+ *   Copyright (c) 2024 Filmakademie Baden-Wuerttemberg, Animationsinstitut R&D Labs
+ *   https://research.animationsinstitut.de/animhost
+ *   https://github.com/FilmakademieRnd/AnimHost
+ *    
+ *   AnimHost is a development by Filmakademie Baden-Wuerttemberg, Animationsinstitut
+ *   R&D Labs in the scope of the EU funded project MAX-R (101070072).
+ *    
+ *   This program is distributed in the hope that it will be useful, but WITHOUT
+ *   ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ *   FOR A PARTICULAR PURPOSE. See the MIT License for more details.
+ *   You should have received a copy of the MIT License along with this program; 
+ *   if not go to https://opensource.org/licenses/MIT
+
+ ***************************************************************************************
+ */
+
+ 
+#ifndef DATASETWRITER_H
+#define DATASETWRITER_H
+
+#include "animhostcore_global.h"
+#include "DatasetFormat.h"
+#include "FeatureStatistics.h"
+
+#include <QFile>
+#include <QString>
+#include <QStringList>
+#include <QByteArray>
+#include <vector>
+
+
+/**
+ * @class DatasetWriter
+ * @brief Buffered writer for the binary training datasets produced by the preprocess nodes.
+ *
+ * Keeps the input (X), output (Y) and sequence identifier files open across consecutive runs
+ * and collects rows in large in-memory buffers. Callers reserve space for one or more rows and
+ * write their features directly into the returned memory. Buffers are written to disk with a
+ * single sequential write per file once they are full or when flush() is called.
+ *
+ * In Format::Raw the binary files are headerless float blobs. In Format::Indexed they are
+ * self-describing containers as described in DatasetFormat.h, including a per sequence row index.
+ * Existing files are appended to in both formats.
+ *
+ * Per feature mean and variance of all rows are accumulated while writing. They are kept in the
+ * container (Format::Indexed) or in a small side file next to the raw data (Format::Raw), so appending
+ * runs continue the statistics of the existing rows instead of reading them again.
+ */
+class ANIMHOSTCORESHARED_EXPORT DatasetWriter
+{
+public:
+	static constexpr qint64 DefaultBufferSize = 32 * 1024 * 1024; //!< Default size of each binary buffer in bytes
+
+	enum class Format {
+		Raw,		//!< Headerless float rows
+		Indexed		//!< Versioned container with header and sequence index
+	};
+
+private:
+	//! Binary feature file together with its pending rows
+	struct Channel {
+		QFile file;
+		std::vector<float> buffer; //!< Pending rows
+		size_t used = 0; //!< Number of floats used in the buffer
+		int featureCount = 0;
+		quint64 labelsHash = 0;
+		quint64 rowCount = 0; //!< Rows already written to the file
+		quint64 dataOffset = 0; //!< Byte offset of the first row (Indexed only)
+		bool hasExistingRows = false; //!< File contained rows before it was opened (Indexed only)
+		bool hasTrailer = false; //!< Index and statistics behind the rows are referenced by the header (Indexed only)
+		qint64 existingBytes = 0; //!< Size of the file when it was opened (Raw only)
+		FeatureStatistics statistics; //!< Statistics of all rows in the file, including pending ones once flushed
+	};
+
+	Channel _input;
+	Channel _output;
+
+	QFile _sequencesFile;
+	QByteArray _sequencesBuffer; //!< Pending sequence identifier lines
+
+	Format _format = Format::Raw;
+
+	std::vector<DatasetFormat::SequenceEntry> _sequenceIndex; //!< Sequences of all rows in the files (Indexed only)
+
+	qint64 _bufferSize = DefaultBufferSize;
+
+	qint64 _rowsWritten = 0; //!< Number of rows written since open()
+
+public:
+	DatasetWriter(qint64 bufferSize = DefaultBufferSize);
+	~DatasetWriter();
+
+	DatasetWriter(const DatasetWriter&) = delete;
+	DatasetWriter& operator=(const DatasetWriter&) = delete;
+
+	/**
+	 * @brief Opens the dataset files for appending. Files are created if they do not exist.
+	 *
+	 * @param inputPath Path of the binary input feature file.
+	 * @param outputPath Path of the binary output feature file.
+	 * @param sequencesPath Path of the text file holding one sequence identifier line per row.
+	 * @param format Layout of the binary files.
+	 * @return true if all files could be opened.
+	 */
+	bool open(const QString& inputPath, const QString& outputPath, const QString& sequencesPath, Format format = Format::Raw);
+
+	/**
+	 * @brief Flushes all pending data and closes the files.
+	 */
+	void close();
+
+	bool isOpen() const { return _input.file.isOpen() && _output.file.isOpen() && _sequencesFile.isOpen(); }
+
+	Format format() const { return _format; }
+
+	/**
+	 * @brief Sets the number of float features per input and output row.
+	 *
+	 * Pending rows are flushed if the layout changes.
+	 */
+	void setFeatureCounts(int inputFeatureCount, int outputFeatureCount);
+
+	/**
+	 * @brief Sets the feature layout from the feature labels.
+	 *
+	 * Besides the feature counts this records a hash of the labels in indexed containers.
+	 *
+	 * @return false if an existing indexed container was written with a different layout.
+	 */
+	bool setFeatureLabels(const QStringList& inputLabels, const QStringList& outputLabels);
+
+	int inputFeatureCount() const { return _input.featureCount; }
+	int outputFeatureCount() const { return _output.featureCount; }
+
+	/**
+	 * @brief Starts a new sequence. All following rows belong to it until the next call.
+	 *
+	 * @param sequenceID Identifier of the sequence, as written to the sequences file.
+	 * @param firstFrame Source frame of the first row of the sequence.
+	 */
+	void beginSequence(int sequenceID, int firstFrame);
+
+	/**
+	 * @brief Reserves contiguous space for rowCount input rows.
+	 *
+	 * The returned memory is valid until the next call to any reserve, flush or close function.
+	 *
+	 * @return Pointer to rowCount * inputFeatureCount() floats, or nullptr if the writer is not open.
+	 */
+	float* reserveInputRows(int rowCount = 1);
+
+	/**
+	 * @brief Reserves contiguous space for rowCount output rows.
+	 *
+	 * @see reserveInputRows
+	 */
+	float* reserveOutputRows(int rowCount = 1);
+
+	/**
+	 * @brief Appends one identifier line to the sequences file in the format "<sequenceID> <frame> <label> <sourceName> <dataSetID>".
+	 */
+	void writeSequenceEntry(int sequenceID, int frame, const QString& label, const QString& sourceName, const QString& dataSetID);
+
+	/**
+	 * @brief Writes all pending rows and identifier lines to disk.
+	 *
+	 * Indexed containers additionally get their sequence index and statistics, so they are complete
+	 * after every call. Rows written afterwards replace that trailer and the next flush rewrites it.
+	 */
+	void flush();
+
+	qint64 rowsWritten() const { return _rowsWritten; }
+
+	const FeatureStatistics& inputStatistics() const { return _input.statistics; }
+	const FeatureStatistics& outputStatistics() const { return _output.statistics; }
+
+	/**
+	 * @brief Flushes pending rows and writes the input and output normalization files for all rows in the dataset.
+	 *
+	 * @return false if the statistics do not cover all rows, e.g. because rows were appended by an older version.
+	 */
+	bool writeNormalization(const QString& inputPath, const QString& outputPath);
+
+	/**
+	 * @brief Path of the side file holding the statistics of a raw dataset file.
+	 */
+	static QString statisticsPath(const QString& dataPath) { return dataPath + ".stats"; }
+
+private:
+	bool openRaw(Channel& channel, const QString& path);
+	bool openIndexed(Channel& channel, const QString& path, bool readIndex);
+	bool setChannelLayout(Channel& channel, int featureCount, quint64 labelsHash);
+
+	float* reserveRows(Channel& channel, int rowCount);
+	void flushChannel(Channel& channel);
+
+	void writeHeader(Channel& channel, quint64 indexOffset = 0, quint64 sequenceCount = 0, quint64 statsOffset = 0);
+	void writeTrailer(Channel& channel);
+	void writeStatisticsFile(Channel& channel);
+
+	bool hasCompleteStatistics(const Channel& channel) const;
+
+	quint64 inputRowsTotal() const;
+};
+
+#endif // DATASETWRITER_H
@@ -0,0 +1,255 @@
+/*
+ ***************************************************************************************
+
+ *   Copyright (c) 2024 Filmakademie Baden-Wuerttemberg, Animationsinstitut R&D Labs
+ *   https://research.animationsinstitut.de/animhost
+ *   https://github.com/FilmakademieRnd/AnimHost
+ *    
+ *   AnimHost is a development by Filmakademie Baden-Wuerttemberg, Animationsinstitut
+ *   R&D Labs in the scope of the EU funded project MAX-R (101070072).
+ *    
+ *   This program is distributed in the hope that it will be useful, but WITHOUT
+ *   ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ *   FOR A PARTICULAR PURPOSE. See the MIT License for more details.
+ *   You should have received a copy of the MIT License along with this program; 
+ *   if not go to https://opensource.org/licenses/MIT
+
+ ***************************************************************************************
+ */
+
+ 
+#include "FeatureExtraction.h"
+#include "FrameRange.h"
+#include "animhosthelper.h"
+
+
+std::vector<glm::quat> FeatureExtraction::ComputeRootRotations(const PoseSequence& poses, int rearRightIdx, int rearLeftIdx, int frontRightIdx, int frontLeftIdx)
+{
+	std::vector<glm::quat> rootRotations(poses.mPoseSequence.size());
+
+	for (size_t frame = 0; frame < poses.mPoseSequence.size(); frame++) {
+		const glm::vec3* positions = poses.mPoseSequence.frameData(frame);
+
+		glm::vec3 rearVector = positions[rearRightIdx] - positions[rearLeftIdx];
+		rearVector = glm::normalize(AnimHostHelper::ProjectPointOnGroundPlane(rearVector));
+
+		glm::vec3 frontVector = positions[frontRightIdx] - positions[frontLeftIdx];
+		frontVector = glm::normalize(AnimHostHelper::ProjectPointOnGroundPlane(frontVector));
+
+		glm::vec3 forward = glm::normalize(rearVector + frontVector);
+		forward = glm::cross(glm::vec3(0.0, 1.0, 0.0), forward);
+		forward = glm::normalize(AnimHostHelper::ProjectPointOnGroundPlane(forward));
+
+		rootRotations[frame] = glm::rotation(glm::vec3(0.0f, 0.0f, 1.0f), forward);
+	}
+
+	return rootRotations;
+}
+
+std::vector<glm::mat4> FeatureExtraction::ComputeRootTransforms(const PoseSequence& poses, const std::vector<glm::quat>& rootRotations, int rootBoneIdx)
+{
+	std::vector<glm::mat4> rootTransforms(poses.mPoseSequence.size());
+
+	for (size_t frame = 0; frame < poses.mPoseSequence.size(); frame++) {
+		const glm::vec3& rootPos = poses.mPoseSequence[frame][rootBoneIdx];
+		glm::vec3 pos = glm::vec3(rootPos.x, 0.f, rootPos.z);
+
+		rootTransforms[frame] = glm::translate(glm::mat4(1.0f), pos) * glm::toMat4(rootRotations[frame]);
+	}
+
+	return rootTransforms;
+}
+
+void FeatureExtraction::ExtractFrame(const FeatureSchema& schema, const SequenceData& sequence, int frame, float* inputRow, float* outputRow)
+{
+	const std::vector<glm::mat4>& rootTransforms = sequence.rootTransforms;
+
+	const glm::mat4& rootTransform = rootTransforms[frame];
+	const glm::mat4& nextRootTransform = rootTransforms[frame + 1];
+
+	RootSpace root(rootTransform);
+	RootSpace nextRoot(nextRootTransform);
+
+	// Joint rotations of the current frame are used for input and output, so forward kinematics runs once
+	std::vector<glm::mat4> globalTransforms;
+	AnimHostHelper::ForwardKinematics(sequence.skeleton, sequence.animation, globalTransforms, frame);
+
+	std::vector<glm::vec3> rotationAxes;
+	JointRotationAxes(globalTransforms, rotationAxes);
+
+	const glm::vec3* positions = sequence.poses.mPoseSequence.frameData(frame);
+	const glm::vec3* nextPositions = sequence.poses.mPoseSequence.frameData(frame + 1);
+	const glm::vec3* velocities = sequence.velocities.mJointVelocitySequence.frameData(frame);
+
+	// ==============================
+	// INPUT SECTION
+	// ==============================
+
+	// Trajectory window is centered on the next frame for input and output
+	inputRow = WriteTrajectory(inputRow, schema, rootTransforms, frame + 1, 0, root);
+	WriteJointFeatures(inputRow, schema.numJoints, positions, rotationAxes.data(), velocities, root);
+
+	// ==============================
+	// OUTPUT SECTION
+	// ==============================
+
+	// Root delta update
+	glm::vec2 deltaForward = root.ForwardTo(nextRootTransform);
+	glm::vec2 deltaPos = root.PositionTo(nextRootTransform);
+
+	outputRow[0] = deltaPos.x;
+	outputRow[1] = deltaPos.y;
+	outputRow[2] = glm::orientedAngle({ 0.0, 1.0f }, deltaForward);
+	outputRow += FeatureSchema::RootDeltaSize;
+
+	outputRow = WriteTrajectory(outputRow, schema, rootTransforms, frame + 1, schema.pivotSampleIndex, nextRoot);
+	WriteJointFeatures(outputRow, schema.numJoints, nextPositions, rotationAxes.data(), velocities, nextRoot);
+}
+
+float* FeatureExtraction::WriteTrajectory(float* dst, const FeatureSchema& schema, const std::vector<glm::mat4>& rootTransforms, int centerFrame, int startSample, const RootSpace& root)
+{
+	const int lastFrame = static_cast<int>(rootTransforms.size()) - 1;
+
+	FrameRange frameRange(schema.numSamples, schema.sampleRate, centerFrame, startSample);
+
+	for (int frameIdx : frameRange) {
+		const glm::mat4& frameRoot = rootTransforms[glm::min(lastFrame, frameIdx)];
+		const glm::mat4& prevFrameRoot = rootTransforms[glm::max(0, glm::min(lastFrame, frameIdx - 1))];
+
+		glm::vec2 relativePos = root.PositionTo(frameRoot);
+		glm::vec2 relativeForward = root.ForwardTo(frameRoot);
+
+		glm::vec3 v = glm::vec3(frameRoot[3] - prevFrameRoot[3]) / (1.f / 60.f); // Velocity Unit: cm/s
+		glm::vec3 relativeVelocity = root.VelocityTo(v);
+		glm::vec2 velocity = glm::vec2(relativeVelocity.x, relativeVelocity.z) / 100.f; // Velocity Unit: m/s
+
+		dst[0] = relativePos.x;
+		dst[1] = relativePos.y;
+		dst[2] = relativeForward.x;
+		dst[3] = relativeForward.y;
+		dst[4] = velocity.x;
+		dst[5] = velocity.y;
+		dst[6] = glm::length(velocity);
+
+		dst += FeatureSchema::TrajectorySampleSize;
+	}
+
+	return dst;
+}
+
+float* FeatureExtraction::WriteJointFeatures(float* dst, int numJoints, const glm::vec3* positions, const glm::vec3* rotationAxes, const glm::vec3* velocities, const RootSpace& root)
+{
+	for (int i = 0; i < numJoints; i++) {
+		glm::vec3 position = root.PositionTo(positions[i]);
+		glm::vec3 axis1 = root.DirectionTo(rotationAxes[2 * i]);
+		glm::vec3 axis2 = root.DirectionTo(rotationAxes[2 * i + 1]);
+		glm::vec3 velocity = root.VelocityTo(velocities[i]);
+
+		dst[0] = position.x;
+		dst[1] = position.y;
+		dst[2] = position.z;
+
+		dst[3] = axis1.x;
+		dst[4] = axis1.y;
+		dst[5] = axis1.z;
+		dst[6] = axis2.x;
+		dst[7] = axis2.y;
+		dst[8] = axis2.z;
+
+		dst[9] = velocity.x;
+		dst[10] = velocity.y;
+		dst[11] = velocity.z;
+
+		dst += FeatureSchema::JointFeatureSize;
+	}
+
+	return dst;
+}
+
+void FeatureExtraction::JointRotationAxes(const std::vector<glm::mat4>& globalTransforms, std::vector<glm::vec3>& outAxes)
+{
+	outAxes.resize(2 * globalTransforms.size());
+
+	for (size_t i = 0; i < globalTransforms.size(); i++) {
+		glm::mat3 rotMat = glm::toMat3(MathUtils::DecomposeRotation(globalTransforms[i]));
+
+		outAxes[2 * i] = glm::normalize(rotMat[0]);
+		outAxes[2 * i + 1] = glm::normalize(rotMat[1]);
+	}
+}
+
+QStringList FeatureExtraction::InputFeatureLabels(const FeatureSchema& schema, const Skeleton& skeleton)
+{
+	QStringList labels;
+	labels.reserve(schema.inputFeatureCount());
+
+	for (int i = 0; i < schema.numSamples; i++) {
+		labels << "root_pos_x_" + QString::number(i);
+		labels << "root_pos_y_" + QString::number(i);
+		labels << "root_fwd_x_" + QString::number(i);
+		labels << "root_fwd_y_" + QString::number(i);
+		labels << "root_vel_x_" + QString::number(i);
+		labels << "root_vel_y_" + QString::number(i);
+		labels << "root_speed_" + QString::number(i);
+	}
+
+	for (int i = 0; i < schema.numJoints; i++) {
+		QString boneName = QString::fromStdString(skeleton.bone_names_reverse.at(i));
+		labels << "jpos_x_" + boneName;
+		labels << "jpos_y_" + boneName;
+		labels << "jpos_z_" + boneName;
+
+		labels << "jrot_0_" + boneName;
+		labels << "jrot_1_" + boneName;
+		labels << "jrot_2_" + boneName;
+		labels << "jrot_3_" + boneName;
+		labels << "jrot_4_" + boneName;
+		labels << "jrot_5_" + boneName;
+
+		labels << "jvel_x_" + boneName;
+		labels << "jvel_y_" + boneName;
+		labels << "jvel_z_" + boneName;
+	}
+
+	return labels;
+}
+
+QStringList FeatureExtraction::OutputFeatureLabels(const FeatureSchema& schema, const Skeleton& skeleton)
+{
+	QStringList labels;
+	labels.reserve(schema.outputFeatureCount());
+
+	labels << "delta_x";
+	labels << "delta_y";
+	labels << "delta_angle";
+
+	for (int i = schema.pivotSampleIndex; i < schema.numSamples; i++) {
+		labels << "out_root_pos_x_" + QString::number(i);
+		labels << "out_root_pos_y_" + QString::number(i);
+		labels << "out_root_fwd_x_" + QString::number(i);
+		labels << "out_root_fwd_y_" + QString::number(i);
+		labels << "out_root_vel_x_" + QString::number(i);
+		labels << "out_root_vel_y_" + QString::number(i);
+		labels << "out_root_speed_" + QString::number(i);
+	}
+
+	for (int i = 0; i < schema.numJoints; i++) {
+		QString boneName = QString::fromStdString(skeleton.bone_names_reverse.at(i));
+		labels << "out_jpos_x_" + boneName;
+		labels << "out_jpos_y_" + boneName;
+		labels << "out_jpos_z_" + boneName;
+
+		labels << "out_jrot_0_" + boneName;
+		labels << "out_jrot_1_" + boneName;
+		labels << "out_jrot_2_" + boneName;
+		labels << "out_jrot_3_" + boneName;
+		labels << "out_jrot_4_" + boneName;
+		labels << "out_jrot_5_" + boneName;
+
+		labels << "out_jvel_x_" + boneName;
+		labels << "out_jvel_y_" + boneName;
+		labels << "out_jvel_z_" + boneName;
+	}
+
+	return labels;
+}
@@ -0,0 +1,127 @@
+/*
+ ***************************************************************************************
+
+ *   Copyright (c) 2024 Filmakademie Baden-Wuerttemberg, Animationsinstitut R&D Labs
+ *   https://research.animationsinstitut.de/animhost
+ *   https://github.com/FilmakademieRnd/AnimHost
+ *    
+ *   AnimHost is a development by Filmakademie Baden-Wuerttemberg, Animationsinstitut
+ *   R&D Labs in the scope of the EU funded project MAX-R (101070072).
+ *    
+ *   This program is distributed in the hope that it will be useful, but WITHOUT
+ *   ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ *   FOR A PARTICULAR PURPOSE. See the MIT License for more details.
+ *   You should have received a copy of the MIT License along with this program; 
+ *   if not go to https://opensource.org/licenses/MIT
+
+ ***************************************************************************************
+ */
+
+ 
+#ifndef FEATUREEXTRACTION_H
+#define FEATUREEXTRACTION_H
+
+#include "animhostcore_global.h"
+#include "commondatatypes.h"
+#include "MathUtils.h"
+
+#include <QStringList>
+#include <vector>
+
+
+/**
+ * @struct FeatureSchema
+ *
+ * @brief Layout of the locomotion feature rows shared by the preprocess nodes and the runtime controller.
+ *
+ * Input row:  numSamples trajectory samples, then one joint feature block per joint.
+ * Output row: root delta, the trajectory samples from pivotSampleIndex on, then one joint feature block per joint.
+ *
+ * A trajectory sample is [pos_x, pos_y, fwd_x, fwd_y, vel_x, vel_y, speed],
+ * a joint feature block is [pos xyz, 6D rotation, velocity xyz], the root delta is [delta_x, delta_y, delta_angle].
+ */
+struct FeatureSchema {
+
+	static constexpr int TrajectorySampleSize = 7;
+	static constexpr int JointFeatureSize = 12;
+	static constexpr int RootDeltaSize = 3;
+
+	int numSamples = 13; //!< Trajectory samples (-60:+60 frames, every 10 frames -> 13 samples)
+	int pivotSampleIndex = 7; //!< First trajectory sample written to the output row
+	int sampleRate = 60; //!< Frame rate the trajectory window is defined for
+	int numJoints = 0;
+
+	int outputSamples() const { return numSamples - pivotSampleIndex; }
+
+	int inputFeatureCount() const { return numSamples * TrajectorySampleSize + numJoints * JointFeatureSize; }
+	int outputFeatureCount() const { return RootDeltaSize + outputSamples() * TrajectorySampleSize + numJoints * JointFeatureSize; }
+};
+
+
+/**
+ * @class FeatureExtraction
+ *
+ * @brief Computes the locomotion training features of an animation sequence.
+ *
+ * All functions write into caller owned memory and transform relative to a RootSpace,
+ * so the root of a frame is inverted once instead of once per value.
+ */
+class ANIMHOSTCORESHARED_EXPORT FeatureExtraction {
+
+public:
+
+	/**
+	 * @brief Read-only inputs of a sequence. rootTransforms holds the character root transform of every frame.
+	 */
+	struct SequenceData {
+		const PoseSequence& poses;
+		const Animation& animation;
+		const JointVelocitySequence& velocities;
+		const Skeleton& skeleton;
+		const std::vector<glm::mat4>& rootTransforms;
+	};
+
+	/**
+	 * @brief Character facing per frame, perpendicular to the averaged rear (e.g. hips) and front (e.g. shoulders) axes.
+	 */
+	static std::vector<glm::quat> ComputeRootRotations(const PoseSequence& poses, int rearRightIdx, int rearLeftIdx, int frontRightIdx, int frontLeftIdx);
+
+	/**
+	 * @brief Root transform per frame, the root bone position projected to the ground plane with the given rotation.
+	 */
+	static std::vector<glm::mat4> ComputeRootTransforms(const PoseSequence& poses, const std::vector<glm::quat>& rootRotations, int rootBoneIdx);
+
+	/**
+	 * @brief Writes the input and output feature rows of one frame.
+	 *
+	 * Reads frame and frame + 1 of the sequence. Thread safe for concurrent calls with different rows.
+	 *
+	 * @param inputRow Destination of schema.inputFeatureCount() floats.
+	 * @param outputRow Destination of schema.outputFeatureCount() floats.
+	 */
+	static void ExtractFrame(const FeatureSchema& schema, const SequenceData& sequence, int frame, float* inputRow, float* outputRow);
+
+	/**
+	 * @brief Writes the trajectory samples [startSample, schema.numSamples) around centerFrame relative to root.
+	 * @return Pointer past the last written float.
+	 */
+	static float* WriteTrajectory(float* dst, const FeatureSchema& schema, const std::vector<glm::mat4>& rootTransforms, int centerFrame, int startSample, const RootSpace& root);
+
+	/**
+	 * @brief Writes position, 6D rotation and velocity of every joint interleaved into dst.
+	 *
+	 * @param rotationAxes First two normalized rotation axes per joint in world space, see JointRotationAxes().
+	 * @return Pointer past the last written float.
+	 */
+	static float* WriteJointFeatures(float* dst, int numJoints, const glm::vec3* positions, const glm::vec3* rotationAxes, const glm::vec3* velocities, const RootSpace& root);
+
+	/**
+	 * @brief First two columns of the rotation of every global joint transform, two entries per joint.
+	 */
+	static void JointRotationAxes(const std::vector<glm::mat4>& globalTransforms, std::vector<glm::vec3>& outAxes);
+
+	static QStringList InputFeatureLabels(const FeatureSchema& schema, const Skeleton& skeleton);
+	static QStringList OutputFeatureLabels(const FeatureSchema& schema, const Skeleton& skeleton);
+};
+
+#endif // FEATUREEXTRACTION_H
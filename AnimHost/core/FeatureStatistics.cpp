@@ -0,0 +1,169 @@
+/*
+ ***************************************************************************************
+
+ *   Copyright (c) 2024 Filmakademie Baden-Wuerttemberg, Animationsinstitut R&D Labs
+ *   https://research.animationsinstitut.de/animhost
+ *   https://github.com/FilmakademieRnd/AnimHost
+ *    
+ *   AnimHost is a development by Filmakademie Baden-Wuerttemberg, Animationsinstitut
+ *   R&D Labs in the scope of the EU funded project MAX-R (101070072).
+ *    
+ *   This program is distributed in the hope that it will be useful, but WITHOUT
+ *   ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ *   FOR A PARTICULAR PURPOSE. See the MIT License for more details.
+ *   You should have received a copy of the MIT License along with this program; 
+ *   if not go to https://opensource.org/licenses/MIT
+
+ ***************************************************************************************
+ */
+
+ 
+#include "FeatureStatistics.h"
+
+#include <QFile>
+#include <QDebug>
+#include <cmath>
+#include <cstring>
+
+
+void FeatureStatistics::reset(int featureCount)
+{
+	_count = 0;
+	_mean.assign(featureCount, 0.0);
+	_m2.assign(featureCount, 0.0);
+}
+
+void FeatureStatistics::addRows(const float* rows, quint64 rowCount)
+{
+	const size_t featureCount = _mean.size();
+	double* mean = _mean.data();
+	double* m2 = _m2.data();
+
+	for (quint64 r = 0; r < rowCount; r++) {
+		const float* row = rows + r * featureCount;
+
+		_count++;
+		const double invCount = 1.0 / static_cast<double>(_count);
+
+		for (size_t i = 0; i < featureCount; i++) {
+			const double value = row[i];
+			const double delta = value - mean[i];
+			mean[i] += delta * invCount;
+			m2[i] += delta * (value - mean[i]);
+		}
+	}
+}
+
+bool FeatureStatistics::merge(const FeatureStatistics& other)
+{
+	if (other.featureCount() != featureCount()) {
+		qWarning() << "FeatureStatistics: Cannot merge" << other.featureCount() << "features into" << featureCount();
+		return false;
+	}
+
+	if (other._count == 0) {
+		return true;
+	}
+
+	if (_count == 0) {
+		*this = other;
+		return true;
+	}
+
+	// Parallel variance update (Chan et al.)
+	const double countA = static_cast<double>(_count);
+	const double countB = static_cast<double>(other._count);
+	const double total = countA + countB;
+
+	for (size_t i = 0; i < _mean.size(); i++) {
+		const double delta = other._mean[i] - _mean[i];
+		_mean[i] += delta * countB / total;
+		_m2[i] += other._m2[i] + delta * delta * countA * countB / total;
+	}
+
+	_count += other._count;
+
+	return true;
+}
+
+double FeatureStatistics::standardDeviation(int feature) const
+{
+	return std::sqrt(variance(feature));
+}
+
+bool FeatureStatistics::writeNormalizationFile(const QString& path) const
+{
+	QFile file(path);
+	if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+		qWarning() << "FeatureStatistics: Problem opening" << path << file.errorString();
+		return false;
+	}
+
+	QByteArray meanLine;
+	QByteArray stdLine;
+	meanLine.reserve(featureCount() * 16);
+	stdLine.reserve(featureCount() * 16);
+
+	for (int i = 0; i < featureCount(); i++) {
+		// Values are stored as float by the training side, 9 significant digits round trip exactly
+		float stdDev = static_cast<float>(standardDeviation(i));
+		if (stdDev == 0.0f) {
+			stdDev = 1.0f;
+		}
+
+		if (i > 0) {
+			meanLine.append(' ');
+			stdLine.append(' ');
+		}
+		meanLine.append(QByteArray::number(static_cast<float>(_mean[i]), 'g', 9));
+		stdLine.append(QByteArray::number(stdDev, 'g', 9));
+	}
+
+	file.write(meanLine.append('\n'));
+	file.write(stdLine.append('\n'));
+
+	return true;
+}
+
+QByteArray FeatureStatistics::toByteArray() const
+{
+	const quint64 featureCount = _mean.size();
+	const qsizetype valueBytes = static_cast<qsizetype>(featureCount * sizeof(double));
+
+	QByteArray data;
+	data.resize(2 * sizeof(quint64) + 2 * valueBytes);
+
+	char* dst = data.data();
+	std::memcpy(dst, &_count, sizeof(quint64));
+	std::memcpy(dst + sizeof(quint64), &featureCount, sizeof(quint64));
+	std::memcpy(dst + 2 * sizeof(quint64), _mean.data(), valueBytes);
+	std::memcpy(dst + 2 * sizeof(quint64) + valueBytes, _m2.data(), valueBytes);
+
+	return data;
+}
+
+bool FeatureStatistics::fromByteArray(const char* data, qint64 size)
+{
+	reset(0);
+
+	if (size < static_cast<qint64>(2 * sizeof(quint64))) {
+		return false;
+	}
+
+	quint64 count = 0;
+	quint64 featureCount = 0;
+	std::memcpy(&count, data, sizeof(quint64));
+	std::memcpy(&featureCount, data + sizeof(quint64), sizeof(quint64));
+
+	const qint64 valueBytes = static_cast<qint64>(featureCount * sizeof(double));
+	if (size < static_cast<qint64>(2 * sizeof(quint64)) + 2 * valueBytes) {
+		return false;
+	}
+
+	reset(static_cast<int>(featureCount));
+	_count = count;
+	std::memcpy(_mean.data(), data + 2 * sizeof(quint64), valueBytes);
+	std::memcpy(_m2.data(), data + 2 * sizeof(quint64) + valueBytes, valueBytes);
+
+	return true;
+}
@@ -0,0 +1,98 @@
+/*
+ ***************************************************************************************
+
+ *   Copyright (c) 2024 Filmakademie Baden-Wuerttemberg, Animationsinstitut R&D Labs
+ *   https://research.animationsinstitut.de/animhost
+ *   https://github.com/FilmakademieRnd/AnimHost
+ *    
+ *   AnimHost is a development by Filmakademie Baden-Wuerttemberg, Animationsinstitut
+ *   R&D Labs in the scope of the EU funded project MAX-R (101070072).
+ *    
+ *   This program is distributed in the hope that it will be useful, but WITHOUT
+ *   ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ *   FOR A PARTICULAR PURPOSE. See the MIT License for more details.
+ *   You should have received a copy of the MIT License along with this program; 
+ *   if not go to https://opensource.org/licenses/MIT
+
+ ***************************************************************************************
+ */
+
+ 
+#ifndef FEATURESTATISTICS_H
+#define FEATURESTATISTICS_H
+
+#include "animhostcore_global.h"
+
+#include <QByteArray>
+#include <QString>
+#include <QtGlobal>
+#include <vector>
+
+
+/**
+ * @class FeatureStatistics
+ * @brief Running per feature mean and variance of a stream of feature rows.
+ *
+ * Uses Welford's algorithm with double accumulators, so the result stays accurate over millions of rows.
+ * Partial statistics, e.g. of parallel workers or of earlier export runs, can be combined with merge().
+ */
+class ANIMHOSTCORESHARED_EXPORT FeatureStatistics
+{
+	quint64 _count = 0;
+	std::vector<double> _mean;
+	std::vector<double> _m2; //!< Sum of squared differences from the mean
+
+public:
+	FeatureStatistics(int featureCount = 0) { reset(featureCount); }
+
+	/**
+	 * @brief Clears all accumulated rows and sets the number of features per row.
+	 */
+	void reset(int featureCount);
+
+	int featureCount() const { return static_cast<int>(_mean.size()); }
+	quint64 count() const { return _count; }
+
+	/**
+	 * @brief Adds rowCount consecutive rows of featureCount() values each.
+	 */
+	void addRows(const float* rows, quint64 rowCount);
+
+	void addRow(const float* row) { addRows(row, 1); }
+
+	/**
+	 * @brief Combines the statistics of another set of rows with the same feature layout into this one.
+	 * @return false if the feature counts differ.
+	 */
+	bool merge(const FeatureStatistics& other);
+
+	double mean(int feature) const { return _mean[feature]; }
+
+	/**
+	 * @brief Sample variance (divided by count - 1) of a feature.
+	 */
+	double variance(int feature) const { return _count > 1 ? _m2[feature] / static_cast<double>(_count - 1) : 0.0; }
+
+	double standardDeviation(int feature) const;
+
+	/**
+	 * @brief Writes the normalization file read by the training scripts.
+	 *
+	 * The file holds two space separated lines, the means and the standard deviations of all features.
+	 * A standard deviation of 0 is written as 1, so constant features are left unscaled.
+	 */
+	bool writeNormalizationFile(const QString& path) const;
+
+	/**
+	 * @brief Serializes the accumulator state as [count][featureCount][mean x featureCount][m2 x featureCount].
+	 */
+	QByteArray toByteArray() const;
+
+	/**
+	 * @brief Restores a state written by toByteArray().
+	 * @return false if data is not a valid state, the statistics are left empty in that case.
+	 */
+	bool fromByteArray(const char* data, qint64 size);
+};
+
+#endif // FEATURESTATISTICS_H
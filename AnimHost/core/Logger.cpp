@@ -23,9 +23,273 @@
 #include <QDateTime>
 #include <QDir>
 #include <QFile>
+#include <QFileInfo>
 #include <QHash>
 #include <QObject>
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+
+/**
+ * @class LogQueue
+ * @brief Bounded multi-producer single-consumer ring buffer of log messages together with its writer thread.
+ *
+ * Every slot carries a sequence number. A producer claims a position with a compare-exchange on the enqueue
+ * counter, copies the message into the slot and publishes it by advancing the slot's sequence. The writer
+ * consumes the slots in order and hands them back by advancing the sequence by one lap. Producers never lock.
+ *
+ * The file, function and category strings of the message context are copied into the slot, as the module they
+ * belong to may be unloaded before the writer formats the message. The copies reuse the capacity of the slot,
+ * so once the strings of a slot have grown to fit, queuing a message does not allocate for them.
+ */
+class LogQueue
+{
+public:
+	static constexpr size_t maxBatchSize = 256; //!< Messages formatted per file write
+	static constexpr std::chrono::milliseconds idleTimeout{ 10 }; //!< Upper bound of the latency of a missed wake up
+
+	static thread_local bool onWriterThread;
+
+private:
+	struct Entry {
+		std::atomic<size_t> sequence;
+		QtMsgType type;
+		int line;
+		QByteArray file;
+		QByteArray function;
+		QByteArray category;
+		qint64 timestamp;
+		QString message;
+	};
+
+	std::unique_ptr<Entry[]> _entries;
+	size_t _mask;
+	Logger::OverflowPolicy _policy;
+
+	alignas(64) std::atomic<size_t> _enqueuePos{ 0 };
+	alignas(64) size_t _dequeuePos = 0; //!< Only touched by the writer thread
+	std::atomic<size_t> _written{ 0 }; //!< Number of messages written so far
+	std::atomic<size_t> _dropped{ 0 };
+
+	std::atomic<bool> _running{ true };
+	std::atomic<bool> _writerIdle{ false };
+	std::mutex _wakeMutex;
+	std::condition_variable _wake;
+	std::thread _thread;
+
+	std::atomic<int> _waiting{ 0 }; //!< Threads blocked in waitWritten()
+	std::mutex _writtenMutex;
+	std::condition_variable _writtenChanged;
+
+	//! Copies a context string, keeping the capacity of dst
+	static void copyContextString(QByteArray& dst, const char* src) {
+		dst.resize(0);
+		if (src) {
+			dst.append(src);
+		}
+	}
+
+	static const char* contextString(const QByteArray& str) {
+		return str.isEmpty() ? nullptr : str.constData();
+	}
+
+	bool hasEntry() const {
+		return _entries[_dequeuePos & _mask].sequence.load(std::memory_order_acquire) == _dequeuePos + 1;
+	}
+
+	void wakeWriter() {
+		if (_writerIdle.load(std::memory_order_relaxed)) {
+			_wake.notify_one();
+		}
+	}
+
+	void run();
+
+public:
+	LogQueue(Logger::OverflowPolicy policy, int capacity) : _policy(policy) {
+		size_t size = 1;
+		while (size < static_cast<size_t>(std::max(capacity, 2))) {
+			size <<= 1;
+		}
+
+		_entries = std::make_unique<Entry[]>(size);
+		_mask = size - 1;
+		for (size_t i = 0; i < size; i++) {
+			_entries[i].sequence.store(i, std::memory_order_relaxed);
+		}
+
+		_thread = std::thread(&LogQueue::run, this);
+	}
+
+	~LogQueue() {
+		stop();
+	}
+
+	/**
+	 * @brief Copies the message into the next free slot.
+	 *
+	 * @param block Wait for a free slot even if the overflow policy drops messages
+	 * @param ticket Set to the number of messages that have to be written for this one to be on disk
+	 * @return False if the message was dropped
+	 */
+	bool push(QtMsgType type, const QMessageLogContext& context, const QString& msg, bool block, size_t& ticket) {
+		qint64 timestamp = QDateTime::currentMSecsSinceEpoch();
+		block = block || _policy == Logger::OverflowPolicy::Block;
+
+		Entry* entry = nullptr;
+		size_t pos = _enqueuePos.load(std::memory_order_relaxed);
+
+		for (;;) {
+			entry = &_entries[pos & _mask];
+			size_t sequence = entry->sequence.load(std::memory_order_acquire);
+			std::ptrdiff_t diff = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(pos);
+
+			if (diff == 0) {
+				if (_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+					break;
+				}
+			}
+			else if (diff < 0) {
+				// Full, the writer has not released this slot from the previous lap yet
+				if (!block) {
+					_dropped.fetch_add(1, std::memory_order_relaxed);
+					return false;
+				}
+				wakeWriter();
+				std::this_thread::yield();
+				pos = _enqueuePos.load(std::memory_order_relaxed);
+			}
+			else {
+				pos = _enqueuePos.load(std::memory_order_relaxed);
+			}
+		}
+
+		entry->type = type;
+		entry->line = context.line;
+		copyContextString(entry->file, context.file);
+		copyContextString(entry->function, context.function);
+		copyContextString(entry->category, context.category);
+		entry->timestamp = timestamp;
+		entry->message = msg;
+		entry->sequence.store(pos + 1, std::memory_order_release);
+
+		ticket = pos + 1;
+		wakeWriter();
+		return true;
+	}
+
+	//! Blocks until at least \c ticket messages are written
+	void waitWritten(size_t ticket) {
+		if (_written.load(std::memory_order_acquire) >= ticket) {
+			return;
+		}
+
+		std::unique_lock<std::mutex> lock(_writtenMutex);
+		_waiting.fetch_add(1);
+		_wake.notify_one();
+		_writtenChanged.wait(lock, [this, ticket]() { return _written.load() >= ticket || !_running.load(); });
+		_waiting.fetch_sub(1);
+	}
+
+	//! Wakes the threads in waitWritten(). Runs on the writer thread
+	void notifyWritten() {
+		if (_waiting.load() > 0) {
+			std::lock_guard<std::mutex> lock(_writtenMutex);
+			_writtenChanged.notify_all();
+		}
+	}
+
+	void flush() {
+		waitWritten(_enqueuePos.load(std::memory_order_acquire));
+	}
+
+	//! Writes the remaining messages and joins the writer thread
+	void stop() {
+		if (_thread.joinable()) {
+			_running.store(false);
+			{
+				std::lock_guard<std::mutex> lock(_wakeMutex);
+			}
+			_wake.notify_one();
+			_thread.join();
+
+			std::lock_guard<std::mutex> lock(_writtenMutex);
+			_writtenChanged.notify_all();
+		}
+	}
+};
+
+thread_local bool LogQueue::onWriterThread = false;
+
+void LogQueue::run()
+{
+	onWriterThread = true;
+	QByteArray fileBuffer;
+
+	for (;;) {
+		size_t count = 0;
+		qint64 batchSecond = -1;
+
+		while (count < maxBatchSize && hasEntry()) {
+			Entry& entry = _entries[_dequeuePos & _mask];
+
+			if (count == 0) {
+				batchSecond = entry.timestamp / 1000;
+			}
+
+			QMessageLogContext context(contextString(entry.file), entry.line, contextString(entry.function), contextString(entry.category));
+			Logger::writeMessage(entry.type, context, entry.timestamp, entry.message, fileBuffer);
+
+			entry.message = QString();
+			entry.sequence.store(_dequeuePos + _mask + 1, std::memory_order_release);
+			_dequeuePos++;
+			count++;
+		}
+
+		// Record messages discarded by the DropNewest policy once the backlog is written
+		if (!hasEntry() && _dropped.load(std::memory_order_relaxed) > 0) {
+			size_t dropped = _dropped.exchange(0, std::memory_order_relaxed);
+			Logger::writeMessage(QtWarningMsg, QMessageLogContext(), QDateTime::currentMSecsSinceEpoch(),
+				QString("Log queue full, %1 messages dropped").arg(dropped), fileBuffer);
+		}
+
+		if (!fileBuffer.isEmpty()) {
+			if (Logger::logFile && Logger::logFile->isOpen()) {
+				if (batchSecond >= 0) {
+					Logger::indexBatch(batchSecond, Logger::logFile->size());
+				}
+				Logger::logFile->write(fileBuffer);
+				Logger::logFile->flush();
+			}
+			fileBuffer.clear();
+		}
+
+		// Sequentially consistent with the waiter count, so a waiter either sees the new count or gets notified
+		_written.store(_dequeuePos);
+		notifyWritten();
+
+		if (count > 0) {
+			continue;
+		}
+
+		if (!_running.load()) {
+			break;
+		}
+
+		std::unique_lock<std::mutex> lock(_wakeMutex);
+		_writerIdle.store(true);
+		_wake.wait_for(lock, idleTimeout, [this]() { return !_running.load() || hasEntry(); });
+		_writerIdle.store(false);
+	}
+}
+
+
 QFile* Logger::logFile = Q_NULLPTR;
 
 QMutex Logger::mutex; 
@@ -40,7 +304,13 @@ QHash<QtMsgType, QString>* Logger::colorCodes = nullptr;
 const QString Logger::resetCode = "\033[0m";
 QtMessageHandler Logger::defaultHandler = nullptr;
 
-void Logger::Initialize()
+LogQueue* Logger::queue = nullptr;
+QReadWriteLock Logger::queueLock;
+QHash<QByteArray, int> Logger::categoryLevels;
+QLoggingCategory::CategoryFilter Logger::defaultCategoryFilter = nullptr;
+std::vector<std::pair<qint64, qint64>> Logger::logIndex;
+
+void Logger::Initialize(OverflowPolicy policy, int queueCapacity)
 {
 	if (isInitialized)
 	{
@@ -71,13 +341,22 @@ void Logger::Initialize()
 	logFile->setFileName("./LogOutput.txt");
 	logFile->open(QIODevice::Append | QIODevice::Text);
 
+	// Clear the log file
+	logFile->resize(0);
+	logIndex.clear();
+
+	// Start the writer before messages are redirected to it
+	{
+		QWriteLocker locker(&queueLock);
+		queue = new LogQueue(policy, queueCapacity);
+	}
 
 	// Redirect logs to messageOutput
 	defaultHandler = qInstallMessageHandler(Logger::messageOutput);
 
-	// Clear the log file
-	logFile->resize(0);
+	defaultCategoryFilter = QLoggingCategory::installFilter(Logger::categoryFilter);
 
+	QWriteLocker locker(&queueLock);
 	Logger::isInitialized = true;
 }
 
@@ -93,10 +372,30 @@ void Logger::Cleanup()
 	qInstallMessageHandler(defaultHandler);
 	//defaultHandler = nullptr;
 
+	QLoggingCategory::installFilter(defaultCategoryFilter);
+
+	// Waits for producers that are still queuing, later messages go to the default handler
+	LogQueue* stoppedQueue = nullptr;
+	{
+		QWriteLocker locker(&queueLock);
+		stoppedQueue = queue;
+		queue = nullptr;
+		isInitialized = false;
+	}
+
+	// Write the remaining messages
+	if (stoppedQueue != nullptr)
+	{
+		stoppedQueue->stop();
+		delete stoppedQueue;
+	}
+
 	if (logFile != Q_NULLPTR)
 	{
+		QMutexLocker locker(&mutex);
 		logFile->close();
 		delete logFile;
+		logFile = Q_NULLPTR;
 	}
 
 
@@ -114,16 +413,135 @@ void Logger::Cleanup()
 		delete colorCodes;
 		colorCodes = nullptr;
 	}
+}
+
+void Logger::Flush()
+{
+	if (LogQueue::onWriterThread)
+	{
+		return;
+	}
 
-	isInitialized = false;
+	QReadLocker locker(&queueLock);
+	if (queue)
+	{
+		queue->flush();
+	}
 }
 
-void Logger::messageOutput(QtMsgType type, const QMessageLogContext& context, const QString& msg)
+QString Logger::logFilePath()
 {
 	QMutexLocker locker(&mutex);
+	return logFile ? QFileInfo(*logFile).absoluteFilePath() : QString();
+}
 
-	if (!isInitialized)
+void Logger::indexBatch(qint64 second, qint64 offset)
+{
+	QMutexLocker locker(&mutex);
+
+	if (logIndex.empty() || second > logIndex.back().first)
+	{
+		logIndex.emplace_back(second, offset);
+	}
+}
+
+qint64 Logger::logOffsetBefore(const QDateTime& time)
+{
+	// Timestamps are taken before a message is queued, so concurrent producers can be slightly out of order.
+	// Starting at a batch from an earlier second covers that.
+	qint64 second = time.toSecsSinceEpoch() - 1;
+
+	QMutexLocker locker(&mutex);
+
+	auto it = std::lower_bound(logIndex.begin(), logIndex.end(), second,
+		[](const std::pair<qint64, qint64>& entry, qint64 value) { return entry.first < value; });
+
+	if (it == logIndex.begin())
+	{
+		return 0;
+	}
+	return std::prev(it)->second;
+}
+
+int Logger::severity(QtMsgType type)
+{
+	switch (type) {
+	case QtDebugMsg:
+		return 0;
+	case QtInfoMsg:
+		return 1;
+	case QtWarningMsg:
+		return 2;
+	case QtCriticalMsg:
+		return 3;
+	default:
+		return 4;
+	}
+}
+
+void Logger::setCategoryLevel(const QByteArray& category, QtMsgType minimumLevel)
+{
+	{
+		QMutexLocker locker(&mutex);
+		categoryLevels.insert(category, severity(minimumLevel));
+	}
+
+	// Reinstalling the filter reevaluates all registered categories, outside the lock as Qt calls back into categoryFilter
+	QLoggingCategory::installFilter(Logger::categoryFilter);
+}
+
+void Logger::resetCategoryLevel(const QByteArray& category)
+{
+	{
+		QMutexLocker locker(&mutex);
+		categoryLevels.remove(category);
+	}
+
+	QLoggingCategory::installFilter(Logger::categoryFilter);
+}
+
+void Logger::categoryFilter(QLoggingCategory* category)
+{
+	if (defaultCategoryFilter)
+	{
+		defaultCategoryFilter(category);
+	}
+
+	QMutexLocker locker(&mutex);
+
+	auto it = categoryLevels.constFind(QByteArray(category->categoryName()));
+	if (it == categoryLevels.constEnd())
+	{
+		return;
+	}
+
+	for (QtMsgType type : { QtDebugMsg, QtInfoMsg, QtWarningMsg, QtCriticalMsg })
 	{
+		category->setEnabled(type, severity(type) >= it.value());
+	}
+}
+
+void Logger::messageOutput(QtMsgType type, const QMessageLogContext& context, const QString& msg)
+{
+	// Messages raised while writing, e.g. by QFile, are written directly to avoid waiting on ourselves.
+	// Cleanup() joins the writer thread before it deletes the log file.
+	if (LogQueue::onWriterThread)
+	{
+		QByteArray fileBuffer;
+		writeMessage(type, context, QDateTime::currentMSecsSinceEpoch(), msg, fileBuffer);
+		if (logFile && logFile->isOpen())
+		{
+			logFile->write(fileBuffer);
+		}
+		return;
+	}
+
+	// Uncontended read lock, keeps Cleanup() from deleting the queue while it is used
+	QReadLocker locker(&queueLock);
+
+	if (!isInitialized || !queue)
+	{
+		locker.unlock();
 		if (defaultHandler)
 		{
 			defaultHandler(type, context, msg);
@@ -131,26 +549,64 @@ void Logger::messageOutput(QtMsgType type, const QMessageLogContext& context, co
 		return;
 	}
 
-	QString timestamp = QDateTime::currentDateTime().toString("yyyy-MM-dd hh:mm:ss");
-	QString contextName = contextNames->value(type, "UNKNOWN");
-	QString fileName = QString(context.file).section('\\', -1);
-	QString functionName = QString(context.function).section('(', -2, -2).section(' ', -1).section(':', -1);
-
-	QString formattedMessage = QString("%1 || %2 | %3 %4 %5 || %6\n")
-		.arg(timestamp)
-		.arg(contextName)
-		.arg(context.line)
-		.arg(fileName)
-		.arg(functionName)
-		.arg(msg);
+	size_t ticket = 0;
+	bool queued = queue->push(type, context, msg, type == QtFatalMsg, ticket);
 
-	// Write to log file
-	if (logFile && logFile->isOpen())
+	// The application aborts after a fatal message, make sure it reached the log first
+	if (queued && type == QtFatalMsg)
+	{
+		queue->waitWritten(ticket);
+	}
+}
+
+void Logger::writeMessage(QtMsgType type, const QMessageLogContext& context, qint64 timestamp, const QString& msg, QByteArray& fileBuffer)
+{
+	// Only used by the writer thread, the timestamp string changes once per second
+	static qint64 cachedSecond = -1;
+	static QByteArray cachedTimestamp;
+	// Keyed by contents, the context pointers may be reused for other strings after a module unload
+	static QHash<QByteArray, QByteArray> fileNames;
+	static QHash<QByteArray, QByteArray> functionNames;
+
+	qint64 second = timestamp / 1000;
+	if (second != cachedSecond)
 	{
-		logFile->write(formattedMessage.toLocal8Bit());
-		logFile->flush();
+		cachedSecond = second;
+		cachedTimestamp = QDateTime::fromMSecsSinceEpoch(timestamp).toString("yyyy-MM-dd hh:mm:ss").toLocal8Bit();
 	}
 
+	// Lookups wrap the context strings without copying, new keys are deep copied
+	QByteArray fileKey = QByteArray::fromRawData(context.file ? context.file : "", context.file ? qstrlen(context.file) : 0);
+	auto fileName = fileNames.constFind(fileKey);
+	if (fileName == fileNames.constEnd())
+	{
+		fileName = fileNames.insert(QByteArray(fileKey.constData(), fileKey.size()),
+			QString::fromLocal8Bit(fileKey).section('\\', -1).toLocal8Bit());
+	}
+
+	QByteArray functionKey = QByteArray::fromRawData(context.function ? context.function : "", context.function ? qstrlen(context.function) : 0);
+	auto functionName = functionNames.constFind(functionKey);
+	if (functionName == functionNames.constEnd())
+	{
+		functionName = functionNames.insert(QByteArray(functionKey.constData(), functionKey.size()),
+			QString::fromLocal8Bit(functionKey).section('(', -2, -2).section(' ', -1).section(':', -1).toLocal8Bit());
+	}
+
+	QString contextName = contextNames->value(type, "UNKNOWN");
+
+	fileBuffer += cachedTimestamp;
+	fileBuffer += " || ";
+	fileBuffer += contextName.toLocal8Bit();
+	fileBuffer += " | ";
+	fileBuffer += QByteArray::number(context.line);
+	fileBuffer += ' ';
+	fileBuffer += fileName.value();
+	fileBuffer += ' ';
+	fileBuffer += functionName.value();
+	fileBuffer += " || ";
+	fileBuffer += msg.toLocal8Bit();
+	fileBuffer += '\n';
+
 	// Print to console with colored formatting
 	QString colorCode = colorCodes->value(type, resetCode);
 
@@ -27,11 +27,40 @@
 #include <QFile>
 #include <QHash>
 #include <QMutex>
+#include <QReadWriteLock>
+#include <QLoggingCategory>
+#include <QDateTime>
+#include <vector>
+#include <utility>
+
+
+class LogQueue;
+
+/**
+ * @class Logger
+ * @brief Asynchronous Qt message handler writing to LogOutput.txt and the console.
+ *
+ * The message handler only copies the message into a fixed size lock-free ring buffer, under a shared lock that
+ * keeps Cleanup() from destroying the buffer while it is in use. A background writer
+ * thread formats queued messages, writes them to the log file in batches and forwards them to the default
+ * console handler. Fatal messages are written before the handler returns.
+ *
+ * The writer keeps a sparse index from the time of a written batch (in seconds) to its byte offset in the log
+ * file, so time slices of a long log can be read with a seek instead of a scan from the start.
+ *
+ * Message levels can be limited per logging category at runtime. Disabled categories are filtered through
+ * QLoggingCategory, so a disabled qCDebug() costs a single branch at the call site.
+ */
+class  ANIMHOSTCORESHARED_EXPORT Logger {
 
+public:
+	//! Behaviour of the message handler when the ring buffer is full
+	enum class OverflowPolicy {
+		DropNewest,		//!< Discard the message, the number of dropped messages is logged once the queue has drained
+		Block			//!< Wait until the writer thread has freed a slot
+	};
 
-
-
-class  ANIMHOSTCORESHARED_EXPORT Logger {
+	static constexpr int DefaultQueueCapacity = 8192;
 
 private:
 	
@@ -49,25 +78,93 @@ private:
 
 	static QtMessageHandler defaultHandler; //!< @brief Default message handler
 
-	static QMutex mutex; //!< @brief Mutex to lock the logger
+	static QMutex mutex; //!< @brief Guards the category levels, the log index and the log file pointer, never locked per message
+
+	static LogQueue* queue; //!< @brief Ring buffer and writer thread
+
+	static QReadWriteLock queueLock; //!< @brief Read locked while a message is queued, write locked while the queue is created or destroyed
+
+	static QHash<QByteArray, int> categoryLevels; //!< @brief Minimum severity per category name
+
+	static QLoggingCategory::CategoryFilter defaultCategoryFilter; //!< @brief Filter installed before the logger
+
+	static std::vector<std::pair<qint64, qint64>> logIndex; //!< @brief Seconds since epoch and byte offset of the first batch written in that second
+
+	//! Adds an index entry if \c second is newer than the last one. Runs on the writer thread
+	static void indexBatch(qint64 second, qint64 offset);
+
+	//! Orders QtMsgType by severity, QtInfoMsg has a higher enum value than QtFatalMsg
+	static int severity(QtMsgType type);
+
+	//! Enables the levels of a category according to categoryLevels
+	static void categoryFilter(QLoggingCategory* category);
+
+	friend class LogQueue;
+
+	//! Formats a queued message, writes it to the file buffer and the console. Runs on the writer thread
+	static void writeMessage(QtMsgType type, const QMessageLogContext& context, qint64 timestamp, const QString& msg, QByteArray& fileBuffer);
+
 public:
 	
 	/**
-	 * @brief Initializes the logger
+	 * @brief Initializes the logger and starts the writer thread
 	 * 
+	 * @param policy What to do with messages when the queue is full
+	 * @param queueCapacity Number of messages the queue holds, rounded up to a power of two
 	 */
-	static void Initialize();
+	static void Initialize(OverflowPolicy policy = OverflowPolicy::DropNewest, int queueCapacity = DefaultQueueCapacity);
 
 
 	/**
-	 * @brief Cleanup the logger
+	 * @brief Writes all queued messages, stops the writer thread and cleans up the logger
 	 * 
 	 */
 	static void Cleanup();
 
 
 	/**
-	 * @brief Outputs the message to the log file
+	 * @brief Blocks until all messages queued so far are written
+	 *
+	 */
+	static void Flush();
+
+
+	/**
+	 * @brief Absolute path of the log file, empty if the logger is not initialized
+	 *
+	 */
+	static QString logFilePath();
+
+
+	/**
+	 * @brief Byte offset in the log file from which on all lines logged at or after \c time follow
+	 *
+	 * Lines before \c time may follow the offset as well, readers still filter by timestamp.
+	 *
+	 * @return 0 if the index has no entry early enough
+	 */
+	static qint64 logOffsetBefore(const QDateTime& time);
+
+
+	/**
+	 * @brief Sets the minimum level of a logging category, e.g. "default" for plain qDebug()
+	 *
+	 * @param category Name of the QLoggingCategory
+	 * @param minimumLevel Messages below this severity are disabled
+	 */
+	static void setCategoryLevel(const QByteArray& category, QtMsgType minimumLevel);
+
+
+	/**
+	 * @brief Restores the default levels of a logging category
+	 *
+	 * @param category Name of the QLoggingCategory
+	 */
+	static void resetCategoryLevel(const QByteArray& category);
+
+
+	/**
+	 * @brief Queues the message for the writer thread
 	 *
 	 * @param type The type of the message
 	 * @param context The context of the message
@@ -197,4 +197,42 @@ public:
 };
 
 
+/**
+ * @struct RootSpace
+ *
+ * @brief Transforms into the local space of a root transform.
+ *
+ * Equivalent to the MathUtils::*To functions with a fixed target, but inverts the root only once.
+ * Use it when many values are transformed relative to the same root, e.g. all features of one frame.
+ */
+struct RootSpace {
+
+	glm::mat4 inverseRoot;
+
+	explicit RootSpace(const glm::mat4& root) : inverseRoot(glm::inverse(root)) {}
+
+	glm::vec2 PositionTo(const glm::mat4& from) const {
+		glm::vec4 pos = inverseRoot * from[3];
+		return glm::vec2(pos.x, pos.z);
+	}
+
+	glm::vec3 PositionTo(const glm::vec3& from) const {
+		return glm::vec3(inverseRoot * glm::vec4(from, 1.0f));
+	}
+
+	glm::vec2 ForwardTo(const glm::mat4& from) const {
+		glm::vec4 dir = inverseRoot * from[2];
+		return glm::normalize(glm::vec2(dir.x, dir.z));
+	}
+
+	glm::vec3 DirectionTo(const glm::vec3& from) const {
+		return glm::normalize(glm::vec3(inverseRoot * glm::vec4(from, 0.0f)));
+	}
+
+	glm::vec3 VelocityTo(const glm::vec3& from) const {
+		return glm::vec3(inverseRoot * glm::vec4(from, 0.0f));
+	}
+};
+
+
 #endif // !MATHUTILS_H
\ No newline at end of file
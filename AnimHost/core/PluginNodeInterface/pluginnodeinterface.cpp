@@ -20,6 +20,7 @@
  
 #include "pluginnodeinterface.h"
 #include <nodedatatypes.h>
+#include <QMetaProperty>
 
 
 unsigned int PluginNodeInterface::nPorts(QtNodes::PortType portType) const
@@ -68,12 +69,18 @@ std::shared_ptr<NodeData> PluginNodeInterface::outData(QtNodes::PortIndex port)
 
 void PluginNodeInterface::propagateMetadata(const QVariantMap& metadata)
 {
+	const QMetaObject* meta = metaObject();
+
 	for (auto it = metadata.begin(); it != metadata.end(); ++it) {
-		const QByteArray key = it.key().toUtf8();
+		// Resolve each key once, later runs with the same metadata skip the string lookup
+		auto cached = _propertyIndexCache.constFind(it.key());
+		if (cached == _propertyIndexCache.constEnd()) {
+			cached = _propertyIndexCache.insert(it.key(), meta->indexOfProperty(it.key().toUtf8()));
+		}
 
-		if (metaObject()->indexOfProperty(key) != -1) {
-			//qDebug() << "Setting property: " << key << " to value: " << it.value();
-			setProperty(key, it.value());
+		if (cached.value() != -1) {
+			//qDebug() << "Setting property: " << it.key() << " to value: " << it.value();
+			meta->property(cached.value()).write(this, it.value());
 		} else {
 			//qDebug() << "No property found for key: " << it.key();
 		}
@@ -26,6 +26,7 @@
 #include <QString>
 #include <QVariant>
 #include <QVariantMap>
+#include <QHash>
 #include "plugininterface.h"
 #include <QtNodes/NodeDelegateModel>
 #include <nodedatatypes.h>
@@ -41,6 +42,9 @@ private:
 	std::shared_ptr<AnimNodeData<RunSignal>> _runSignalIncoming = nullptr;
     std::shared_ptr<AnimNodeData<RunSignal>> _runSignal = nullptr;
 
+    // Resolved property index per metadata key, -1 for keys without a matching property
+    QHash<QString, int> _propertyIndexCache;
+
 public:
 
     PluginNodeInterface() {};
@@ -0,0 +1,95 @@
+/*
+ ***************************************************************************************
+
+ *   Copyright (c) 2024 Filmakademie Baden-Wuerttemberg, Animationsinstitut R&D Labs
+ *   https://research.animationsinstitut.de/animhost
+ *   https://github.com/FilmakademieRnd/AnimHost
+ *    
+ *   AnimHost is a development by Filmakademie Baden-Wuerttemberg, Animationsinstitut
+ *   R&D Labs in the scope of the EU funded project MAX-R (101070072).
+ *    
+ *   This program is distributed in the hope that it will be useful, but WITHOUT
+ *   ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ *   FOR A PARTICULAR PURPOSE. See the MIT License for more details.
+ *   You should have received a copy of the MIT License along with this program; 
+ *   if not go to https://opensource.org/licenses/MIT
+
+ ***************************************************************************************
+ */
+
+ 
+
+ 
+#include "PoseRingBuffer.h"
+#include "commondatatypes.h"
+
+#include <algorithm>
+
+
+int PoseWindow::jointCount() const {
+	return _buffer ? _buffer->_jointCount : 0;
+}
+
+const glm::vec3* PoseWindow::frame(int pastFrame) const {
+	return _buffer->slot(_newestFrame - pastFrame);
+}
+
+bool PoseWindow::isValid() const {
+	if (!_buffer || _size == 0) {
+		return _size == 0;
+	}
+
+	// Keep the reads of the frame data before the counter check
+	std::atomic_thread_fence(std::memory_order_acquire);
+
+	// The producer starts overwriting the slot of the oldest frame once oldest + capacity frames were written
+	uint64_t oldestFrame = _newestFrame - (_size - 1);
+	uint64_t written = _buffer->_framesWritten.load(std::memory_order_relaxed);
+
+	return written < oldestFrame + _buffer->_capacity;
+}
+
+
+PoseRingBuffer::PoseRingBuffer(int capacity, int jointCount) {
+	configure(capacity, jointCount);
+}
+
+void PoseRingBuffer::configure(int capacity, int jointCount) {
+	_capacity = std::max(capacity, 1);
+	_jointCount = std::max(jointCount, 0);
+
+	_positions.assign(static_cast<size_t>(_capacity) * _jointCount, glm::vec3(0.0f));
+	_framesWritten.store(0, std::memory_order_release);
+}
+
+int PoseRingBuffer::available() const {
+	uint64_t written = _framesWritten.load(std::memory_order_acquire);
+	return static_cast<int>(std::min<uint64_t>(written, _capacity));
+}
+
+void PoseRingBuffer::push(const glm::vec3* positions, int count) {
+	uint64_t frame = _framesWritten.load(std::memory_order_relaxed);
+	glm::vec3* target = const_cast<glm::vec3*>(slot(frame));
+
+	int copied = std::min(count, _jointCount);
+	std::copy(positions, positions + copied, target);
+	std::fill(target + copied, target + _jointCount, glm::vec3(0.0f));
+
+	// Publish the frame only after its positions are written
+	_framesWritten.store(frame + 1, std::memory_order_release);
+}
+
+void PoseRingBuffer::push(const Pose& pose) {
+	push(pose.mPositionData.data(), static_cast<int>(pose.mPositionData.size()));
+}
+
+PoseWindow PoseRingBuffer::latest(int numFrames) const {
+	PoseWindow window;
+	window._buffer = this;
+
+	uint64_t written = _framesWritten.load(std::memory_order_acquire);
+	window._size = std::clamp(numFrames, 0, static_cast<int>(std::min<uint64_t>(written, _capacity)));
+	window._newestFrame = written > 0 ? written - 1 : 0;
+
+	return window;
+}
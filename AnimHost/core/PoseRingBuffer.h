@@ -0,0 +1,147 @@
+/*
+ ***************************************************************************************
+
+ *   Copyright (c) 2024 Filmakademie Baden-Wuerttemberg, Animationsinstitut R&D Labs
+ *   https://research.animationsinstitut.de/animhost
+ *   https://github.com/FilmakademieRnd/AnimHost
+ *    
+ *   AnimHost is a development by Filmakademie Baden-Wuerttemberg, Animationsinstitut
+ *   R&D Labs in the scope of the EU funded project MAX-R (101070072).
+ *    
+ *   This program is distributed in the hope that it will be useful, but WITHOUT
+ *   ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ *   FOR A PARTICULAR PURPOSE. See the MIT License for more details.
+ *   You should have received a copy of the MIT License along with this program; 
+ *   if not go to https://opensource.org/licenses/MIT
+
+ ***************************************************************************************
+ */
+
+ 
+
+ 
+#ifndef POSERINGBUFFER_H
+#define POSERINGBUFFER_H
+
+#include "animhostcore_global.h"
+
+#include <glm/glm.hpp>
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+class Pose;
+class PoseRingBuffer;
+
+
+/**
+ * @class PoseWindow
+ *
+ * @brief Non-owning view of the most recent frames of a PoseRingBuffer.
+ *
+ * Frame 0 is the newest frame. Frames are stored in the ring buffer slots, so a window over the
+ * wraparound point is served without copying. The view stays valid as long as the producer has not
+ * overwritten its oldest frame, which isValid() checks after reading.
+ */
+class ANIMHOSTCORESHARED_EXPORT PoseWindow {
+
+	friend class PoseRingBuffer;
+
+	const PoseRingBuffer* _buffer = nullptr;
+	uint64_t _newestFrame = 0;
+	int _size = 0;
+
+public:
+
+	PoseWindow() = default;
+
+	//! Number of frames in the window
+	int size() const { return _size; }
+
+	bool empty() const { return _size == 0; }
+
+	//! Number of joints per frame
+	int jointCount() const;
+
+	/**
+	 * @brief Joint positions of a past frame.
+	 *
+	 * @param pastFrame 0 for the newest frame, size() - 1 for the oldest.
+	 * @return Pointer to jointCount() contiguous positions inside the ring buffer.
+	 */
+	const glm::vec3* frame(int pastFrame) const;
+
+	//! False if the producer overwrote frames of this window since it was taken
+	bool isValid() const;
+};
+
+
+/**
+ * @class PoseRingBuffer
+ *
+ * @brief Single-producer/single-consumer history of poses in preallocated contiguous slots.
+ *
+ * The joint positions of all frames live in one array of capacity * jointCount positions, so pushing
+ * a frame copies into an existing slot and allocates nothing. The producer (e.g. a network thread)
+ * calls push(), the consumer (e.g. the graph thread) reads the latest frames through a PoseWindow.
+ * The frame counter is published with release/acquire ordering, a window never sees a half written frame
+ * as long as it is shorter than the capacity and isValid() is checked after reading.
+ *
+ * configure() reallocates the slots and must not run concurrently with push() or an active reader.
+ */
+class ANIMHOSTCORESHARED_EXPORT PoseRingBuffer {
+
+	friend class PoseWindow;
+
+	std::vector<glm::vec3> _positions;
+	int _capacity = 0;
+	int _jointCount = 0;
+
+	std::atomic<uint64_t> _framesWritten{ 0 };
+
+public:
+
+	PoseRingBuffer() = default;
+
+	PoseRingBuffer(int capacity, int jointCount);
+
+	/**
+	 * @brief Allocates the slots and discards all frames.
+	 *
+	 * @param capacity Maximum number of frames in the history.
+	 * @param jointCount Number of joint positions per frame.
+	 */
+	void configure(int capacity, int jointCount);
+
+	int capacity() const { return _capacity; }
+
+	int jointCount() const { return _jointCount; }
+
+	//! Number of frames that can currently be read, at most the capacity
+	int available() const;
+
+	/**
+	 * @brief Appends a frame, overwriting the oldest one once the buffer is full. Producer only.
+	 *
+	 * @param positions jointCount() joint positions, further positions are ignored and missing ones zeroed.
+	 * @param count Number of positions at positions.
+	 */
+	void push(const glm::vec3* positions, int count);
+
+	void push(const Pose& pose);
+
+	/**
+	 * @brief View of the latest frames. Consumer only.
+	 *
+	 * @param numFrames Requested number of frames, clamped to the available frames.
+	 */
+	PoseWindow latest(int numFrames) const;
+
+private:
+
+	const glm::vec3* slot(uint64_t frame) const {
+		return _positions.data() + (frame % _capacity) * _jointCount;
+	}
+};
+
+#endif // POSERINGBUFFER_H
@@ -0,0 +1,234 @@
+/*
+ ***************************************************************************************
+
+ *   Copyright (c) 2024 Filmakademie Baden-Wuerttemberg, Animationsinstitut R&D Labs
+ *   https://research.animationsinstitut.de/animhost
+ *   https://github.com/FilmakademieRnd/AnimHost
+ *    
+ *   AnimHost is a development by Filmakademie Baden-Wuerttemberg, Animationsinstitut
+ *   R&D Labs in the scope of the EU funded project MAX-R (101070072).
+ *    
+ *   This program is distributed in the hope that it will be useful, but WITHOUT
+ *   ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ *   FOR A PARTICULAR PURPOSE. See the MIT License for more details.
+ *   You should have received a copy of the MIT License along with this program; 
+ *   if not go to https://opensource.org/licenses/MIT
+
+ ***************************************************************************************
+ */
+
+ 
+
+#include "SharedDatasetPublisher.h"
+#include "DatasetReader.h"
+
+#include <QCoreApplication>
+#include <QCryptographicHash>
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <cstring>
+#include <memory>
+
+namespace {
+
+	constexpr char SegmentMagic[4] = { 'A', 'H', 'S', 'M' };
+	constexpr qint64 HeaderSize = 16;
+
+	qint64 alignUp(qint64 value, qint64 alignment)
+	{
+		return (value + alignment - 1) / alignment * alignment;
+	}
+
+	//! Files publishDirectory() reads, matching dataset_binary_path() in the Python preprocessing.
+	//! p_velocity.bin is not shared, the PAE Network.py subprocess reads it from disk.
+	QStringList datasetSources(const QString& datasetPath)
+	{
+		QDir dir(datasetPath);
+		QStringList sources;
+
+		for (const char* name : { "data_x", "data_y" }) {
+			QString container = dir.filePath(QString(name) + ".ahds");
+			sources << (QFileInfo::exists(container) ? container : dir.filePath(QString(name) + ".bin"));
+		}
+
+		return sources;
+	}
+}
+
+SharedDatasetPublisher::~SharedDatasetPublisher()
+{
+	release();
+}
+
+void SharedDatasetPublisher::release()
+{
+	if (_segment.isAttached()) {
+		_segment.detach();
+	}
+	_fingerprint.clear();
+}
+
+bool SharedDatasetPublisher::publish(const std::vector<Block>& blocks, const QJsonObject& metadata, const QByteArray& fingerprint)
+{
+	release();
+
+	// Lay out the blocks behind the manifest, the manifest size depends on the offsets and vice versa.
+	// Reserving room for the offsets' digits up front avoids iterating.
+	QJsonArray blockEntries;
+	std::vector<qint64> blockBytes;
+
+	for (const Block& block : blocks) {
+		qint64 count = 1;
+		QJsonArray shape;
+		for (qint64 dim : block.shape) {
+			count *= dim;
+			shape.append(dim);
+		}
+		blockBytes.push_back(count * static_cast<qint64>(sizeof(float)));
+
+		QJsonObject entry;
+		entry["name"] = block.name;
+		entry["dtype"] = "<f4";
+		entry["shape"] = shape;
+		entry["source"] = block.source;
+		entry["offset"] = 0;
+		blockEntries.append(entry);
+	}
+
+	const qint64 manifestReserve = QJsonDocument(QJsonObject{ { "blocks", blockEntries } }).toJson(QJsonDocument::Compact).size()
+		+ QJsonDocument(metadata).toJson(QJsonDocument::Compact).size() + 128 + 24 * static_cast<qint64>(blocks.size());
+
+	qint64 offset = alignUp(HeaderSize + manifestReserve, BlockAlignment);
+	std::vector<qint64> blockOffsets;
+	for (size_t i = 0; i < blocks.size(); i++) {
+		blockOffsets.push_back(offset);
+
+		QJsonObject entry = blockEntries[static_cast<int>(i)].toObject();
+		entry["offset"] = offset;
+		blockEntries[static_cast<int>(i)] = entry;
+
+		offset = alignUp(offset + blockBytes[i], BlockAlignment);
+	}
+
+	QJsonObject manifest = metadata;
+	manifest["version"] = static_cast<int>(Version);
+	manifest["fingerprint"] = QString::fromLatin1(fingerprint.toHex());
+	manifest["blocks"] = blockEntries;
+	QByteArray manifestJson = QJsonDocument(manifest).toJson(QJsonDocument::Compact);
+
+	if (manifestJson.size() > manifestReserve) {
+		qWarning() << "[SharedDatasetPublisher] Manifest exceeds its reserved size";
+		return false;
+	}
+
+	QString name = QString("AnimHostDataset_%1_%2").arg(QCoreApplication::applicationPid()).arg(++_generation);
+	_segment.setNativeKey(name);
+
+	if (!_segment.create(offset)) {
+		qWarning() << "[SharedDatasetPublisher] Could not create shared memory segment" << name << ":" << _segment.errorString();
+		return false;
+	}
+
+	_segment.lock();
+
+	char* base = static_cast<char*>(_segment.data());
+	quint32 version = Version;
+	quint64 manifestSize = static_cast<quint64>(manifestJson.size());
+
+	std::memcpy(base, SegmentMagic, 4);
+	std::memcpy(base + 4, &version, sizeof(version));
+	std::memcpy(base + 8, &manifestSize, sizeof(manifestSize));
+	std::memcpy(base + HeaderSize, manifestJson.constData(), manifestJson.size());
+
+	for (size_t i = 0; i < blocks.size(); i++) {
+		std::memcpy(base + blockOffsets[i], blocks[i].data, blockBytes[i]);
+	}
+
+	_segment.unlock();
+
+	_fingerprint = fingerprint;
+
+	qDebug() << "[SharedDatasetPublisher] Published" << blocks.size() << "blocks," << offset << "bytes as" << name;
+	return true;
+}
+
+QByteArray SharedDatasetPublisher::directoryFingerprint(const QString& datasetPath)
+{
+	QCryptographicHash hash(QCryptographicHash::Sha1);
+
+	for (const QString& source : datasetSources(datasetPath)) {
+		QFileInfo info(source);
+		if (!info.exists())
+			continue;
+
+		hash.addData(info.absoluteFilePath().toUtf8());
+		hash.addData(QByteArray::number(info.size()));
+		hash.addData(QByteArray::number(info.lastModified().toMSecsSinceEpoch()));
+	}
+
+	return hash.result();
+}
+
+bool SharedDatasetPublisher::publishDirectory(const QString& datasetPath)
+{
+	QByteArray fingerprint = directoryFingerprint(datasetPath);
+
+	if (isPublished() && fingerprint == _fingerprint) {
+		qDebug() << "[SharedDatasetPublisher] Dataset unchanged, reusing" << segmentName();
+		return true;
+	}
+
+	// Sources stay mapped until the blocks are copied
+	std::vector<std::unique_ptr<DatasetReader>> containers;
+	std::vector<std::unique_ptr<QFile>> rawFiles;
+	std::vector<Block> blocks;
+
+	for (const QString& source : datasetSources(datasetPath)) {
+		if (!QFileInfo::exists(source))
+			continue;
+
+		Block block;
+		block.name = QFileInfo(source).completeBaseName();
+		block.source = QFileInfo(source).absoluteFilePath();
+
+		if (source.endsWith(".ahds")) {
+			auto reader = std::make_unique<DatasetReader>();
+			if (!reader->open(source)) {
+				qWarning() << "[SharedDatasetPublisher] Could not open dataset container" << source;
+				continue;
+			}
+			block.data = reader->data();
+			block.shape = { static_cast<qint64>(reader->rowCount()), reader->featureCount() };
+			containers.push_back(std::move(reader));
+		}
+		else {
+			auto file = std::make_unique<QFile>(source);
+			qint64 floatCount = file->size() / static_cast<qint64>(sizeof(float));
+			uchar* mapped = (floatCount > 0 && file->open(QIODevice::ReadOnly)) ? file->map(0, floatCount * sizeof(float)) : nullptr;
+			if (!mapped) {
+				qWarning() << "[SharedDatasetPublisher] Could not map" << source;
+				continue;
+			}
+			block.data = reinterpret_cast<const float*>(mapped);
+			block.shape = { floatCount };
+			rawFiles.push_back(std::move(file));
+		}
+
+		blocks.push_back(std::move(block));
+	}
+
+	if (blocks.empty()) {
+		qWarning() << "[SharedDatasetPublisher] No dataset files found in" << datasetPath;
+		release();
+		return false;
+	}
+
+	QJsonObject metadata;
+	metadata["dataset_path"] = QDir(datasetPath).absolutePath();
+
+	return publish(blocks, metadata, fingerprint);
+}
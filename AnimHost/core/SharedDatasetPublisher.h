@@ -0,0 +1,109 @@
+/*
+ ***************************************************************************************
+
+ *   Copyright (c) 2024 Filmakademie Baden-Wuerttemberg, Animationsinstitut R&D Labs
+ *   https://research.animationsinstitut.de/animhost
+ *   https://github.com/FilmakademieRnd/AnimHost
+ *    
+ *   AnimHost is a development by Filmakademie Baden-Wuerttemberg, Animationsinstitut
+ *   R&D Labs in the scope of the EU funded project MAX-R (101070072).
+ *    
+ *   This program is distributed in the hope that it will be useful, but WITHOUT
+ *   ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ *   FOR A PARTICULAR PURPOSE. See the MIT License for more details.
+ *   You should have received a copy of the MIT License along with this program; 
+ *   if not go to https://opensource.org/licenses/MIT
+
+ ***************************************************************************************
+ */
+
+ 
+
+#ifndef SHAREDDATASETPUBLISHER_H
+#define SHAREDDATASETPUBLISHER_H
+
+#include "animhostcore_global.h"
+
+#include <QSharedMemory>
+#include <QString>
+#include <QByteArray>
+#include <QJsonObject>
+#include <vector>
+
+
+/**
+ * @class SharedDatasetPublisher
+ * @brief Publishes the feature matrices of a training dataset in a named shared memory segment.
+ *
+ * The training process attaches to the segment by its name and reads the matrices in place, instead of
+ * loading them from the dataset directory again. The segment starts with a small header and a JSON manifest:
+ *
+ *     char[4] magic "AHSM" | uint32 version | uint64 manifest size | manifest (UTF-8 JSON) | blocks
+ *
+ * The manifest lists every block with its name, dtype ("<f4"), byte offset from the segment start, shape and
+ * source file. Blocks are aligned to 64 bytes.
+ *
+ * The segment uses a native key, so other processes open it by exactly segmentName(). It lives as long as this
+ * publisher keeps it attached. Publishing unchanged source files again keeps the existing segment.
+ */
+class ANIMHOSTCORESHARED_EXPORT SharedDatasetPublisher
+{
+public:
+	static constexpr quint32 Version = 1;
+	static constexpr qint64 BlockAlignment = 64;
+
+	//! Row major float matrix to publish
+	struct Block {
+		QString name;
+		const float* data = nullptr;
+		std::vector<qint64> shape;	//!< Number of values per dimension
+		QString source;				//!< File the block was read from, informational
+	};
+
+private:
+	QSharedMemory _segment;
+	QByteArray _fingerprint;
+	int _generation = 0;
+
+public:
+	SharedDatasetPublisher() = default;
+	~SharedDatasetPublisher();
+
+	SharedDatasetPublisher(const SharedDatasetPublisher&) = delete;
+	SharedDatasetPublisher& operator=(const SharedDatasetPublisher&) = delete;
+
+	/**
+	 * @brief Copies blocks into a new segment and releases the previous one.
+	 *
+	 * @param blocks Matrices to publish
+	 * @param metadata Additional manifest entries
+	 * @param fingerprint Identifies the published data, see fingerprint()
+	 * @return False if the segment could not be created
+	 */
+	bool publish(const std::vector<Block>& blocks, const QJsonObject& metadata, const QByteArray& fingerprint);
+
+	/**
+	 * @brief Publishes data_x and data_y (indexed container or raw binary) of a dataset directory.
+	 *
+	 * Does nothing if the same files, by size and modification time, are already published.
+	 * Raw binaries are published as one dimensional blocks.
+	 *
+	 * @return False if no file could be published
+	 */
+	bool publishDirectory(const QString& datasetPath);
+
+	//! Fingerprint of the dataset files that publishDirectory() would publish
+	static QByteArray directoryFingerprint(const QString& datasetPath);
+
+	//! Detaches from the segment, it is removed once no process is attached anymore
+	void release();
+
+	bool isPublished() const { return _segment.isAttached(); }
+
+	//! Name under which other processes open the segment, empty if nothing is published
+	QString segmentName() const { return isPublished() ? _segment.nativeKey() : QString(); }
+
+	const QByteArray& fingerprint() const { return _fingerprint; }
+};
+
+#endif // SHAREDDATASETPUBLISHER_H
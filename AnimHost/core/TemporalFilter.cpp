@@ -0,0 +1,462 @@
+/*
+ ***************************************************************************************
+
+ *   Copyright (c) 2024 Filmakademie Baden-Wuerttemberg, Animationsinstitut R&D Labs
+ *   https://research.animationsinstitut.de/animhost
+ *   https://github.com/FilmakademieRnd/AnimHost
+ *    
+ *   AnimHost is a development by Filmakademie Baden-Wuerttemberg, Animationsinstitut
+ *   R&D Labs in the scope of the EU funded project MAX-R (101070072).
+ *    
+ *   This program is distributed in the hope that it will be useful, but WITHOUT
+ *   ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ *   FOR A PARTICULAR PURPOSE. See the MIT License for more details.
+ *   You should have received a copy of the MIT License along with this program; 
+ *   if not go to https://opensource.org/licenses/MIT
+
+ ***************************************************************************************
+ */
+
+ 
+#include "TemporalFilter.h"
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <map>
+#include <mutex>
+
+
+const std::vector<float>& TemporalFilter::GaussianKernel(float sigma) {
+	static std::mutex cacheMutex;
+	static std::map<float, std::vector<float>> cache;
+
+	std::lock_guard<std::mutex> lock(cacheMutex);
+
+	auto it = cache.find(sigma);
+	if (it != cache.end()) {
+		return it->second;
+	}
+
+	int kernelRadius = static_cast<int>(std::ceil(3.0f * sigma));
+	std::vector<float> kernel(2 * kernelRadius + 1);
+
+	double sum = 0.0;
+	for (int j = -kernelRadius; j <= kernelRadius; ++j) {
+		double weight = std::exp(-(double(j) * j) / (2.0 * sigma * sigma));
+		kernel[j + kernelRadius] = static_cast<float>(weight);
+		sum += weight;
+	}
+
+	for (float& weight : kernel) {
+		weight = static_cast<float>(weight / sum);
+	}
+
+	// std::map never moves its nodes, references handed out earlier stay valid
+	return cache.emplace(sigma, std::move(kernel)).first->second;
+}
+
+
+void TemporalFilter::ConvolveChannel(const float* src, float* dst, int count, const std::vector<float>& kernel) {
+	const int kernelRadius = static_cast<int>(kernel.size()) / 2;
+
+	// Pad with the border values so the inner loop needs no clamping
+	std::vector<float> padded(count + 2 * kernelRadius);
+	std::fill(padded.begin(), padded.begin() + kernelRadius, src[0]);
+	std::copy(src, src + count, padded.begin() + kernelRadius);
+	std::fill(padded.begin() + kernelRadius + count, padded.end(), src[count - 1]);
+
+	std::fill(dst, dst + count, 0.0f);
+
+	// Taps in the outer loop, frames in the inner loop: contiguous and vectorizable
+	for (size_t tap = 0; tap < kernel.size(); ++tap) {
+		const float weight = kernel[tap];
+		const float* shifted = padded.data() + tap;
+
+		for (int i = 0; i < count; ++i) {
+			dst[i] += weight * shifted[i];
+		}
+	}
+}
+
+
+void TemporalFilter::BoxFilterChannel(const float* src, float* dst, int count, int radius) {
+	auto at = [src, count](int idx) { return src[std::clamp(idx, 0, count - 1)]; };
+
+	double windowSum = 0.0;
+	for (int j = -radius; j <= radius; ++j) {
+		windowSum += at(j);
+	}
+
+	const double invWidth = 1.0 / (2 * radius + 1);
+
+	// Sliding window: add the sample entering and remove the one leaving
+	for (int i = 0; i < count; ++i) {
+		dst[i] = static_cast<float>(windowSum * invWidth);
+		windowSum += at(i + radius + 1) - at(i - radius);
+	}
+}
+
+
+void TemporalFilter::GaussianFilter(const float* src, float* dst, int count, float sigma, bool exact) {
+	if (count <= 0) {
+		return;
+	}
+
+	if (sigma <= 0.0f || count == 1) {
+		std::copy(src, src + count, dst);
+		return;
+	}
+
+	int kernelRadius = static_cast<int>(std::ceil(3.0f * sigma));
+
+	if (exact || kernelRadius <= LongWindowRadius) {
+		ConvolveChannel(src, dst, count, GaussianKernel(sigma));
+		return;
+	}
+
+	// Long windows: three box filters with widths matching the Gaussian variance (Kovesi 2010)
+	constexpr int passes = 3;
+	const float variance = sigma * sigma;
+
+	int widthLower = static_cast<int>(std::floor(std::sqrt(12.0f * variance / passes + 1.0f)));
+	if (widthLower % 2 == 0) {
+		widthLower--;
+	}
+	int widthUpper = widthLower + 2;
+	int lowerPasses = static_cast<int>(std::round(
+		(12.0f * variance - passes * widthLower * widthLower - 4 * passes * widthLower - 3 * passes) / (-4.0f * widthLower - 4.0f)));
+
+	std::vector<float> temp(src, src + count);
+
+	for (int pass = 0; pass < passes; ++pass) {
+		int width = pass < lowerPasses ? widthLower : widthUpper;
+		BoxFilterChannel(temp.data(), dst, count, (width - 1) / 2);
+
+		if (pass + 1 < passes) {
+			std::copy(dst, dst + count, temp.begin());
+		}
+	}
+}
+
+
+std::vector<glm::vec3> TemporalFilter::GaussianFilterVectors(const std::vector<glm::vec3>& vectors, float sigma) {
+	const int count = static_cast<int>(vectors.size());
+	std::vector<glm::vec3> smoothedVectors(count);
+
+	if (count == 0) {
+		return smoothedVectors;
+	}
+
+	std::vector<float> channels(3 * count);
+	std::vector<float> smoothed(3 * count);
+
+	for (int i = 0; i < count; ++i) {
+		channels[i] = vectors[i].x;
+		channels[count + i] = vectors[i].y;
+		channels[2 * count + i] = vectors[i].z;
+	}
+
+	for (int c = 0; c < 3; ++c) {
+		GaussianFilter(channels.data() + c * count, smoothed.data() + c * count, count, sigma);
+	}
+
+	for (int i = 0; i < count; ++i) {
+		smoothedVectors[i] = glm::vec3(smoothed[i], smoothed[count + i], smoothed[2 * count + i]);
+	}
+
+	return smoothedVectors;
+}
+
+
+void TemporalFilter::AlignHemisphere(const std::vector<glm::quat>& quaternions, std::vector<float>& channels) {
+	const int count = static_cast<int>(quaternions.size());
+	channels.resize(4 * count);
+
+	// q and -q are the same rotation; flip to the hemisphere of the previous frame so linear blending is valid
+	glm::quat previous = count > 0 ? quaternions[0] : glm::quat();
+
+	for (int i = 0; i < count; ++i) {
+		glm::quat q = quaternions[i];
+		if (glm::dot(previous, q) < 0.0f) {
+			q = -q;
+		}
+		previous = q;
+
+		channels[i] = q.x;
+		channels[count + i] = q.y;
+		channels[2 * count + i] = q.z;
+		channels[3 * count + i] = q.w;
+	}
+}
+
+
+std::vector<glm::quat> TemporalFilter::SmoothQuaternionChannels(std::vector<float>& channels, int count, float sigma, bool exact) {
+	std::vector<float> smoothed(4 * count);
+
+	for (int c = 0; c < 4; ++c) {
+		GaussianFilter(channels.data() + c * count, smoothed.data() + c * count, count, sigma, exact);
+	}
+
+	std::vector<glm::quat> smoothedQuaternions(count);
+
+	for (int i = 0; i < count; ++i) {
+		glm::quat q(smoothed[3 * count + i], smoothed[i], smoothed[count + i], smoothed[2 * count + i]);
+		float length = glm::length(q);
+
+		if (length > 1e-6f) {
+			smoothedQuaternions[i] = q / length;
+		}
+		else {
+			// Degenerate blend, keep the input rotation
+			smoothedQuaternions[i] = glm::normalize(glm::quat(channels[3 * count + i], channels[i], channels[count + i], channels[2 * count + i]));
+		}
+	}
+
+	return smoothedQuaternions;
+}
+
+
+std::vector<glm::quat> TemporalFilter::ApplyGaussianFilter(const std::vector<glm::quat>& rotations, const std::vector<float>& weights, float sigma) {
+	const int count = static_cast<int>(rotations.size());
+
+	if (count == 0) {
+		return {};
+	}
+
+	std::vector<float> channels;
+	AlignHemisphere(rotations, channels);
+
+	// Premultiply by the frame weights, the normalization afterwards replaces the division by the total weight
+	for (int c = 0; c < 4; ++c) {
+		float* channel = channels.data() + c * count;
+		for (int i = 0; i < count; ++i) {
+			channel[i] *= weights[i];
+		}
+	}
+
+	return SmoothQuaternionChannels(channels, count, sigma);
+}
+
+// Function to compute adaptive weights
+std::vector<float> TemporalFilter::ComputeAdaptiveWeights(const std::vector<glm::quat>& rotations, float sigma) {
+	const int frameCount = static_cast<int>(rotations.size());
+	std::vector<float> weights(frameCount, 1.0f);
+
+	if (frameCount < 2) {
+		return weights;
+	}
+
+	const float invTwoSigmaSq = 1.0f / (2.0f * sigma * sigma);
+
+	for (int i = 1; i < frameCount; i++) {
+		// w component of inverse(q[i-1]) * q[i] for unit quaternions
+		float deltaW = glm::dot(rotations[i - 1], rotations[i]);
+		float angle = 2.0f * std::acos(glm::clamp(deltaW, -1.0f, 1.0f));
+
+		// Use the magnitude of the derivative as the weight
+		weights[i] = std::exp(-angle * angle * invTwoSigmaSq);
+	}
+
+	weights[0] = weights[1]; // Initialize the first weight
+	return weights;
+}
+
+// Main function to adaptively smooth root rotations
+std::vector<glm::quat> TemporalFilter::SmoothRootRotations(const std::vector<glm::quat>& rootRotations, float timeWindow) {
+	// Compute the standard deviation for the Gaussian filter
+	float sigma = timeWindow / 4.0f;
+
+	// Step 1: Compute the adaptive weights
+	std::vector<float> weights = ComputeAdaptiveWeights(rootRotations, sigma);
+
+	// Step 2: Apply the Gaussian filter using the adaptive weights
+	std::vector<glm::quat> smoothedRotations = ApplyGaussianFilter(rootRotations, weights, sigma);
+
+	return smoothedRotations;
+}
+
+
+// Gaussian filter for quaternions
+std::vector<glm::quat> TemporalFilter::GaussianFilterQuaternions(const std::vector<glm::quat>& quaternions, float sigma, bool exact) {
+	const int count = static_cast<int>(quaternions.size());
+
+	if (count == 0) {
+		return {};
+	}
+
+	std::vector<float> channels;
+	AlignHemisphere(quaternions, channels);
+
+	return SmoothQuaternionChannels(channels, count, sigma, exact);
+}
+
+
+TemporalFilter::IIRCoefficients TemporalFilter::ButterworthLowPass(int order, double cutoff) {
+	using Complex = std::complex<double>;
+	const double pi = 3.14159265358979323846;
+
+	// Analog prototype poles on the left half of the unit circle, scaled to the pre-warped cutoff
+	// and mapped to the z-plane with the bilinear transform (sampling frequency 2, i.e. 2 * fs = 4)
+	const double warped = 4.0 * std::tan(pi * cutoff / 2.0);
+	std::vector<Complex> poles(order);
+	Complex gainDenominator = 1.0;
+	for (int i = 0; i < order; i++) {
+		Complex analogPole = -std::exp(Complex(0.0, pi * (2 * i - order + 1) / (2.0 * order))) * warped;
+		poles[i] = (4.0 + analogPole) / (4.0 - analogPole);
+		gainDenominator *= 4.0 - analogPole;
+	}
+	const double gain = std::pow(warped, order) / gainDenominator.real();
+
+	// All zeros lie at z = -1, so the numerator is the binomial expansion of (1 + z^-1)^order
+	IIRCoefficients filter;
+	filter.b.assign(order + 1, 0.0);
+	filter.b[0] = gain;
+	for (int i = 1; i <= order; i++) {
+		filter.b[i] = filter.b[i - 1] * (order - i + 1) / i;
+	}
+
+	std::vector<Complex> denominator(order + 1, 0.0);
+	denominator[0] = 1.0;
+	for (int i = 0; i < order; i++) {
+		for (int j = i + 1; j > 0; j--) {
+			denominator[j] -= poles[i] * denominator[j - 1];
+		}
+	}
+	filter.a.resize(order + 1);
+	for (int i = 0; i <= order; i++) {
+		filter.a[i] = denominator[i].real();
+	}
+	return filter;
+}
+
+int TemporalFilter::ZeroPhasePadding(const IIRCoefficients& filter) {
+	return 3 * static_cast<int>(std::max(filter.a.size(), filter.b.size()));
+}
+
+// Initial state of the transposed direct form II for a unit step, as scipy.signal.lfilter_zi:
+// solves (I - A) zi = b[1:] - a[1:] * b[0], with A the transposed companion matrix of a
+std::vector<double> TemporalFilter::SteadyStateInitialConditions(const IIRCoefficients& filter) {
+	const int n = static_cast<int>(std::max(filter.a.size(), filter.b.size())) - 1;
+	std::vector<double> a(filter.a), b(filter.b);
+	a.resize(n + 1, 0.0);
+	b.resize(n + 1, 0.0);
+
+	// Augmented n x (n + 1) system
+	std::vector<double> m(n * (n + 1), 0.0);
+	auto at = [&](int row, int col) -> double& { return m[row * (n + 1) + col]; };
+	for (int row = 0; row < n; row++) {
+		at(row, row) += 1.0;
+		at(row, 0) += a[row + 1];
+		if (row + 1 < n) {
+			at(row, row + 1) -= 1.0;
+		}
+		at(row, n) = b[row + 1] - a[row + 1] * b[0];
+	}
+
+	// Gaussian elimination with partial pivoting
+	for (int col = 0; col < n; col++) {
+		int pivot = col;
+		for (int row = col + 1; row < n; row++) {
+			if (std::abs(at(row, col)) > std::abs(at(pivot, col))) {
+				pivot = row;
+			}
+		}
+		for (int k = 0; k <= n; k++) {
+			std::swap(at(col, k), at(pivot, k));
+		}
+		for (int row = col + 1; row < n; row++) {
+			double factor = at(row, col) / at(col, col);
+			for (int k = col; k <= n; k++) {
+				at(row, k) -= factor * at(col, k);
+			}
+		}
+	}
+
+	std::vector<double> zi(n);
+	for (int row = n - 1; row >= 0; row--) {
+		double sum = at(row, n);
+		for (int k = row + 1; k < n; k++) {
+			sum -= at(row, k) * zi[k];
+		}
+		zi[row] = sum / at(row, row);
+	}
+	return zi;
+}
+
+// Transposed direct form II over frame-major interleaved channels, in place.
+// The states of each frame's first sample are zi scaled by that sample.
+void TemporalFilter::FilterInterleaved(const IIRCoefficients& filter, const std::vector<double>& zi, double* data, int count, int channels) {
+	const int n = static_cast<int>(zi.size());
+	std::vector<double> a(filter.a), b(filter.b);
+	a.resize(n + 1, 0.0);
+	b.resize(n + 1, 0.0);
+
+	// State k of channel c at z[k * channels + c]
+	std::vector<double> z(n * channels);
+	for (int k = 0; k < n; k++) {
+		for (int c = 0; c < channels; c++) {
+			z[k * channels + c] = zi[k] * data[c];
+		}
+	}
+
+	for (int frame = 0; frame < count; frame++) {
+		double* x = data + frame * channels;
+		for (int c = 0; c < channels; c++) {
+			double in = x[c];
+			double out = b[0] * in + z[c];
+			for (int k = 0; k < n - 1; k++) {
+				z[k * channels + c] = b[k + 1] * in + z[(k + 1) * channels + c] - a[k + 1] * out;
+			}
+			z[(n - 1) * channels + c] = b[n] * in - a[n] * out;
+			x[c] = out;
+		}
+	}
+}
+
+bool TemporalFilter::ZeroPhaseFilter(const IIRCoefficients& filter, float* data, int count, int channels) {
+	const int padding = ZeroPhasePadding(filter);
+	if (count <= padding || channels <= 0) {
+		return false;
+	}
+
+	// Odd extension: 2 * x[0] - x[padding..1] | x | 2 * x[last] - x[last - 1..last - padding]
+	const int extendedCount = count + 2 * padding;
+	std::vector<double> extended(static_cast<size_t>(extendedCount) * channels);
+	for (int frame = 0; frame < extendedCount; frame++) {
+		double* dst = extended.data() + static_cast<size_t>(frame) * channels;
+		int src = frame - padding;
+		if (src < 0) {
+			const float* edge = data;
+			const float* mirror = data + static_cast<size_t>(-src) * channels;
+			for (int c = 0; c < channels; c++) dst[c] = 2.0 * edge[c] - mirror[c];
+		}
+		else if (src >= count) {
+			const float* edge = data + static_cast<size_t>(count - 1) * channels;
+			const float* mirror = data + static_cast<size_t>(2 * (count - 1) - src) * channels;
+			for (int c = 0; c < channels; c++) dst[c] = 2.0 * edge[c] - mirror[c];
+		}
+		else {
+			const float* in = data + static_cast<size_t>(src) * channels;
+			for (int c = 0; c < channels; c++) dst[c] = in[c];
+		}
+	}
+
+	const std::vector<double> zi = SteadyStateInitialConditions(filter);
+
+	// Forward pass, then the backward pass as a forward pass over the reversed frames
+	FilterInterleaved(filter, zi, extended.data(), extendedCount, channels);
+	for (int lo = 0, hi = extendedCount - 1; lo < hi; lo++, hi--) {
+		std::swap_ranges(extended.begin() + static_cast<size_t>(lo) * channels, extended.begin() + static_cast<size_t>(lo + 1) * channels,
+			extended.begin() + static_cast<size_t>(hi) * channels);
+	}
+	FilterInterleaved(filter, zi, extended.data(), extendedCount, channels);
+
+	// Reverse back while copying the original range out
+	for (int frame = 0; frame < count; frame++) {
+		const double* src = extended.data() + static_cast<size_t>(extendedCount - 1 - padding - frame) * channels;
+		float* dst = data + static_cast<size_t>(frame) * channels;
+		for (int c = 0; c < channels; c++) dst[c] = static_cast<float>(src[c]);
+	}
+	return true;
+}
@@ -0,0 +1,155 @@
+/*
+ ***************************************************************************************
+
+ *   Copyright (c) 2024 Filmakademie Baden-Wuerttemberg, Animationsinstitut R&D Labs
+ *   https://research.animationsinstitut.de/animhost
+ *   https://github.com/FilmakademieRnd/AnimHost
+ *    
+ *   AnimHost is a development by Filmakademie Baden-Wuerttemberg, Animationsinstitut
+ *   R&D Labs in the scope of the EU funded project MAX-R (101070072).
+ *    
+ *   This program is distributed in the hope that it will be useful, but WITHOUT
+ *   ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ *   FOR A PARTICULAR PURPOSE. See the MIT License for more details.
+ *   You should have received a copy of the MIT License along with this program; 
+ *   if not go to https://opensource.org/licenses/MIT
+
+ ***************************************************************************************
+ */
+
+ 
+#ifndef TEMPORALFILTER_H
+#define TEMPORALFILTER_H
+
+#include "animhostcore_global.h"
+
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+#include <vector>
+
+
+/**
+ * @class TemporalFilter
+ *
+ * @brief Smoothing filters over per frame sequences, e.g. root rotations of an animation.
+ *
+ * All filters are separable: quaternions are aligned to one hemisphere and their four components are
+ * smoothed as independent float channels, followed by a normalization. Gaussian kernels are precomputed
+ * once per sigma and cached. Kernels with a radius above LongWindowRadius are approximated by three
+ * sliding box filters, which costs O(n) independent of the window size, unless the exact kernel is requested.
+ * Sequence borders are handled by repeating the first and last frame.
+ * For resampling-free noise removal, e.g. of joint velocities, a zero-phase Butterworth filter is provided as well.
+ */
+class ANIMHOSTCORESHARED_EXPORT TemporalFilter {
+
+public:
+
+	//! Kernel radius in frames above which the Gaussian is approximated by repeated box filters
+	static constexpr int LongWindowRadius = 64;
+
+	/**
+	 * @brief Normalized Gaussian kernel with radius ceil(3 * sigma), cached per sigma.
+	 *
+	 * The returned reference stays valid for the lifetime of the program.
+	 *
+	 * @param sigma Standard deviation of the kernel in frames.
+	 * @return Kernel weights for the offsets -radius to radius, summing up to one.
+	 */
+	static const std::vector<float>& GaussianKernel(float sigma);
+
+	/**
+	 * @brief Gaussian filter for a single float channel.
+	 *
+	 * @param src Input values, count elements.
+	 * @param dst Output values, count elements. Must not alias src.
+	 * @param count Number of frames.
+	 * @param sigma Standard deviation of the kernel in frames.
+	 * @param exact Convolve with the full kernel also for radii above LongWindowRadius.
+	 */
+	static void GaussianFilter(const float* src, float* dst, int count, float sigma, bool exact = false);
+
+	/**
+	 * @brief Gaussian filter for vector sequences, e.g. joint velocities.
+	 */
+	static std::vector<glm::vec3> GaussianFilterVectors(const std::vector<glm::vec3>& vectors, float sigma);
+
+	/**
+	 * @brief Gaussian filter for quaternion sequences.
+	 *
+	 * @param quaternions Rotation per frame.
+	 * @param sigma Standard deviation of the kernel in frames.
+	 * @param exact Convolve with the full kernel also for radii above LongWindowRadius.
+	 * @return Smoothed rotation per frame.
+	 */
+	static std::vector<glm::quat> GaussianFilterQuaternions(const std::vector<glm::quat>& quaternions, float sigma, bool exact = false);
+
+	/**
+	 * @brief Gaussian filter for quaternion sequences with an additional weight per frame.
+	 */
+	static std::vector<glm::quat> ApplyGaussianFilter(const std::vector<glm::quat>& rotations, const std::vector<float>& weights, float sigma);
+
+	/**
+	 * @brief Per frame weights that decrease with the angular change to the previous frame.
+	 */
+	static std::vector<float> ComputeAdaptiveWeights(const std::vector<glm::quat>& rotations, float sigma);
+
+	/**
+	 * @brief Adaptive smoothing of root rotations, fast turns are smoothed less than jitter.
+	 *
+	 * @param rootRotations Root rotation per frame.
+	 * @param timeWindow Size of the smoothing window in frames.
+	 */
+	static std::vector<glm::quat> SmoothRootRotations(const std::vector<glm::quat>& rootRotations, float timeWindow);
+
+	/**
+	 * @brief Transfer function coefficients of an IIR filter, normalized to a[0] = 1.
+	 */
+	struct IIRCoefficients {
+		std::vector<double> b;	//!< Numerator (feedforward) coefficients
+		std::vector<double> a;	//!< Denominator (feedback) coefficients
+	};
+
+	/**
+	 * @brief Digital Butterworth low-pass filter, matching scipy.signal.butter(order, cutoff, "low").
+	 *
+	 * @param order Filter order.
+	 * @param cutoff Cutoff frequency normalized to the Nyquist frequency, in (0, 1).
+	 */
+	static IIRCoefficients ButterworthLowPass(int order, double cutoff);
+
+	/**
+	 * @brief Number of frames added at each border by ZeroPhaseFilter, 3 * max(len(a), len(b)) like filtfilt.
+	 */
+	static int ZeroPhasePadding(const IIRCoefficients& filter);
+
+	/**
+	 * @brief Forward-backward IIR filter over interleaved channels, matching scipy.signal.filtfilt with its default padding.
+	 *
+	 * The sequence is extended by odd reflection at both borders and the filter states are initialized to the
+	 * steady state of the first sample, so the result has zero phase shift and no start-up transient.
+	 * All channels of a frame are processed together, which keeps the inner loops contiguous.
+	 *
+	 * @param filter Filter coefficients.
+	 * @param data Frame-major samples, count * channels values, filtered in place.
+	 * @param count Number of frames, must be greater than ZeroPhasePadding(filter).
+	 * @param channels Number of values per frame.
+	 * @return false if the sequence is too short, data is left unchanged in that case.
+	 */
+	static bool ZeroPhaseFilter(const IIRCoefficients& filter, float* data, int count, int channels);
+
+private:
+
+	static void AlignHemisphere(const std::vector<glm::quat>& quaternions, std::vector<float>& channels);
+
+	static std::vector<glm::quat> SmoothQuaternionChannels(std::vector<float>& channels, int count, float sigma, bool exact = false);
+
+	static void ConvolveChannel(const float* src, float* dst, int count, const std::vector<float>& kernel);
+
+	static void BoxFilterChannel(const float* src, float* dst, int count, int radius);
+
+	static std::vector<double> SteadyStateInitialConditions(const IIRCoefficients& filter);
+
+	static void FilterInterleaved(const IIRCoefficients& filter, const std::vector<double>& zi, double* data, int count, int channels);
+};
+
+#endif // TEMPORALFILTER_H
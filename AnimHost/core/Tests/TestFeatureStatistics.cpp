@@ -0,0 +1,168 @@
+/*
+ ***************************************************************************************
+
+ *   Copyright (c) 2024 Filmakademie Baden-Wuerttemberg, Animationsinstitut R&D Labs
+ *   https://research.animationsinstitut.de/animhost
+ *   https://github.com/FilmakademieRnd/AnimHost
+ *    
+ *   AnimHost is a development by Filmakademie Baden-Wuerttemberg, Animationsinstitut
+ *   R&D Labs in the scope of the EU funded project MAX-R (101070072).
+ *    
+ *   This program is distributed in the hope that it will be useful, but WITHOUT
+ *   ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ *   FOR A PARTICULAR PURPOSE. See the MIT License for more details.
+ *   You should have received a copy of the MIT License along with this program; 
+ *   if not go to https://opensource.org/licenses/MIT
+
+ ***************************************************************************************
+ */
+
+
+/**
+ * @file TestFeatureStatistics.cpp
+ * @brief Checks the Welford accumulator against a two pass computation and its merge of partial results.
+ */
+
+#include <FeatureStatistics.h>
+
+#include <QtTest>
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+
+namespace {
+
+	constexpr int FeatureCount = 7;
+
+	// Rows with per feature offsets far from zero, where a naive sum of squares loses precision
+	std::vector<float> randomRows(int rowCount, std::uint32_t seed)
+	{
+		std::mt19937 rng(seed);
+		std::normal_distribution<float> noise(0.0f, 1.0f);
+
+		std::vector<float> rows(static_cast<size_t>(rowCount) * FeatureCount);
+		for (int row = 0; row < rowCount; row++) {
+			for (int feature = 0; feature < FeatureCount; feature++) {
+				rows[row * FeatureCount + feature] = 1000.0f * feature + (feature + 1) * noise(rng);
+			}
+		}
+		return rows;
+	}
+
+	void compareStatistics(const FeatureStatistics& actual, const FeatureStatistics& expected)
+	{
+		QCOMPARE(actual.featureCount(), expected.featureCount());
+		QCOMPARE(actual.count(), expected.count());
+
+		for (int feature = 0; feature < expected.featureCount(); feature++) {
+			QVERIFY2(std::abs(actual.mean(feature) - expected.mean(feature)) < 1e-9 * std::max(1.0, std::abs(expected.mean(feature))),
+				qPrintable(QString("mean of feature %1").arg(feature)));
+			QVERIFY2(std::abs(actual.variance(feature) - expected.variance(feature)) < 1e-9 * std::max(1.0, expected.variance(feature)),
+				qPrintable(QString("variance of feature %1").arg(feature)));
+		}
+	}
+
+}
+
+
+class TestFeatureStatistics : public QObject
+{
+	Q_OBJECT
+
+private slots:
+
+	void singlePassMatchesTwoPass()
+	{
+		const int rowCount = 5000;
+		const std::vector<float> rows = randomRows(rowCount, 1);
+
+		FeatureStatistics statistics(FeatureCount);
+		statistics.addRows(rows.data(), rowCount);
+
+		for (int feature = 0; feature < FeatureCount; feature++) {
+			double mean = 0.0;
+			for (int row = 0; row < rowCount; row++) {
+				mean += rows[row * FeatureCount + feature];
+			}
+			mean /= rowCount;
+
+			double squaredDifferences = 0.0;
+			for (int row = 0; row < rowCount; row++) {
+				double difference = rows[row * FeatureCount + feature] - mean;
+				squaredDifferences += difference * difference;
+			}
+
+			QVERIFY(std::abs(statistics.mean(feature) - mean) < 1e-9 * std::max(1.0, std::abs(mean)));
+			QVERIFY(std::abs(statistics.variance(feature) - squaredDifferences / (rowCount - 1)) < 1e-6);
+		}
+	}
+
+	void mergeMatchesSinglePass_data()
+	{
+		QTest::addColumn<int>("splitRow");
+
+		QTest::newRow("empty first") << 0;
+		QTest::newRow("one row first") << 1;
+		QTest::newRow("uneven") << 1234;
+		QTest::newRow("half") << 2500;
+		QTest::newRow("empty second") << 5000;
+	}
+
+	void mergeMatchesSinglePass()
+	{
+		QFETCH(int, splitRow);
+
+		const int rowCount = 5000;
+		const std::vector<float> rows = randomRows(rowCount, 2);
+
+		FeatureStatistics all(FeatureCount);
+		all.addRows(rows.data(), rowCount);
+
+		FeatureStatistics first(FeatureCount);
+		FeatureStatistics second(FeatureCount);
+		first.addRows(rows.data(), splitRow);
+		second.addRows(rows.data() + static_cast<size_t>(splitRow) * FeatureCount, rowCount - splitRow);
+
+		QVERIFY(first.merge(second));
+		compareStatistics(first, all);
+	}
+
+	void mergeRestoredState()
+	{
+		// Appending export runs continue from the serialized statistics of the earlier rows
+		const std::vector<float> rows = randomRows(300, 3);
+
+		FeatureStatistics all(FeatureCount);
+		all.addRows(rows.data(), 300);
+
+		FeatureStatistics earlier(FeatureCount);
+		earlier.addRows(rows.data(), 100);
+		const QByteArray state = earlier.toByteArray();
+
+		FeatureStatistics restored;
+		QVERIFY(restored.fromByteArray(state.constData(), state.size()));
+
+		FeatureStatistics later(FeatureCount);
+		later.addRows(rows.data() + 100 * FeatureCount, 200);
+
+		QVERIFY(restored.merge(later));
+		compareStatistics(restored, all);
+	}
+
+	void mergeRejectsDifferentLayout()
+	{
+		FeatureStatistics statistics(FeatureCount);
+		const std::vector<float> rows = randomRows(10, 4);
+		statistics.addRows(rows.data(), 10);
+
+		FeatureStatistics other(FeatureCount + 1);
+		QVERIFY(!statistics.merge(other));
+		QCOMPARE(statistics.count(), quint64(10));
+	}
+};
+
+QTEST_APPLESS_MAIN(TestFeatureStatistics)
+
+#include "TestFeatureStatistics.moc"
@@ -0,0 +1,206 @@
+/*
+ ***************************************************************************************
+
+ *   Copyright (c) 2024 Filmakademie Baden-Wuerttemberg, Animationsinstitut R&D Labs
+ *   https://research.animationsinstitut.de/animhost
+ *   https://github.com/FilmakademieRnd/AnimHost
+ *    
+ *   AnimHost is a development by Filmakademie Baden-Wuerttemberg, Animationsinstitut
+ *   R&D Labs in the scope of the EU funded project MAX-R (101070072).
+ *    
+ *   This program is distributed in the hope that it will be useful, but WITHOUT
+ *   ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ *   FOR A PARTICULAR PURPOSE. See the MIT License for more details.
+ *   You should have received a copy of the MIT License along with this program; 
+ *   if not go to https://opensource.org/licenses/MIT
+
+ ***************************************************************************************
+ */
+
+
+/**
+ * @file TestSkeleton.cpp
+ * @brief Checks the Skeleton lookup tables and the forward kinematics paths built on them.
+ */
+
+#include <Benchmark/ProceduralAnimation.h>
+#include <animhosthelper.h>
+#include <commondatatypes.h>
+
+#include <QtTest>
+
+#include <algorithm>
+#include <cmath>
+
+
+namespace {
+
+	// Procedural skeleton with all bone IDs shifted by offset, so the root bone is not bone 0
+	void buildShiftedSkeleton(int boneCount, int offset, Skeleton& skeleton)
+	{
+		Skeleton source;
+		ProceduralAnimation::BuildSkeleton(boneCount, source);
+
+		auto shifted = [boneCount, offset](int id) { return (id + offset) % boneCount; };
+
+		skeleton = Skeleton();
+		skeleton.mNumBones = source.mNumBones;
+		skeleton.rootBoneID = shifted(source.rootBoneID);
+
+		for (const auto& [name, id] : source.bone_names) {
+			skeleton.bone_names[name] = shifted(id);
+			skeleton.bone_names_reverse[shifted(id)] = name;
+		}
+		for (const auto& [id, children] : source.bone_hierarchy) {
+			std::vector<int>& shiftedChildren = skeleton.bone_hierarchy[shifted(id)];
+			for (int child : children) {
+				shiftedChildren.push_back(shifted(child));
+			}
+		}
+
+		skeleton.buildLookupTables();
+	}
+
+	// Copy of the maps only, forward kinematics on it takes the recursive path
+	Skeleton withoutLookupTables(const Skeleton& skeleton)
+	{
+		Skeleton copy;
+		copy.bone_names = skeleton.bone_names;
+		copy.bone_names_reverse = skeleton.bone_names_reverse;
+		copy.bone_hierarchy = skeleton.bone_hierarchy;
+		copy.mNumBones = skeleton.mNumBones;
+		copy.rootBoneID = skeleton.rootBoneID;
+		return copy;
+	}
+
+	bool fuzzyEqual(const std::vector<glm::mat4>& a, const std::vector<glm::mat4>& b)
+	{
+		if (a.size() != b.size()) {
+			return false;
+		}
+
+		for (size_t bone = 0; bone < a.size(); bone++) {
+			for (int col = 0; col < 4; col++) {
+				for (int row = 0; row < 4; row++) {
+					float x = a[bone][col][row];
+					float y = b[bone][col][row];
+					if (std::abs(x - y) > 1e-4f * std::max(1.0f, std::abs(x))) {
+						return false;
+					}
+				}
+			}
+		}
+		return true;
+	}
+
+}
+
+
+class TestSkeleton : public QObject
+{
+	Q_OBJECT
+
+private slots:
+
+	void fastPathMatchesRecursivePath_data()
+	{
+		QTest::addColumn<int>("boneCount");
+		QTest::addColumn<int>("rootOffset");
+
+		QTest::newRow("root 0") << 26 << 0;
+		QTest::newRow("root 7") << 26 << 7;
+		QTest::newRow("root 64 of 150") << 150 << 64;
+	}
+
+	void fastPathMatchesRecursivePath()
+	{
+		QFETCH(int, boneCount);
+		QFETCH(int, rootOffset);
+
+		Skeleton skeleton;
+		buildShiftedSkeleton(boneCount, rootOffset, skeleton);
+		QVERIFY(skeleton.hasLookupTables());
+		QCOMPARE(skeleton.getDepthFirstOrder().front(), skeleton.rootBoneID);
+
+		const Skeleton recursive = withoutLookupTables(skeleton);
+		QVERIFY(!recursive.hasLookupTables());
+
+		Animation animation;
+		ProceduralAnimation::BuildAnimation(skeleton, 120, 4, 11, animation);
+
+		std::vector<glm::mat4> fast;
+		std::vector<glm::mat4> reference;
+		for (int frame : { 0, 1, 37, 119 }) {
+			AnimHostHelper::ForwardKinematics(skeleton, animation, fast, frame);
+			AnimHostHelper::ForwardKinematics(recursive, animation, reference, frame);
+			QVERIFY2(fuzzyEqual(fast, reference), qPrintable(QString("frame %1").arg(frame)));
+		}
+	}
+
+	void editingHierarchyInvalidatesTables()
+	{
+		Skeleton skeleton;
+		ProceduralAnimation::BuildSkeleton(26, skeleton);
+		QVERIFY(skeleton.hasLookupTables());
+
+		// Move the first chain from the root under the tip of the second chain
+		const int chainStart = skeleton.bone_hierarchy.at(0).front();
+		const int newParent = skeleton.bone_hierarchy.at(0)[1];
+		std::vector<int>& rootChildren = skeleton.bone_hierarchy[0];
+		rootChildren.erase(rootChildren.begin());
+		skeleton.bone_hierarchy[newParent].push_back(chainStart);
+
+		QVERIFY(!skeleton.hasLookupTables());
+		QCOMPARE(skeleton.getParentBone(chainStart), newParent);
+
+		Animation animation;
+		ProceduralAnimation::BuildAnimation(skeleton, 60, 1, 5, animation);
+
+		std::vector<glm::mat4> stale;
+		AnimHostHelper::ForwardKinematics(skeleton, animation, stale, 30);
+
+		skeleton.buildLookupTables();
+		QVERIFY(skeleton.hasLookupTables());
+		QCOMPARE(skeleton.getParentBone(chainStart), newParent);
+
+		std::vector<glm::mat4> rebuilt;
+		AnimHostHelper::ForwardKinematics(skeleton, animation, rebuilt, 30);
+		QVERIFY(fuzzyEqual(stale, rebuilt));
+	}
+
+	void editingNamesOrRootInvalidatesTables()
+	{
+		Skeleton skeleton;
+		ProceduralAnimation::BuildSkeleton(26, skeleton);
+
+		skeleton.bone_names["renamed"] = 3;
+		QVERIFY(!skeleton.hasLookupTables());
+		QCOMPARE(skeleton.getBoneIndex("renamed"), 3);
+
+		skeleton.buildLookupTables();
+		QVERIFY(skeleton.hasLookupTables());
+
+		skeleton.rootBoneID = 1;
+		QVERIFY(!skeleton.hasLookupTables());
+	}
+
+	void readingKeepsTables()
+	{
+		Skeleton skeleton;
+		ProceduralAnimation::BuildSkeleton(26, skeleton);
+
+		QVERIFY(skeleton.bone_hierarchy.find(5) != skeleton.bone_hierarchy.end());
+		QCOMPARE(skeleton.bone_names.at("root"), 0);
+		Skeleton subSkeleton = skeleton.CreateSubSkeleton("bone_1", {});
+
+		QVERIFY(skeleton.hasLookupTables());
+		QVERIFY(subSkeleton.hasLookupTables());
+
+		const Skeleton copy = skeleton;
+		QVERIFY(copy.hasLookupTables());
+	}
+};
+
+QTEST_APPLESS_MAIN(TestSkeleton)
+
+#include "TestSkeleton.moc"
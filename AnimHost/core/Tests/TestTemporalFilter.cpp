@@ -0,0 +1,162 @@
+/*
+ ***************************************************************************************
+
+ *   Copyright (c) 2024 Filmakademie Baden-Wuerttemberg, Animationsinstitut R&D Labs
+ *   https://research.animationsinstitut.de/animhost
+ *   https://github.com/FilmakademieRnd/AnimHost
+ *    
+ *   AnimHost is a development by Filmakademie Baden-Wuerttemberg, Animationsinstitut
+ *   R&D Labs in the scope of the EU funded project MAX-R (101070072).
+ *    
+ *   This program is distributed in the hope that it will be useful, but WITHOUT
+ *   ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ *   FOR A PARTICULAR PURPOSE. See the MIT License for more details.
+ *   You should have received a copy of the MIT License along with this program; 
+ *   if not go to https://opensource.org/licenses/MIT
+
+ ***************************************************************************************
+ */
+
+
+/**
+ * @file TestTemporalFilter.cpp
+ * @brief Compares the cached kernel Gaussian filters against a direct reference convolution.
+ */
+
+#include <TemporalFilter.h>
+
+#include <QtTest>
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+
+namespace {
+
+	// Direct convolution with border clamping, weights computed per tap in double precision
+	std::vector<double> referenceGaussian(const std::vector<float>& values, float sigma)
+	{
+		const int count = static_cast<int>(values.size());
+		const int kernelRadius = static_cast<int>(std::ceil(3.0f * sigma));
+
+		std::vector<double> result(count);
+		for (int i = 0; i < count; i++) {
+			double weightedSum = 0.0;
+			double totalWeight = 0.0;
+			for (int j = -kernelRadius; j <= kernelRadius; j++) {
+				double weight = std::exp(-(double(j) * j) / (2.0 * sigma * sigma));
+				weightedSum += weight * values[std::clamp(i + j, 0, count - 1)];
+				totalWeight += weight;
+			}
+			result[i] = weightedSum / totalWeight;
+		}
+		return result;
+	}
+
+	// Noisy turning yaw rotation, like a root rotation of a walk with changing heading
+	std::vector<glm::quat> turningRotations(int count)
+	{
+		std::mt19937 rng(7);
+		std::normal_distribution<float> jitter(0.0f, 0.05f);
+
+		std::vector<glm::quat> rotations(count);
+		for (int i = 0; i < count; i++) {
+			float yaw = 2.0f * std::sin(i * 0.01f) + jitter(rng);
+			rotations[i] = glm::angleAxis(yaw, glm::vec3(0.0f, 1.0f, 0.0f));
+		}
+		return rotations;
+	}
+
+}
+
+
+class TestTemporalFilter : public QObject
+{
+	Q_OBJECT
+
+private slots:
+
+	void sigma30UsesLongWindow()
+	{
+		// Guards the premise of the tests below, sigma 30 must be past the box filter threshold
+		QVERIFY(static_cast<int>(std::ceil(3.0f * 30.0f)) > TemporalFilter::LongWindowRadius);
+	}
+
+	void exactChannelMatchesReference()
+	{
+		const float sigma = 30.0f;
+
+		std::mt19937 rng(3);
+		std::uniform_real_distribution<float> noise(-1.0f, 1.0f);
+		std::vector<float> values(400);
+		for (size_t i = 0; i < values.size(); i++) {
+			values[i] = std::sin(i * 0.05f) + 0.2f * noise(rng);
+		}
+
+		std::vector<float> filtered(values.size());
+		TemporalFilter::GaussianFilter(values.data(), filtered.data(), static_cast<int>(values.size()), sigma, true);
+
+		const std::vector<double> reference = referenceGaussian(values, sigma);
+		for (size_t i = 0; i < values.size(); i++) {
+			QVERIFY2(std::abs(filtered[i] - reference[i]) < 1e-5, qPrintable(QString("frame %1").arg(i)));
+		}
+	}
+
+	void exactQuaternionsMatchReference()
+	{
+		const float sigma = 30.0f;
+		const int count = 400;
+
+		const std::vector<glm::quat> rotations = turningRotations(count);
+		const std::vector<glm::quat> filtered = TemporalFilter::GaussianFilterQuaternions(rotations, sigma, true);
+		QCOMPARE(static_cast<int>(filtered.size()), count);
+
+		// All rotations share one hemisphere, so the reference filters the components directly
+		std::vector<float> channels[4];
+		for (int c = 0; c < 4; c++) {
+			channels[c].resize(count);
+			for (int i = 0; i < count; i++) {
+				channels[c][i] = rotations[i][c];
+			}
+		}
+
+		std::vector<double> smoothed[4];
+		for (int c = 0; c < 4; c++) {
+			smoothed[c] = referenceGaussian(channels[c], sigma);
+		}
+
+		for (int i = 0; i < count; i++) {
+			double length = std::sqrt(smoothed[0][i] * smoothed[0][i] + smoothed[1][i] * smoothed[1][i]
+				+ smoothed[2][i] * smoothed[2][i] + smoothed[3][i] * smoothed[3][i]);
+
+			for (int c = 0; c < 4; c++) {
+				QVERIFY2(std::abs(filtered[i][c] - smoothed[c][i] / length) < 1e-5,
+					qPrintable(QString("frame %1 component %2").arg(i).arg(c)));
+			}
+		}
+	}
+
+	void shortWindowMatchesReference()
+	{
+		// Below LongWindowRadius the default path convolves with the cached kernel as well
+		const float sigma = 5.0f;
+
+		std::vector<float> values(200);
+		for (size_t i = 0; i < values.size(); i++) {
+			values[i] = std::cos(i * 0.1f);
+		}
+
+		std::vector<float> filtered(values.size());
+		TemporalFilter::GaussianFilter(values.data(), filtered.data(), static_cast<int>(values.size()), sigma);
+
+		const std::vector<double> reference = referenceGaussian(values, sigma);
+		for (size_t i = 0; i < values.size(); i++) {
+			QVERIFY2(std::abs(filtered[i] - reference[i]) < 1e-5, qPrintable(QString("frame %1").arg(i)));
+		}
+	}
+};
+
+QTEST_APPLESS_MAIN(TestTemporalFilter)
+
+#include "TestTemporalFilter.moc"
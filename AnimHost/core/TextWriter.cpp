@@ -0,0 +1,187 @@
+/*
+ ***************************************************************************************
+
+ *   Copyright (c) 2024 Filmakademie Baden-Wuerttemberg, Animationsinstitut R&D Labs
+ *   https://research.animationsinstitut.de/animhost
+ *   https://github.com/FilmakademieRnd/AnimHost
+ *    
+ *   AnimHost is a development by Filmakademie Baden-Wuerttemberg, Animationsinstitut
+ *   R&D Labs in the scope of the EU funded project MAX-R (101070072).
+ *    
+ *   This program is distributed in the hope that it will be useful, but WITHOUT
+ *   ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ *   FOR A PARTICULAR PURPOSE. See the MIT License for more details.
+ *   You should have received a copy of the MIT License along with this program; 
+ *   if not go to https://opensource.org/licenses/MIT
+
+ ***************************************************************************************
+ */
+
+ 
+
+#include "TextWriter.h"
+
+#include <QDebug>
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+
+
+TextWriter::TextWriter(size_t bufferSize) : _flushThreshold(bufferSize)
+{
+	_buffer.resize(bufferSize + 64);
+}
+
+TextWriter::~TextWriter()
+{
+	close();
+}
+
+bool TextWriter::open(const QString& filePath, bool append, bool textMode)
+{
+	close();
+
+	_file.setFileName(filePath);
+
+	QIODevice::OpenMode mode = QIODevice::WriteOnly | (append ? QIODevice::Append : QIODevice::Truncate);
+	if (textMode) {
+		mode |= QIODevice::Text;
+	}
+
+	if (!_file.open(mode)) {
+		qWarning() << "[TextWriter] Could not open" << filePath << ":" << _file.errorString();
+		return false;
+	}
+	return true;
+}
+
+void TextWriter::close()
+{
+	if (_file.isOpen()) {
+		flush();
+		_file.close();
+	}
+}
+
+bool TextWriter::flush()
+{
+	if (!_file.isOpen() || _used == 0) {
+		return true;
+	}
+
+	qint64 written = _file.write(_buffer.data(), static_cast<qint64>(_used));
+	_used = 0;
+
+	if (written < 0) {
+		qWarning() << "[TextWriter] Writing" << _file.fileName() << "failed:" << _file.errorString();
+		return false;
+	}
+	return true;
+}
+
+char* TextWriter::reserve(size_t count)
+{
+	if (_used + count > _buffer.size()) {
+		if (_file.isOpen() && _used > 0) {
+			flush();
+		}
+		if (_used + count > _buffer.size()) {
+			_buffer.resize(std::max(_buffer.size() * 2, _used + count));
+		}
+	}
+	return _buffer.data() + _used;
+}
+
+TextWriter& TextWriter::operator<<(float value)
+{
+	// 32 chars hold any shortest round-trip float, e.g. -1.17549435e-38
+	char* out = reserve(32);
+	_used += std::to_chars(out, out + 32, value).ptr - out;
+
+	if (_used >= _flushThreshold) {
+		flush();
+	}
+	return *this;
+}
+
+TextWriter& TextWriter::operator<<(int value)
+{
+	char* out = reserve(16);
+	_used += std::to_chars(out, out + 16, value).ptr - out;
+	return *this;
+}
+
+TextWriter& TextWriter::operator<<(char value)
+{
+	*reserve(1) = value;
+	_used++;
+	return *this;
+}
+
+TextWriter& TextWriter::operator<<(const char* value)
+{
+	append(value, std::strlen(value));
+	return *this;
+}
+
+TextWriter& TextWriter::operator<<(const std::string& value)
+{
+	append(value.data(), value.size());
+	return *this;
+}
+
+TextWriter& TextWriter::operator<<(const QString& value)
+{
+	QByteArray utf8 = value.toUtf8();
+	append(utf8.constData(), utf8.size());
+	return *this;
+}
+
+TextWriter& TextWriter::operator<<(const QByteArray& value)
+{
+	append(value.constData(), value.size());
+	return *this;
+}
+
+void TextWriter::writeFloats(const float* values, int count, char separator)
+{
+	// Reserve the whole row at once, a float takes at most 31 chars plus separator
+	char* out = reserve(static_cast<size_t>(count) * 32);
+	char* const begin = out;
+
+	for (int i = 0; i < count; i++) {
+		out = std::to_chars(out, out + 31, values[i]).ptr;
+		if (i != count - 1) {
+			*out++ = separator;
+		}
+	}
+	_used += out - begin;
+
+	if (_used >= _flushThreshold) {
+		flush();
+	}
+}
+
+void TextWriter::append(const TextWriter& other)
+{
+	append(other.data(), other.size());
+}
+
+void TextWriter::append(const char* text, size_t size)
+{
+	// Large blocks go straight to the file instead of through the buffer
+	if (_file.isOpen() && size >= _flushThreshold) {
+		flush();
+		if (_file.write(text, static_cast<qint64>(size)) < 0) {
+			qWarning() << "[TextWriter] Writing" << _file.fileName() << "failed:" << _file.errorString();
+		}
+		return;
+	}
+
+	std::memcpy(reserve(size), text, size);
+	_used += size;
+
+	if (_used >= _flushThreshold) {
+		flush();
+	}
+}
@@ -0,0 +1,105 @@
+/*
+ ***************************************************************************************
+
+ *   Copyright (c) 2024 Filmakademie Baden-Wuerttemberg, Animationsinstitut R&D Labs
+ *   https://research.animationsinstitut.de/animhost
+ *   https://github.com/FilmakademieRnd/AnimHost
+ *    
+ *   AnimHost is a development by Filmakademie Baden-Wuerttemberg, Animationsinstitut
+ *   R&D Labs in the scope of the EU funded project MAX-R (101070072).
+ *    
+ *   This program is distributed in the hope that it will be useful, but WITHOUT
+ *   ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ *   FOR A PARTICULAR PURPOSE. See the MIT License for more details.
+ *   You should have received a copy of the MIT License along with this program; 
+ *   if not go to https://opensource.org/licenses/MIT
+
+ ***************************************************************************************
+ */
+
+ 
+
+#ifndef TEXTWRITER_H
+#define TEXTWRITER_H
+
+#include "animhostcore_global.h"
+
+#include <QFile>
+#include <QString>
+#include <QByteArray>
+#include <vector>
+#include <string>
+
+
+/**
+ * @class TextWriter
+ * @brief Buffered writer for large text exports such as CSV and sequence identifier files.
+ *
+ * Values are formatted directly into one reusable char buffer, floats with the shortest representation
+ * that reads back to the same value (std::to_chars). The buffer is written to the file in one call once it
+ * exceeds its size and on flush() or close().
+ *
+ * A writer without an open file only collects text. Worker threads can format independent parts of an
+ * export into such writers, which are then appended to the file writer in order with append(const TextWriter&).
+ */
+class ANIMHOSTCORESHARED_EXPORT TextWriter
+{
+public:
+	static constexpr size_t DefaultBufferSize = 8 * 1024 * 1024; //!< Default flush threshold in bytes
+
+private:
+	QFile _file;
+	std::vector<char> _buffer;
+	size_t _used = 0;
+	size_t _flushThreshold;
+
+	//! Returns space for at least \c count further chars at the end of the buffer
+	char* reserve(size_t count);
+
+public:
+	explicit TextWriter(size_t bufferSize = DefaultBufferSize);
+	~TextWriter();
+
+	TextWriter(const TextWriter&) = delete;
+	TextWriter& operator=(const TextWriter&) = delete;
+
+	/**
+	 * @brief Opens \c filePath, truncating it unless \c append is set.
+	 * @param textMode Open in QIODevice::Text mode, i.e. with platform line endings.
+	 * @return False if the file could not be opened.
+	 */
+	bool open(const QString& filePath, bool append, bool textMode = true);
+
+	//! Writes pending text and closes the file
+	void close();
+
+	bool isOpen() const { return _file.isOpen(); }
+
+	//! Writes pending text to the file. Without open file the text is kept
+	bool flush();
+
+	//! Drops pending text
+	void clear() { _used = 0; }
+
+	const char* data() const { return _buffer.data(); }
+	size_t size() const { return _used; }
+
+	TextWriter& operator<<(float value);
+	TextWriter& operator<<(int value);
+	TextWriter& operator<<(char value);
+	TextWriter& operator<<(const char* value);
+	TextWriter& operator<<(const std::string& value);
+	TextWriter& operator<<(const QString& value);
+	TextWriter& operator<<(const QByteArray& value);
+
+	//! Writes \c count floats separated by \c separator, without trailing separator
+	void writeFloats(const float* values, int count, char separator = ',');
+
+	//! Appends the pending text of \c other, e.g. a part formatted on a worker thread
+	void append(const TextWriter& other);
+
+	//! Appends \c size raw chars
+	void append(const char* text, size_t size);
+};
+
+#endif // TEXTWRITER_H
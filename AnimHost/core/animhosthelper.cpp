@@ -51,8 +51,24 @@ QString AnimHostHelper::shortenFilePath(const QString& filePath, int maxLength)
 void AnimHostHelper::ForwardKinematics(const Skeleton& skeleton, const Animation& animation, std::vector<glm::mat4>& outTransforms, int frame){
     
     
-    outTransforms = std::vector<glm::mat4>(skeleton.mNumBones);
+    // Reuse the caller's buffer, every reachable bone is overwritten below
+    outTransforms.resize(skeleton.mNumBones);
 
+    if (skeleton.hasLookupTables()) {
+        // Parents precede their children in depth first order, a single pass over flat arrays suffices
+        for (int currentBone : skeleton.getDepthFirstOrder()) {
+            const Bone& bone = animation.mBones[currentBone];
+
+            glm::mat4 local_transform = glm::translate(glm::mat4(1.0f), bone.GetPosition(frame))
+                * glm::toMat4(bone.GetOrientation(frame))
+                * glm::scale(glm::mat4(1.0f), bone.GetScale(frame));
+
+            // The traversal starts at the root bone, like the recursive path its parents are not applied
+            int parentBone = currentBone == skeleton.rootBoneID ? -1 : skeleton.getParentBone(currentBone);
+            outTransforms[currentBone] = parentBone == -1 ? local_transform : outTransforms[parentBone] * local_transform;
+        }
+        return;
+    }
 
     std::function<void(glm::mat4, int)> buildTranforms;
 
@@ -84,12 +100,48 @@ void AnimHostHelper::ForwardKinematics(const Skeleton& skeleton, const Animation
         }
     };
 
-    int initcurrentBone = 0; //todo set specific root bone idx  s
+    int initcurrentBone = skeleton.rootBoneID;
     glm::mat4 initcurrentPos(1.0f);
     buildTranforms(initcurrentPos, initcurrentBone);
 
 }
 
+void AnimHostHelper::ComputeKinematics(const Skeleton& skeleton, const Animation& animation, PoseSequence& outPoses, JointVelocitySequence& outVelocities, float frameRate) {
+    const int nFrames = animation.mDurationFrames;
+    const int nBones = skeleton.mNumBones;
+
+    outPoses.mPoseSequence.resize(nFrames, nBones);
+    outVelocities.mJointVelocitySequence.resize(nFrames, nBones);
+
+    std::vector<glm::mat4> transforms(nBones);
+    std::vector<glm::vec3> prevRootSpace(nBones);
+    std::vector<glm::vec3> currRootSpace(nBones);
+
+    for (int frame = 0; frame < nFrames; frame++) {
+        ForwardKinematics(skeleton, animation, transforms, frame);
+
+        // No parent is applied to the root bone, so its global transform equals animation.mBones[rootBoneID].GetTransform(frame)
+        const glm::mat4 invRoot = glm::inverse(transforms[skeleton.rootBoneID]);
+
+        FrameSpan<glm::vec3> positions = outPoses.mPoseSequence[frame];
+        for (int bone = 0; bone < nBones; bone++) {
+            positions[bone] = glm::vec3(transforms[bone][3]);
+            currRootSpace[bone] = invRoot * glm::vec4(positions[bone], 1.0f);
+        }
+
+        // The first frame is differenced with itself, i.e. has zero velocity
+        if (frame == 0)
+            prevRootSpace = currRootSpace;
+
+        FrameSpan<glm::vec3> velocities = outVelocities.mJointVelocitySequence[frame];
+        for (int bone = 0; bone < nBones; bone++) {
+            velocities[bone] = (currRootSpace[bone] - prevRootSpace[bone]) * frameRate / 100.f;
+        }
+
+        std::swap(prevRootSpace, currRootSpace);
+    }
+}
+
 int AnimHostHelper::FindParentBone(const std::map<int, std::vector<int>>& bone_hierarchy, int currentBone)
 {
     //search map values for current bone id and return the key/parent bone id
@@ -107,6 +159,11 @@ int AnimHostHelper::FindParentBone(const std::map<int, std::vector<int>>& bone_h
     return -1;
 }
 
+int AnimHostHelper::FindParentBone(const Skeleton& skeleton, int currentBone)
+{
+    return skeleton.getParentBone(currentBone);
+}
+
 glm::vec3 AnimHostHelper::ProjectPointOnGroundPlane(const glm::vec3& point, glm::vec3 groundNormal)
 {
 	//Project point on ground plane
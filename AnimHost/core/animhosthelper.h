@@ -38,8 +38,24 @@ public:
 
 	static void ForwardKinematics(const Skeleton& skeleton, const Animation& animation, std::vector<glm::mat4>& outTransforms, int frame);
 
+	/**
+	 * @brief Global joint positions and root-relative joint velocities of a whole clip in one pass over the frames.
+	 *
+	 * Per frame, forward kinematics runs once, the root transform is inverted once and the root-relative positions
+	 * of the previous frame are reused for the finite difference. Results match JointPositionPlugin and JointVelocityPlugin.
+	 *
+	 * @param skeleton Skeleton of the animation.
+	 * @param animation Animation to evaluate.
+	 * @param outPoses Global joint position per frame, resized to the clip length.
+	 * @param outVelocities Joint velocity in the root space per frame in m/s (positions in cm), resized to the clip length.
+	 * @param frameRate Frame rate of the animation, used to scale the finite difference.
+	 */
+	static void ComputeKinematics(const Skeleton& skeleton, const Animation& animation, PoseSequence& outPoses, JointVelocitySequence& outVelocities, float frameRate = 60.f);
+
 	static int FindParentBone(const std::map<int, std::vector<int>>& bone_hierarchy, int currentBone);
 
+	static int FindParentBone(const Skeleton& skeleton, int currentBone);
+
 	static glm::vec3 ProjectPointOnGroundPlane(const glm::vec3& point, glm::vec3 groundNormal = glm::vec3(0, 1, 0));
 	/*
 	* @brief: This function returns Coordinate system transformation matrix swapping the Y and Z axis and negating the new Z axis
@@ -60,7 +60,7 @@ void AnimHostOperationNode::compute()
     {
         auto nodeData = createAnimNodeDataFromID(var.metaType());
         nodeData->setVariant(var);
-        _dataOut[counter] = nodeData;
+        _dataOut[counter++] = nodeData;
     }
 
     for (int i = 0; i < _dataOut.size(); i++)
@@ -26,8 +26,18 @@
 #include <glm/gtx/quaternion.hpp>
 #include <glm/ext/quaternion_float.hpp>
 #include <glm/gtx/matrix_decompose.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
 //#include "AssimpHelper.h"
 
+quint64 MapGeneration::next()
+{
+	static std::atomic<quint64> counter{ 0 };
+	return ++counter;
+}
+
 Bone::Bone(std::string name, int id, int numPos, int numRot, int numScl, glm::mat4 rest)
 {
 	mName = name;
@@ -66,45 +76,105 @@ Bone::Bone()
 	mRestingTransform = glm::mat4(1.0f);
 }
 
-glm::quat Bone::GetOrientation(int frame) const
-{
-	if(mRotationKeys.empty())
-		return glm::quat(1.0, 0.0, 0.0, 0.0); // Retunr identity quaternion, if no rotation keys are available
+namespace {
 
-	if (mRotationKeys.size() == 1)
-		return mRotationKeys[0].orientation; // Return the only available rotation key
+	// Detects channels with exactly one key per integer frame and no gaps
+	template<typename Key>
+	KeySampling DetectSampling(const std::vector<Key>& keys)
+	{
+		KeySampling sampling;
+		sampling.keyCount = keys.size();
 
-	float time = static_cast<float>(frame); // We assume that time is frame number
+		if (keys.empty() || keys.front().timeStamp != std::floor(keys.front().timeStamp))
+			return sampling;
 
-	// Compare for requested time and available time on keys
-	auto compareTime = [](const KeyRotation& key, float time) {
-		return key.timeStamp < time;
-    };
+		const float firstTime = keys.front().timeStamp;
+		for (size_t i = 0; i < keys.size(); i++) {
+			if (keys[i].timeStamp != firstTime + static_cast<float>(i))
+				return sampling;
+		}
 
-	// Find the keyframe that is less than or equal to the requested time
-	auto it = std::lower_bound(mRotationKeys.begin(), mRotationKeys.end(), time, compareTime);
+		sampling.uniform = true;
+		sampling.firstFrame = static_cast<int>(firstTime);
+		return sampling;
+	}
 
+	// Samples consecutive frames of a channel with at least two keys.
+	// Uniform channels are read by index, all others interpolate between the keys around each frame.
+	template<typename Key, typename Value, typename GetValue, typename Blend>
+	void SampleChannel(const std::vector<Key>& keys, const KeySampling& sampling, int startFrame, int count, Value* out, GetValue getValue, Blend blend)
+	{
+		if (sampling.uniform && sampling.keyCount == keys.size()) {
+			for (int i = 0; i < count; i++) {
+				out[i] = getValue(keys[sampling.keyIndex(startFrame + i)]);
+			}
+			return;
+		}
+
+		// Compare for requested time and available time on keys
+		auto compareTime = [](const Key& key, float time) {
+			return key.timeStamp < time;
+		};
 
-	if (it == mRotationKeys.end()) {
-		// Time is after the last keyframe
-		return mRotationKeys.back().orientation;
-	}
-	else if (it == mRotationKeys.begin()) {
-		// Time is before the first keyframe
-		return mRotationKeys.front().orientation;
+		// Frames increase, so the search for the next frame can start at the previous left key
+		auto searchStart = keys.begin();
+
+		for (int i = 0; i < count; i++) {
+			float time = static_cast<float>(startFrame + i); // We assume that time is frame number
+
+			// Find the keyframe that is less than or equal to the requested time
+			auto it = std::lower_bound(searchStart, keys.end(), time, compareTime);
+
+			if (it == keys.end()) {
+				// Time is after the last keyframe
+				out[i] = getValue(keys.back());
+				searchStart = keys.end() - 1;
+			}
+			else if (it == keys.begin()) {
+				// Time is before the first keyframe
+				out[i] = getValue(keys.front());
+			}
+			else {
+				// Interpolate between the two keyframes
+				auto right = it;
+				auto left = it - 1;
+
+				float deltaTime = right->timeStamp - left->timeStamp;
+				float factor = (time - left->timeStamp) / deltaTime;
+				factor = glm::clamp(factor, 0.0f, 1.0f);
+
+				out[i] = blend(getValue(*left), getValue(*right), factor);
+				searchStart = left;
+			}
+		}
 	}
-	else {
-		// Interpolate between the two keyframes
-		auto right = it;
-		auto left = it - 1;
 
-		float deltaTime = right->timeStamp - left->timeStamp;
-		float factor = (time - left->timeStamp) / deltaTime;
-		factor = glm::clamp(factor, 0.0f, 1.0f);
+	const auto orientationOf = [](const KeyRotation& key) { return key.orientation; };
+	const auto positionOf = [](const KeyPosition& key) { return key.position; };
+	const auto scaleOf = [](const KeyScale& key) { return key.scale; };
 
-		return glm::slerp(left->orientation, right->orientation, factor);
+	const auto slerpOrientation = [](const glm::quat& a, const glm::quat& b, float factor) { return glm::slerp(a, b, factor); };
+	const auto mixVector = [](const glm::vec3& a, const glm::vec3& b, float factor) { return glm::mix(a, b, factor); };
+}
 
-	}
+void Bone::UpdateSampling()
+{
+	mPositionSampling = DetectSampling(mPositonKeys);
+	mRotationSampling = DetectSampling(mRotationKeys);
+	mScaleSampling = DetectSampling(mScaleKeys);
+}
+
+glm::quat Bone::GetOrientation(int frame) const
+{
+	if(mRotationKeys.empty())
+		return glm::quat(1.0, 0.0, 0.0, 0.0); // Retunr identity quaternion, if no rotation keys are available
+
+	if (mRotationKeys.size() == 1)
+		return mRotationKeys[0].orientation; // Return the only available rotation key
+
+	glm::quat orientation;
+	SampleChannel(mRotationKeys, mRotationSampling, frame, 1, &orientation, orientationOf, slerpOrientation);
+	return orientation;
 }
 
 void Bone::SetOrientation(int frame, glm::quat ori)
@@ -119,37 +189,9 @@ glm::vec3 Bone::GetPosition(int frame) const
 	if (mPositonKeys.size() == 1)
 		return mPositonKeys[0].position; // Return the only available position key
 
-	float time = static_cast<float>(frame); // We assume that time is frame number
-
-	// Compare for requested time and available time on keys
-	auto compareTime = [](const KeyPosition& key, float time) {
-		return key.timeStamp < time;
-		};
-
-	// Find the keyframe that is less than or equal to the requested time
-	auto it = std::lower_bound(mPositonKeys.begin(), mPositonKeys.end(), time, compareTime);
-
-
-	if (it == mPositonKeys.end()) {
-		// Time is after the last keyframe
-		return mPositonKeys.back().position;
-	}
-	else if (it == mPositonKeys.begin()) {
-		// Time is before the first keyframe
-		return mPositonKeys.front().position;
-	}
-	else {
-		// Interpolate between the two keyframes
-		auto right = it;
-		auto left = it - 1;
-
-		float deltaTime = right->timeStamp - left->timeStamp;
-		float factor = (time - left->timeStamp) / deltaTime;
-		factor = glm::clamp(factor, 0.0f, 1.0f);
-
-		return glm::mix(left->position, right->position, factor);
-
-	}
+	glm::vec3 position;
+	SampleChannel(mPositonKeys, mPositionSampling, frame, 1, &position, positionOf, mixVector);
+	return position;
 }
 
 glm::vec3 Bone::GetScale(int frame) const
@@ -160,37 +202,39 @@ glm::vec3 Bone::GetScale(int frame) const
 	if (mScaleKeys.size() == 1)
 		return mScaleKeys[0].scale; // Return the only available scale key
 
-	float time = static_cast<float>(frame); // We assume that time is frame number
-
-	// Compare for requested time and available time on keys
-	auto compareTime = [](const KeyScale& key, float time) {
-		return key.timeStamp < time;
-		};
+	glm::vec3 scale;
+	SampleChannel(mScaleKeys, mScaleSampling, frame, 1, &scale, scaleOf, mixVector);
+	return scale;
+}
 
-	// Find the keyframe that is less than or equal to the requested time
-	auto it = std::lower_bound(mScaleKeys.begin(), mScaleKeys.end(), time, compareTime);
+void Bone::SampleOrientationRange(int startFrame, int count, glm::quat* out) const
+{
+	if (mRotationKeys.size() < 2) {
+		std::fill(out, out + count, GetOrientation(startFrame));
+		return;
+	}
 
+	SampleChannel(mRotationKeys, mRotationSampling, startFrame, count, out, orientationOf, slerpOrientation);
+}
 
-	if (it == mScaleKeys.end()) {
-		// Time is after the last keyframe
-		return mScaleKeys.back().scale;
-	}
-	else if (it == mScaleKeys.begin()) {
-		// Time is before the first keyframe
-		return mScaleKeys.front().scale;
+void Bone::SamplePositionRange(int startFrame, int count, glm::vec3* out) const
+{
+	if (mPositonKeys.size() < 2) {
+		std::fill(out, out + count, GetPosition(startFrame));
+		return;
 	}
-	else {
-		// Interpolate between the two keyframes
-		auto right = it;
-		auto left = it - 1;
-
-		float deltaTime = right->timeStamp - left->timeStamp;
-		float factor = (time - left->timeStamp) / deltaTime;
-		factor = glm::clamp(factor, 0.0f, 1.0f);
 
-		return glm::mix(left->scale, right->scale, factor);
+	SampleChannel(mPositonKeys, mPositionSampling, startFrame, count, out, positionOf, mixVector);
+}
 
+void Bone::SampleScaleRange(int startFrame, int count, glm::vec3* out) const
+{
+	if (mScaleKeys.size() < 2) {
+		std::fill(out, out + count, GetScale(startFrame));
+		return;
 	}
+
+	SampleChannel(mScaleKeys, mScaleSampling, startFrame, count, out, scaleOf, mixVector);
 }
 
 glm::mat4 Bone::GetTransform(int frame) const {
@@ -30,7 +30,12 @@
 #include <QQuaternion>
 #include <QMetaType>
 #include <QUuid>
+#include <algorithm>
+#include <map>
+#include <string>
 #include <vector>
+#include <unordered_map>
+#include <unordered_set>
 #include <glm/glm.hpp>
 #include <glm/gtx/quaternion.hpp>
 #include <glm/ext/quaternion_float.hpp>
@@ -88,9 +93,23 @@ struct ANIMHOSTCORESHARED_EXPORT KeyScale
     glm::vec3 scale;
 };
 
+//! Sampling of a key channel, uniform channels have one key per integer frame without gaps
+struct ANIMHOSTCORESHARED_EXPORT KeySampling
+{
+    bool uniform = false;
+    int firstFrame = 0;
+    size_t keyCount = 0;
+
+    //! Index of the key at frame, only meaningful for uniform channels that still have keyCount keys
+    size_t keyIndex(int frame) const {
+        return static_cast<size_t>(glm::clamp(frame - firstFrame, 0, static_cast<int>(keyCount) - 1));
+    }
+};
+
 //! Bone data container
 //! Every bone has a string name, and automatically generated ID and a series of positions, rotations and scales representing an animation.
 //! Additionally, every node has a set resting transform
+//! Call UpdateSampling() after filling the keys, channels with one key per frame are then read by index instead of searched.
 class ANIMHOSTCORESHARED_EXPORT Bone 
 {
 public:
@@ -107,6 +126,10 @@ public:
     std::vector<KeyRotation> mRotationKeys;
     std::vector<KeyScale> mScaleKeys;
 
+    KeySampling mPositionSampling;
+    KeySampling mRotationSampling;
+    KeySampling mScaleSampling;
+
 public:
     Bone(std::string name, int id, int numPos, int numRot, int numScl, glm::mat4 rest);
     
@@ -129,28 +152,107 @@ public:
     glm::mat4 GetTransform(int frame) const;
     void SetTransform(int frame, glm::mat4) {};
 
+    //! Detects uniform, gap free key channels. Must be called again after timestamps were changed.
+    void UpdateSampling();
+
+    //! Orientations of count consecutive frames starting at startFrame, written to out
+    void SampleOrientationRange(int startFrame, int count, glm::quat* out) const;
+
+    //! Positions of count consecutive frames starting at startFrame, written to out
+    void SamplePositionRange(int startFrame, int count, glm::vec3* out) const;
+
+    //! Scales of count consecutive frames starting at startFrame, written to out
+    void SampleScaleRange(int startFrame, int count, glm::vec3* out) const;
+
     COMMONDATA(bone, Bone)
 
 };
 Q_DECLARE_METATYPE(std::shared_ptr<Bone>)
 
+
+/**
+ * @class MapGeneration
+ * @brief Process wide counter handing out the generations of VersionedMap.
+ */
+class ANIMHOSTCORESHARED_EXPORT MapGeneration
+{
+public:
+    //! Returns a value that has not been returned before
+    static quint64 next();
+};
+
+/**
+ * @class VersionedMap
+ * @brief std::map that takes a new generation on every modifying access.
+ *
+ * Reading works like on a const std::map. operator[], insert, erase and clear take a new generation
+ * from MapGeneration, copies keep the generation of their source. Data derived from the map is up to
+ * date as long as the generation it was built from equals the current one.
+ */
+template <typename Key, typename Value>
+class VersionedMap
+{
+    std::map<Key, Value> mMap;
+    quint64 mGeneration = 0;
+
+public:
+    using const_iterator = typename std::map<Key, Value>::const_iterator;
+
+    VersionedMap() {};
+
+    quint64 generation() const { return mGeneration; }
+
+    operator const std::map<Key, Value>&() const { return mMap; }
+
+    const_iterator begin() const { return mMap.begin(); }
+    const_iterator end() const { return mMap.end(); }
+    const_iterator find(const Key& key) const { return mMap.find(key); }
+    const Value& at(const Key& key) const { return mMap.at(key); }
+    size_t count(const Key& key) const { return mMap.count(key); }
+    size_t size() const { return mMap.size(); }
+    bool empty() const { return mMap.empty(); }
+
+    //! Modifying access, use at() or find() for reading
+    Value& operator[](const Key& key) { mGeneration = MapGeneration::next(); return mMap[key]; }
+    void insert(const Key& key, const Value& value) { mGeneration = MapGeneration::next(); mMap.insert_or_assign(key, value); }
+    size_t erase(const Key& key) { mGeneration = MapGeneration::next(); return mMap.erase(key); }
+    void clear() { mGeneration = MapGeneration::next(); mMap.clear(); }
+};
+
 /**
  * @class Skeleton
  * @brief A class that represents a skeleton in an animation.
  *
  * This class holds maps to retrieve bone names given an ID and vice versa.
  * It also stores the bone hierarchy (every bone ID is associated with an array of the IDs of its own children).
+ *
+ * The maps are the editable description of the skeleton. buildLookupTables() derives flat parent,
+ * first child and next sibling arrays, the depth first bone order and a hashed name index from them,
+ * which answer hierarchy queries in constant time. Modifying bone_names, bone_hierarchy or rootBoneID
+ * invalidates the tables, queries then search the maps until buildLookupTables() is called again.
  */
 class ANIMHOSTCORESHARED_EXPORT Skeleton
 {
 public:
-    std::map<std::string, int> bone_names; ///< Map from bone names to IDs.
+    VersionedMap<std::string, int> bone_names; ///< Map from bone names to IDs.
     std::map<int, std::string> bone_names_reverse; ///< Map from bone IDs to names.
-    std::map<int, std::vector<int>> bone_hierarchy; ///< Map from bone IDs to a vector of its children's IDs.
+    VersionedMap<int, std::vector<int>> bone_hierarchy; ///< Map from bone IDs to a vector of its children's IDs.
 
     int mNumBones = 0; ///< Number of bones in the skeleton.
     int rootBoneID = 0; ///< ID of the root bone.
 
+private:
+    std::vector<int> parents; ///< Parent ID per bone ID, -1 for the root and unused IDs.
+    std::vector<int> firstChildren; ///< First child ID per bone ID, -1 for leaf bones.
+    std::vector<int> nextSiblings; ///< Next sibling ID per bone ID, -1 for the last child.
+    std::vector<int> depthFirstOrder; ///< Bone IDs in depth first order starting at the root bone.
+    std::unordered_map<std::string, int> nameIndex; ///< Hashed map from bone names to IDs.
+
+    bool tablesBuilt = false; ///< The tables cover every bone of the hierarchy they were built from.
+    quint64 tablesNamesGeneration = 0; ///< Generation of bone_names the tables were built from.
+    quint64 tablesHierarchyGeneration = 0; ///< Generation of bone_hierarchy the tables were built from.
+    int tablesRootBoneID = -1; ///< rootBoneID the tables were built from.
+
 public:
     /**
      * @brief Default constructor for the Skeleton class.
@@ -165,6 +267,87 @@ public:
     COMMONDATA(skeleton, Skeleton)
 
 
+    /**
+     * @brief Builds the flat lookup tables from bone_names and bone_hierarchy.
+     *
+     * Call once after the maps are filled or modified. Queries fall back to searching the maps
+     * while the tables are missing or outdated.
+     */
+    void buildLookupTables() {
+        int maxID = -1;
+        for (const auto& [id, children] : bone_hierarchy) {
+            maxID = std::max(maxID, id);
+            for (int child : children) {
+                maxID = std::max(maxID, child);
+            }
+        }
+
+        parents.assign(maxID + 1, -1);
+        firstChildren.assign(maxID + 1, -1);
+        nextSiblings.assign(maxID + 1, -1);
+
+        for (const auto& [id, children] : bone_hierarchy) {
+            int previous = -1;
+            for (int child : children) {
+                parents[child] = id;
+                if (previous == -1) {
+                    firstChildren[id] = child;
+                }
+                else {
+                    nextSiblings[previous] = child;
+                }
+                previous = child;
+            }
+        }
+
+        // Pre-order traversal over the child/sibling links, matches the order of Iterator
+        depthFirstOrder.clear();
+        depthFirstOrder.reserve(maxID + 1);
+        if (rootBoneID >= 0 && rootBoneID <= maxID) {
+            int bone = rootBoneID;
+            while (bone != -1) {
+                depthFirstOrder.push_back(bone);
+
+                if (firstChildren[bone] != -1) {
+                    bone = firstChildren[bone];
+                    continue;
+                }
+                while (bone != -1 && bone != rootBoneID && nextSiblings[bone] == -1) {
+                    bone = parents[bone];
+                }
+                bone = (bone == -1 || bone == rootBoneID) ? -1 : nextSiblings[bone];
+            }
+        }
+
+        nameIndex.clear();
+        nameIndex.reserve(bone_names.size());
+        for (const auto& [name, id] : bone_names) {
+            nameIndex.emplace(name, id);
+        }
+
+        // Bones unreachable from the root are only found by searching the maps
+        tablesBuilt = !depthFirstOrder.empty() && depthFirstOrder.size() == bone_hierarchy.size();
+        tablesNamesGeneration = bone_names.generation();
+        tablesHierarchyGeneration = bone_hierarchy.generation();
+        tablesRootBoneID = rootBoneID;
+    }
+
+    /**
+     * @brief Whether the lookup tables were built from the current maps and root bone.
+     */
+    bool hasLookupTables() const {
+        return tablesBuilt && tablesRootBoneID == rootBoneID
+            && tablesHierarchyGeneration == bone_hierarchy.generation() && tablesNamesGeneration == bone_names.generation();
+    }
+
+    /**
+     * @brief Bone IDs in depth first order, parents always precede their children.
+     *
+     * Empty if the lookup tables have not been built.
+     */
+    const std::vector<int>& getDepthFirstOrder() const {
+        return depthFirstOrder;
+    }
 
     /**
     * @brief Get a bones parent bone.
@@ -172,7 +355,11 @@ public:
 	* @param boneID The bone ID to get the parent bone for.
 	* @return The parent bone ID.
     */
-	int getParentBone(int boneID) {
+	int getParentBone(int boneID) const {
+		if (hasLookupTables()) {
+			return (boneID >= 0 && boneID < parents.size()) ? parents[boneID] : -1;
+		}
+
 		for (auto& bone : bone_hierarchy) {
 			for (auto& child : bone.second) {
 				if (child == boneID) {
@@ -183,6 +370,50 @@ public:
 		return -1;
 	}
 
+    /**
+     * @brief Get the first child of a bone, -1 for leaf bones.
+     */
+    int getFirstChild(int boneID) const {
+        if (hasLookupTables()) {
+            return (boneID >= 0 && boneID < firstChildren.size()) ? firstChildren[boneID] : -1;
+        }
+
+        auto it = bone_hierarchy.find(boneID);
+        return (it == bone_hierarchy.end() || it->second.empty()) ? -1 : it->second.front();
+    }
+
+    /**
+     * @brief Get the next sibling of a bone, -1 for the last child of its parent.
+     */
+    int getNextSibling(int boneID) const {
+        if (hasLookupTables()) {
+            return (boneID >= 0 && boneID < nextSiblings.size()) ? nextSiblings[boneID] : -1;
+        }
+
+        auto it = bone_hierarchy.find(getParentBone(boneID));
+        if (it == bone_hierarchy.end()) {
+            return -1;
+        }
+        auto child = std::find(it->second.begin(), it->second.end(), boneID);
+        return (child == it->second.end() || child + 1 == it->second.end()) ? -1 : *(child + 1);
+    }
+
+    /**
+     * @brief Get the ID of a bone by name.
+     *
+     * @param boneName The name of the bone.
+     * @return The bone ID, -1 if the skeleton has no bone with this name.
+     */
+    int getBoneIndex(const std::string& boneName) const {
+        if (hasLookupTables()) {
+            auto it = nameIndex.find(boneName);
+            return it != nameIndex.end() ? it->second : -1;
+        }
+
+        auto it = bone_names.find(boneName);
+        return it != bone_names.end() ? it->second : -1;
+    }
+
 
     /**
 	* @brief Get a bones parent bone name.
@@ -190,10 +421,10 @@ public:
 	* @param boneID The bone ID to get the parent bone name for.
 	* @return The parent bone name. Empty string if no parent bone.
     */
-	std::string getParentBoneNamefromID(int boneID) {
+	std::string getParentBoneNamefromID(int boneID) const {
 		int parentID = getParentBone(boneID);
 		if (parentID != -1) {
-			return bone_names_reverse[parentID];
+			return bone_names_reverse.at(parentID);
 		}
 		return "";
 	}
@@ -220,12 +451,14 @@ public:
         }
 
         // Start creating the sub-skeleton from the root bone
-            subSkeleton.rootBoneID = bone_names[rootBoneName];
+            subSkeleton.rootBoneID = bone_names.at(rootBoneName);
         subSkeleton.bone_names[rootBoneName] = subSkeleton.rootBoneID;
         subSkeleton.bone_names_reverse[subSkeleton.rootBoneID] = rootBoneName;
-        CreateSubSkeletonRecursive(subSkeleton.rootBoneID, endBoneNames, subSkeleton);
+        const std::unordered_set<std::string> endBones(endBoneNames.begin(), endBoneNames.end());
+        CreateSubSkeletonRecursive(subSkeleton.rootBoneID, endBones, subSkeleton);
 
         subSkeleton.mNumBones = subSkeleton.bone_names.size();
+        subSkeleton.buildLookupTables();
 
         return subSkeleton;
     }
@@ -239,27 +472,30 @@ private:
      * If the bone is in endBoneNames, it does not add the children of the bone to the sub-skeleton.
      *
      * @param boneId The ID of the bone to add to the sub-skeleton.
-     * @param endBoneNames The names of the bones that should be end bones in the sub-skeleton.
+     * @param endBones The names of the bones that should be end bones in the sub-skeleton.
      * @param subSkeleton The sub-skeleton to add the bone to.
      */
-    void CreateSubSkeletonRecursive(int boneId, const std::vector<std::string>& endBoneNames, Skeleton& subSkeleton) {
+    void CreateSubSkeletonRecursive(int boneId, const std::unordered_set<std::string>& endBones, Skeleton& subSkeleton) {
         // Add the current bone to the sub-skeleton
         std::string boneName = bone_names_reverse[boneId];
         subSkeleton.bone_names[boneName] = boneId;
         subSkeleton.bone_names_reverse[boneId] = boneName;
-        subSkeleton.bone_hierarchy[boneId] = bone_hierarchy[boneId];
+        // Read through find(), operator[] would invalidate the lookup tables of this skeleton
+        auto children = bone_hierarchy.find(boneId);
+        const std::vector<int> childBoneIds = children != bone_hierarchy.end() ? children->second : std::vector<int>();
+        subSkeleton.bone_hierarchy[boneId] = childBoneIds;
 
         // If the current bone is an end bone, stop the recursion
-        if (std::find(endBoneNames.begin(), endBoneNames.end(), boneName) != endBoneNames.end()) {
+        if (endBones.count(boneName) > 0) {
             // The current bone is an end bone, so we don't add its children to the sub-skeleton
             subSkeleton.bone_hierarchy[boneId] = {};
             return;
         }
 
         // Add the children of the current bone to the sub-skeleton
-        for (int childBoneId : bone_hierarchy[boneId]) {
+        for (int childBoneId : childBoneIds) {
             // Recursively add the descendants of the child bone to the sub-skeleton
-            CreateSubSkeletonRecursive(childBoneId, endBoneNames, subSkeleton);
+            CreateSubSkeletonRecursive(childBoneId, endBones, subSkeleton);
         }
     }
 
@@ -274,9 +510,15 @@ public:
         const Skeleton& skeleton;
         std::vector<int> stack;
 
+        // Position in the depth first order when traversing from the root with lookup tables, -1 otherwise
+        int position = -1;
+
     public:
         Iterator(const Skeleton& skeleton, int startBoneId = -1) : skeleton(skeleton) {
-            if (startBoneId != -1) {
+            if (startBoneId != -1 && startBoneId == skeleton.rootBoneID && skeleton.hasLookupTables()) {
+                position = 0;
+            }
+            else if (startBoneId != -1) {
                 stack.push_back(startBoneId);
             }
         }
@@ -287,6 +529,9 @@ public:
         * @return The current bone ID being pointed to.
         */
         int operator*() const {
+            if (position >= 0) {
+                return skeleton.depthFirstOrder[position];
+            }
             return stack.back();
         }
 
@@ -298,7 +543,13 @@ public:
         * @return Reference to the updated iterator.
         */
         Iterator& operator++() {
-            if (!stack.empty()) {
+            if (position >= 0) {
+                position++;
+                if (position >= static_cast<int>(skeleton.depthFirstOrder.size())) {
+                    position = -1;
+                }
+            }
+            else if (!stack.empty()) {
 				int currentBoneId = stack.back();
 				stack.pop_back();
 
@@ -310,7 +561,7 @@ public:
         }
 
         bool operator==(const Iterator& other) const {
-            return stack == other.stack;
+            return position == other.position && stack == other.stack;
         }
 
         bool operator!=(const Iterator& other) const {
@@ -401,6 +652,72 @@ public:
 Q_DECLARE_METATYPE(std::shared_ptr<Animation>)
 
 
+/**
+ * @class FrameSpan
+ * @brief Non-owning view of the joints of one frame inside a JointFrameBuffer.
+ */
+template <typename T>
+class FrameSpan
+{
+    T* mData = nullptr;
+    int mSize = 0;
+
+public:
+    FrameSpan() {};
+    FrameSpan(T* data, int size) : mData(data), mSize(size) {};
+
+    T& operator[](int i) const { return mData[i]; }
+    T* data() const { return mData; }
+    int size() const { return mSize; }
+    bool empty() const { return mSize == 0; }
+    T* begin() const { return mData; }
+    T* end() const { return mData + mSize; }
+};
+
+/**
+ * @class JointFrameBuffer
+ * @brief Per joint vectors of a whole sequence in a single frames x joints buffer, stored frame-major.
+ *
+ * Indexing a frame returns a FrameSpan over its joints, so frame[f][joint] keeps working like a nested vector,
+ * while a range of consecutive frames is one contiguous block that can be written with a single call.
+ */
+class ANIMHOSTCORESHARED_EXPORT JointFrameBuffer
+{
+    int mFrameCount = 0;
+    int mJointCount = 0;
+    std::vector<glm::vec3> mData;
+
+public:
+    JointFrameBuffer() {};
+
+    //! Resizes to frameCount x jointCount, new values are zero. Existing values are only kept if jointCount is unchanged
+    void resize(int frameCount, int jointCount) {
+        mFrameCount = frameCount;
+        mJointCount = jointCount;
+        mData.resize(static_cast<size_t>(frameCount) * jointCount, glm::vec3(0.0f));
+    }
+
+    void clear() { resize(0, mJointCount); }
+
+    int size() const { return mFrameCount; }        //!< Number of frames
+    bool empty() const { return mFrameCount == 0; }
+    int jointCount() const { return mJointCount; }
+
+    FrameSpan<glm::vec3> operator[](int frame) { return FrameSpan<glm::vec3>(frameData(frame), mJointCount); }
+    FrameSpan<const glm::vec3> operator[](int frame) const { return FrameSpan<const glm::vec3>(frameData(frame), mJointCount); }
+
+    //! First joint of \c frame, the following frames are stored directly behind it
+    glm::vec3* frameData(int frame) { return mData.data() + static_cast<size_t>(frame) * mJointCount; }
+    const glm::vec3* frameData(int frame) const { return mData.data() + static_cast<size_t>(frame) * mJointCount; }
+
+    glm::vec3* data() { return mData.data(); }
+    const glm::vec3* data() const { return mData.data(); }
+
+    //! Size in bytes of \c frameCount consecutive frames
+    size_t byteSize(int frameCount) const { return static_cast<size_t>(frameCount) * mJointCount * sizeof(glm::vec3); }
+};
+
+
 /**
  * @class JointVelocity
  * @brief A class that represents the velocity of every character joint during a specific timestamp.
@@ -432,13 +749,13 @@ Q_DECLARE_METATYPE(std::shared_ptr<JointVelocity>)
  * @class JointVelocitySequence
  * @brief A class that represents a sequence of joint velocities in an animation.
  *
- * This class inherits from the Sequence class and contains a vector of JointVelocity objects.
+ * This class inherits from the Sequence class and stores the velocities of all frames in one JointFrameBuffer.
  * It provides methods to get the velocity of a bone at a specific frame.
  */
 class ANIMHOSTCORESHARED_EXPORT JointVelocitySequence : public Sequence
 {
 public:
-    std::vector<JointVelocity> mJointVelocitySequence; ///< The sequence of joint velocities.
+    JointFrameBuffer mJointVelocitySequence; ///< The joint velocities, mJointVelocitySequence[frame][bone].
 
 
 public:
@@ -455,8 +772,8 @@ public:
      */
     glm::vec2 GetRootVelocityAtFrame2D(int FrameIndex) {
 
-        return glm::vec2(mJointVelocitySequence[FrameIndex].mJointVelocity[0].x, 
-            mJointVelocitySequence[FrameIndex].mJointVelocity[0].z);
+        return glm::vec2(mJointVelocitySequence[FrameIndex][0].x, 
+            mJointVelocitySequence[FrameIndex][0].z);
     }
 
     /**
@@ -482,7 +799,7 @@ public:
      * @return The 3D velocity of the bone at the specified frame.
      */
     glm::vec3 GetVelocityAtFrame(int FrameIndex, int BoneIndx) {
-        return glm::vec3(mJointVelocitySequence[FrameIndex].mJointVelocity[BoneIndx]);
+        return glm::vec3(mJointVelocitySequence[FrameIndex][BoneIndx]);
     }
 
 
@@ -527,14 +844,14 @@ Q_DECLARE_METATYPE(std::shared_ptr<Pose>)
  * @class PoseSequence
  * @brief A class that represents a sequence of poses in an animation.
  *
- * This class inherits from the Sequence class and contains a vector of Pose objects.
+ * This class inherits from the Sequence class and stores the joint positions of all frames in one JointFrameBuffer.
  * It provides methods to get the position of a bone at a specific frame.
  */
 class ANIMHOSTCORESHARED_EXPORT PoseSequence : public Sequence
 {
 public:
 
-    std::vector<Pose> mPoseSequence; ///< The sequence of poses.
+    JointFrameBuffer mPoseSequence; ///< The joint positions of the poses, mPoseSequence[frame][bone].
 
 public:
 
@@ -570,9 +887,9 @@ public:
      */
     glm::vec2 GetPositionAtFrame(int FrameIndex, int boneIndex) {
 
-        if (FrameIndex < mPoseSequence.size() && boneIndex < mPoseSequence[FrameIndex].mPositionData.size()) {
-			return glm::vec2(mPoseSequence[FrameIndex].mPositionData[boneIndex].x,
-                				mPoseSequence[FrameIndex].mPositionData[boneIndex].z);
+        if (FrameIndex < mPoseSequence.size() && boneIndex < mPoseSequence.jointCount()) {
+			return glm::vec2(mPoseSequence[FrameIndex][boneIndex].x,
+                				mPoseSequence[FrameIndex][boneIndex].z);
         }
         else {
             qWarning() << "FrameIndex or boneIndex out of range. Returning (0,0)";
@@ -593,8 +910,8 @@ public:
      */
     glm::vec3 GetPositionAtFrame3D(int FrameIndex, int boneIndex) {
 
-        if (FrameIndex < mPoseSequence.size() && boneIndex < mPoseSequence[FrameIndex].mPositionData.size()) {
-			return mPoseSequence[FrameIndex].mPositionData[boneIndex];
+        if (FrameIndex < mPoseSequence.size() && boneIndex < mPoseSequence.jointCount()) {
+			return mPoseSequence[FrameIndex][boneIndex];
 		}
         else {
 			qWarning() << "FrameIndex or boneIndex out of range. Returning (0,0,0)";
@@ -780,7 +1097,7 @@ class ANIMHOSTCORESHARED_EXPORT CharacterObject :public SceneNodeObject {
 
     void setPath(std::vector<ControlPoint> otherPath) {
         this->controlPath->frameCount = otherPath.size();
-        this->controlPath->mControlPath = otherPath;
+        this->controlPath->mControlPath = std::move(otherPath);
     }
 
     COMMONDATA(characterObject, CharacterObject)
@@ -793,9 +1110,10 @@ class ANIMHOSTCORESHARED_EXPORT SceneNodeObjectSequence : public Sequence {
     public:
 
     std::vector<SceneNodeObject> mSceneNodeObjectSequence;
+    std::vector<int> changedObjectIDs; //! sceneObjectIDs modified by the latest parameter updates, empty after a full scene receive
 
     public:
-    SceneNodeObjectSequence() : mSceneNodeObjectSequence {} { };
+    SceneNodeObjectSequence() : mSceneNodeObjectSequence {}, changedObjectIDs {} { };
 
     COMMONDATA(sceneNodeObjectSequence, SceneNodeObjectSequence)
 
@@ -807,9 +1125,10 @@ class ANIMHOSTCORESHARED_EXPORT CharacterObjectSequence : public Sequence {
     public:
 
     std::vector<CharacterObject> mCharacterObjectSequence;
+    std::vector<int> changedObjectIDs; //! sceneObjectIDs modified by the latest parameter updates, empty after a full scene receive
 
     public:
-    CharacterObjectSequence() : mCharacterObjectSequence {} { };
+    CharacterObjectSequence() : mCharacterObjectSequence {}, changedObjectIDs {} { };
 
     COMMONDATA(characterObjectSequence, CharacterObjectSequence)
       
@@ -32,6 +32,8 @@ class StarkeModelConfig:
     gnn_learning_rate: float
     gnn_dropout: float
     run_dir: Optional[Path]
+    share_dataset: bool = False
+    shared_dataset: Optional[str] = None  # Shared memory segment published by AnimHost
 
     def __post_init__(self) -> None:
         """Convert string paths to Path objects if needed."""
@@ -50,7 +50,93 @@ class FrameRange:
     
 
 
+DATASET_MAGIC = b"AHDS"
+DATASET_VERSION = 1
+# magic, version, dataType, featureCount, labelsHash, rowCount, dataOffset, indexOffset, sequenceCount, statsOffset
+DATASET_HEADER = struct.Struct("<4sIIIQQQQQQ")
+DATASET_SEQUENCE_ENTRY = np.dtype([("sequence_id", "<i4"), ("first_frame", "<i4"), ("first_row", "<u8"), ("row_count", "<u8")])
+
+
+def is_dataset_container(binaryFile):
+    with open(binaryFile, "rb") as f:
+        return f.read(4) == DATASET_MAGIC
+
+
+def read_dataset_header(binaryFile):
+    """Reads the header of an indexed dataset container (*.ahds) written by AnimHost."""
+    with open(binaryFile, "rb") as f:
+        values = DATASET_HEADER.unpack(f.read(DATASET_HEADER.size))
+    keys = ["magic", "version", "data_type", "feature_count", "labels_hash", "row_count",
+            "data_offset", "index_offset", "sequence_count", "stats_offset"]
+    header = dict(zip(keys, values))
+    if header["magic"] != DATASET_MAGIC or header["version"] != DATASET_VERSION:
+        raise ValueError(f"{binaryFile} is not a dataset container of version {DATASET_VERSION}")
+    return header
+
+
+def ReadDatasetContainer(binaryFile):
+    """
+    Memory maps the rows of an indexed dataset container without copying.
+
+    Returns the (rowCount, featureCount) float32 array and the sequence index as a
+    structured array with the fields sequence_id, first_frame, first_row and row_count.
+    """
+    header = read_dataset_header(binaryFile)
+    data = np.memmap(binaryFile, dtype="<f4", mode="r", offset=header["data_offset"],
+                     shape=(header["row_count"], header["feature_count"]))
+    if header["index_offset"] != 0 and header["sequence_count"] > 0:
+        index = np.fromfile(binaryFile, dtype=DATASET_SEQUENCE_ENTRY, count=header["sequence_count"],
+                            offset=header["index_offset"])
+    else:
+        index = np.empty(0, dtype=DATASET_SEQUENCE_ENTRY)
+    return data, index
+
+
+def dataset_binary_path(dataset_path, name):
+    """Returns the indexed container for a dataset matrix if present, otherwise the raw binary file."""
+    container = os.path.join(dataset_path, name + ".ahds")
+    return container if os.path.exists(container) else os.path.join(dataset_path, name + ".bin")
+
+
+def read_normalization(file_path):
+    """Reads a normalization file (mean line, std line) as two float32 arrays."""
+    with open(file_path, 'r') as file:
+        mean = np.array(file.readline().split(), dtype=np.float32)
+        std = np.array(file.readline().split(), dtype=np.float32)
+    return mean, std
+
+
+def compute_normalization(df, precomputed_file=None, sample_count=None):
+    """
+    Returns per column mean and std (0 replaced by 1) of df as float32 arrays.
+
+    AnimHost writes the statistics of its exported features while preprocessing. If precomputed_file
+    exists and df still holds all sample_count exported rows, those are used for the leading feature
+    columns and only the remaining columns are computed here.
+    """
+    precomputed = 0
+    mean = np.empty(len(df.columns), dtype=np.float32)
+    std = np.empty(len(df.columns), dtype=np.float32)
+
+    if precomputed_file is not None and os.path.exists(precomputed_file) and len(df) == sample_count:
+        pre_mean, pre_std = read_normalization(precomputed_file)
+        precomputed = min(len(pre_mean), len(df.columns))
+        mean[:precomputed] = pre_mean[:precomputed]
+        std[:precomputed] = pre_std[:precomputed]
+
+    remaining = df.iloc[:, precomputed:]
+    mean[precomputed:] = remaining.mean().to_numpy(dtype=np.float32).flatten()
+    std[precomputed:] = remaining.std().replace(0, 1).to_numpy(dtype=np.float32).flatten()
+    return mean, std
+
+
 def ReadBinary(binaryFile, sampleCount, featureCount):
+    if is_dataset_container(binaryFile):
+        data, _ = ReadDatasetContainer(binaryFile)
+        if data.shape != (sampleCount, featureCount):
+            raise ValueError(f"{binaryFile} holds {data.shape} values, expected {(sampleCount, featureCount)}")
+        return data
+
     bytesPerLine = featureCount * 4
     data = np.empty((sampleCount, featureCount), dtype=np.float32)
     with open(binaryFile, "rb") as f:
@@ -252,9 +338,10 @@ def run_motion_preprocessing(num_phase_channel,dataset_path, phase_param_file, p
     return 0
 
 class MotionProcessor:
-    def __init__(self, dataset_path, ai4animation_path, pae_epochs=30):
+    def __init__(self, dataset_path, ai4animation_path, pae_epochs=30, shared_dataset=None):
         
         self.dataset_path = dataset_path
+        self.shared_dataset = shared_dataset  # Optional SharedDataset published by AnimHost
         self.trained_phase_param_file =  ai4animation_path + r"\PAE\Training\Parameters_{}.txt".format(pae_epochs)
         self.trained_phase_sequence_file = ai4animation_path + r"\PAE\Dataset\Sequences.txt"
         
@@ -267,6 +354,12 @@ class MotionProcessor:
         self.OutputData = None
 
     
+    def read_matrix(self, name, feature_count):
+        """Reads a dataset matrix from the shared dataset if published, otherwise from the dataset directory."""
+        if self.shared_dataset is not None and name in self.shared_dataset:
+            return self.shared_dataset.matrix(name, self.sample_count, feature_count)
+        return ReadBinary(dataset_binary_path(self.dataset_path, name), self.sample_count, feature_count)
+
     def run_motion_preprocessing(self):
         print("Running motion preprocessing...")
         start_time = time.time()
@@ -307,7 +400,7 @@ class MotionProcessor:
         df_phaseData = pd.concat([df_phaseData, df_phaseValues2D], axis=1)
 
         ## Read input data
-        raw_input_data = ReadBinary(self.dataset_path + "/data_x.bin", self.sample_count, self.input_feature_count)
+        raw_input_data = self.read_matrix("data_x", self.input_feature_count)
         print("Raw input data shape:", raw_input_data.shape)
 
         #Check for nan in input data (generated by animhost)
@@ -367,7 +460,7 @@ class MotionProcessor:
         print("Running output preprocessing...")
         start_time = time.time()
 
-        raw_output_data = ReadBinary(self.dataset_path + "/data_y.bin", self.sample_count, self.output_feature_count)
+        raw_output_data = self.read_matrix("data_y", self.output_feature_count)
         
         output_label = read_csv_data(self.dataset_path + "/metadata.txt",",")
         out_row = output_label.iloc[1]
@@ -415,8 +508,7 @@ class MotionProcessor:
         # Convert DataFrame to a flat float array
         flat_in = array.array('d', in_dropped.to_numpy(dtype=np.float32).flatten())
 
-        IN_mn =  in_dropped.mean().to_numpy(dtype=np.float32).flatten()
-        IN_std =  in_dropped.std().replace(0, 1).to_numpy(dtype=np.float32).flatten()
+        IN_mn, IN_std = compute_normalization(in_dropped, os.path.join(self.dataset_path, 'InputNormalization.txt'), self.sample_count)
 
         # Save the array to a binary file
         with open(folder_path +'Input.bin', 'wb') as file:
@@ -441,8 +533,7 @@ class MotionProcessor:
 
         flat_out = array.array('d', out_dropped.to_numpy(dtype=np.float32).flatten())
 
-        OUT_mn =  out_dropped.mean().to_numpy(dtype=np.float32).flatten()
-        OUT_std =  out_dropped.std().replace(0, 1).to_numpy(dtype=np.float32).flatten()
+        OUT_mn, OUT_std = compute_normalization(out_dropped, os.path.join(self.dataset_path, 'OutputNormalization.txt'), self.sample_count)
 
         # Save the array to a binary file
         with open(folder_path +'Output.bin', 'wb') as file:
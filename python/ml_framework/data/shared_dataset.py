@@ -0,0 +1,125 @@
+#!/usr/bin/env python3
+"""
+Shared memory dataset published by AnimHost.
+
+AnimHost's SharedDatasetPublisher copies the dataset matrices into a named shared memory
+segment and passes its name to the trainer as "shared_dataset" in the model config. The
+segment starts with a header and a JSON manifest describing the blocks:
+
+    char[4] magic "AHSM" | uint32 version | uint64 manifest size | manifest (UTF-8 JSON) | blocks
+
+Blocks are exposed as numpy arrays over the segment without copying.
+"""
+
+import json
+import logging
+import struct
+from multiprocessing import shared_memory
+from typing import Any, Dict, Optional
+
+import numpy as np
+
+logger = logging.getLogger(__name__)
+
+SEGMENT_MAGIC = b"AHSM"
+SEGMENT_VERSION = 1
+SEGMENT_HEADER = struct.Struct("<4sIQ")
+
+
+class SharedDataset:
+    """Read-only view of a dataset segment published by AnimHost."""
+
+    def __init__(self, name: str):
+        """
+        Attach to the segment.
+
+        :param name: Segment name as passed in the model config
+        :raises FileNotFoundError: If no segment of that name exists
+        :raises ValueError: If the segment is not an AnimHost dataset of a supported version
+        """
+        self._shm = _attach(name)
+        self.name = name
+
+        magic, version, manifest_size = SEGMENT_HEADER.unpack_from(self._shm.buf, 0)
+        if magic != SEGMENT_MAGIC or version != SEGMENT_VERSION:
+            self._shm.close()
+            raise ValueError(f"Shared memory segment {name} is not an AnimHost dataset of version {SEGMENT_VERSION}")
+
+        start = SEGMENT_HEADER.size
+        self.manifest: Dict[str, Any] = json.loads(bytes(self._shm.buf[start:start + manifest_size]))
+        self._blocks = {block["name"]: block for block in self.manifest["blocks"]}
+
+    def __contains__(self, block_name: str) -> bool:
+        return block_name in self._blocks
+
+    def array(self, block_name: str) -> np.ndarray:
+        """Return a block as read-only array over the shared memory, valid until close()."""
+        block = self._blocks[block_name]
+        data = np.ndarray(
+            shape=tuple(block["shape"]),
+            dtype=np.dtype(block["dtype"]),
+            buffer=self._shm.buf,
+            offset=block["offset"],
+        )
+        data.flags.writeable = False
+        return data
+
+    def matrix(self, block_name: str, row_count: int, feature_count: int) -> np.ndarray:
+        """
+        Return a block as (row_count, feature_count) array, like ReadBinary does for the files.
+
+        :raises ValueError: If the block holds fewer values
+        """
+        data = self.array(block_name).reshape(-1)
+        if data.size < row_count * feature_count:
+            raise ValueError(
+                f"Shared block {block_name} holds {data.size} values, expected {row_count * feature_count}"
+            )
+        return data[: row_count * feature_count].reshape(row_count, feature_count)
+
+    def close(self) -> None:
+        """Detach from the segment, AnimHost keeps it alive for later runs."""
+        try:
+            self._shm.close()
+        except BufferError:
+            # Arrays over the segment are still referenced, the mapping is released with them at exit
+            logger.debug(f"Shared dataset {self.name} still in use, keeping it attached")
+
+    def __enter__(self) -> "SharedDataset":
+        return self
+
+    def __exit__(self, *args) -> None:
+        self.close()
+
+
+def _attach(name: str) -> shared_memory.SharedMemory:
+    """Attach without registering the segment for removal, it is owned by AnimHost."""
+    try:
+        return shared_memory.SharedMemory(name=name, create=False, track=False)
+    except TypeError:
+        # Python < 3.13 has no track argument, tracking only matters for POSIX segments
+        shm = shared_memory.SharedMemory(name=name, create=False)
+        try:
+            from multiprocessing import resource_tracker
+            resource_tracker.unregister(shm._name, "shared_memory")
+        except Exception:
+            pass
+        return shm
+
+
+def open_shared_dataset(name: Optional[str]) -> Optional[SharedDataset]:
+    """
+    Attach to a published dataset, returning None if there is none so callers fall back to the files.
+
+    :param name: Segment name from the model config or None
+    """
+    if not name:
+        return None
+    try:
+        dataset = SharedDataset(name)
+    except (FileNotFoundError, ValueError, OSError) as e:
+        logger.warning(f"Shared dataset {name} not available, reading dataset files instead: {e}")
+        return None
+
+    logger.info(f"Attached shared dataset {name} with blocks {sorted(dataset._blocks)}")
+    return dataset
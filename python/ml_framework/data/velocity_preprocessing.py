@@ -21,6 +21,29 @@ from data.motion_preprocessing import (
 )
 
 
+def is_filtered_velocity_current(
+    dataset_dir: Path, num_samples: int, num_features: int
+) -> bool:
+    """
+    Check whether p_velocity.bin was exported together with joint_velocity.bin.
+
+    :param dataset_dir: Dataset directory containing the velocity files
+    :param num_samples: Number of velocity samples listed in sequences_velocity.txt
+    :param num_features: Number of float values per sample
+    :return: True if p_velocity.bin holds every sample and is not older than joint_velocity.bin
+    """
+    raw_file = dataset_dir / "joint_velocity.bin"
+    filtered_file = dataset_dir / "p_velocity.bin"
+    if not raw_file.is_file() or not filtered_file.is_file():
+        return False
+
+    expected_size = num_samples * num_features * 4  # float32
+    return (
+        filtered_file.stat().st_size == expected_size
+        and filtered_file.stat().st_mtime >= raw_file.stat().st_mtime
+    )
+
+
 def preprocess_velocity_data(dataset_path: str) -> None:
     """
     Preprocess velocity data with Butterworth filtering and binary export.
@@ -37,6 +60,10 @@ def preprocess_velocity_data(dataset_path: str) -> None:
         num_samples_total = count_lines(str(dataset_dir / "sequences_velocity.txt"))
         num_features_velocity = 78  # 26 joints * 3 dimensions
 
+        # AnimHost's DataExport node already writes the filtered velocities next to the raw ones
+        if is_filtered_velocity_current(dataset_dir, num_samples_total, num_features_velocity):
+            return
+
         # Apply butterworth filter to velocity data to remove noise
         velocities = ReadBinary(
             str(dataset_dir / "joint_velocity.bin"),
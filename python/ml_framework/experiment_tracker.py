@@ -10,11 +10,16 @@ NOTE: The _emit_json function in this class is solely responsible for ensuring t
 implicit JSON interface is consistent with AnimHost MLFrameworkTypes.h json parsing.
 """
 
+import base64
 import json
 import logging
+import struct
 import sys
 import traceback
-from typing import Dict, Any, Optional
+from typing import Dict, Any, List, Optional
+
+# Prefix of a binary metrics record line, must match TrainingMessageReader::binaryRecordPrefix
+BINARY_RECORD_PREFIX = "!"
 
 
 class ExperimentTracker:
@@ -43,6 +48,7 @@ class ExperimentTracker:
         self.capture_stdlib_logging = capture_stdlib_logging
         self.log_level = log_level
         self.emit_percent_progress = emit_percent_progress
+        self._binary_schemas: Dict[int, int] = {}  # Schema id -> number of fields
 
         # Clean up any previous handler and setup new one if requested
         if self.capture_stdlib_logging:
@@ -124,6 +130,54 @@ class ExperimentTracker:
         """
         self._emit_json(status, text)
 
+    def declare_binary_metrics(
+        self, schema_id: int, status: str, fields: List[str]
+    ) -> None:
+        """
+        Declare a schema for compact binary metrics records, see log_binary_metrics.
+
+        :param schema_id: Schema identifier in [0, 255]
+        :param status: Status string of the messages decoded from records of this schema
+        :param fields: Metric names, in the order of the values passed to log_binary_metrics
+        """
+        if not 0 <= schema_id <= 255:
+            raise ValueError(f"Binary metrics schema id {schema_id} outside [0, 255]")
+
+        self._binary_schemas[schema_id] = len(fields)
+        self._emit_raw(
+            json.dumps(
+                {
+                    "binary_schema": {
+                        "id": schema_id,
+                        "status": status,
+                        "fields": list(fields),
+                    }
+                }
+            )
+        )
+
+    def log_binary_metrics(self, schema_id: int, values: List[float]) -> None:
+        """
+        Emit a compact metrics record for high-rate telemetry such as per-batch losses.
+
+        The record is the schema id and one little-endian float64 per declared field,
+        base64 encoded on a line prefixed with '!'. AnimHost decodes it into a message
+        with the schema's status and fields (TrainingMessageReader.h).
+
+        :param schema_id: Schema declared with declare_binary_metrics
+        :param values: One value per schema field
+        """
+        field_count = self._binary_schemas.get(schema_id)
+        if field_count is None or field_count != len(values):
+            self.log_std_record(
+                logging.DEBUG,
+                f"Binary metrics for schema {schema_id} do not match its declaration",
+            )
+            return
+
+        record = struct.pack(f"<B{field_count}d", schema_id, *values)
+        self._emit_raw(BINARY_RECORD_PREFIX + base64.b64encode(record).decode("ascii"))
+
     def log_std_record(self, level: int, message: str) -> None:
         """
         Log a standard logging record, respecting the log_level setting.
@@ -178,7 +232,7 @@ class ExperimentTracker:
                 data["metrics"] = metrics
 
             # Emit compact JSON for C++ parser
-            print(json.dumps(data), flush=True)
+            self._emit_raw(json.dumps(data))
         except (TypeError, ValueError) as e:
             # Log serialization errors to stderr and continue
             error_msg = f"ExperimentTracker JSON serialization failed: {e}"
@@ -189,6 +243,11 @@ class ExperimentTracker:
             print(error_msg, file=sys.stderr, flush=True)
 
 
+    def _emit_raw(self, line: str) -> None:
+        """Write one complete line to stdout, AnimHost only parses lines ending in a newline."""
+        print(line, flush=True)
+
+
 class ExperimentLogHandler(logging.Handler):
     """Custom logging handler that routes messages through ExperimentTracker."""
 
@@ -21,6 +21,7 @@ from data.motion_preprocessing import (
     count_lines,
     parse_input_output_features,
 )
+from data.shared_dataset import open_shared_dataset
 from .script_subprocess import run_script_subprocess
 from .script_editing import read_script_variables, write_script_variables, reset_script
 from config.model_configs import StarkeModelConfig
@@ -400,6 +401,7 @@ def run_pae_training(
     pae_dataset_path = pae_dir / "Dataset"
 
     # Copy files: p_velocity.bin -> Data.bin, sequences_velocity.txt -> Sequences.txt
+    # The PAE Network.py subprocess only reads Data.bin, so this path does not use the shared dataset
     shutil.copyfile(p_velocity_file, pae_dataset_path / "Data.bin")
     shutil.copyfile(sequences_file, pae_dataset_path / "Sequences.txt")
 
@@ -449,8 +451,10 @@ def run_gnn_training(config: StarkeModelConfig, tracker: ExperimentTracker) -> b
     tracker.log_ui_status("Starting training 2/2 ...", "Starting GNN training phase...")
 
     # Initialize motion processor
+    shared_dataset = open_shared_dataset(config.shared_dataset)
     mp = MotionProcessor(
-        str(config.dataset_path), str(pytorch_path(config.path_to_ai4anim)), config.pae_epochs
+        str(config.dataset_path), str(pytorch_path(config.path_to_ai4anim)), config.pae_epochs,
+        shared_dataset=shared_dataset,
     )
 
     # GNN preprocessing - prepare training data for generator
@@ -459,6 +463,11 @@ def run_gnn_training(config: StarkeModelConfig, tracker: ExperimentTracker) -> b
     processed_data_path = config.dataset_path / "processed"
     mp.export_data(folder_path=str(processed_data_path) + "/")
 
+    # The preprocessed frames hold copies, the shared matrices are no longer referenced
+    del mp
+    if shared_dataset is not None:
+        shared_dataset.close()
+
     # Copy all files from processed folder to GNN folder
     gnn_dir = gnn_path(config.path_to_ai4anim)
     for file_path in processed_data_path.iterdir():
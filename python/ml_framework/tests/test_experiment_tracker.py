@@ -179,3 +179,24 @@ def test_multiple_tracker_instances_no_duplication(capsys):
     data = json.loads(lines[0])
     assert data["status"] == "INFO"
     assert data["text"] == "Test message"
+
+
+def test_binary_metrics_record(capsys):
+    """Verify schema declaration and base64 framed binary metrics record."""
+    import base64
+    import struct
+
+    tracker = ExperimentTracker()
+    tracker.declare_binary_metrics(1, "Encoder training", ["epoch", "train_loss"])
+    tracker.log_binary_metrics(1, [3, 0.25])
+
+    captured = capsys.readouterr()
+    lines = captured.out.strip().split('\n')
+    assert len(lines) == 2
+
+    schema = json.loads(lines[0])["binary_schema"]
+    assert schema == {"id": 1, "status": "Encoder training", "fields": ["epoch", "train_loss"]}
+
+    assert lines[1].startswith("!")
+    record = base64.b64decode(lines[1][1:])
+    assert struct.unpack("<B2d", record) == (1, 3.0, 0.25)
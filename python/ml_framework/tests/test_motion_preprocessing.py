@@ -32,3 +32,54 @@ def test_frame_range_clamps_to_max_frame():
     """When max_frame is lower, trailing frames repeat the max_frame value."""
     result = list(FrameRange(num_samples=13, fps=60, reference_frame=121, start_index=6, max_frame=170))
     assert result == [121, 131, 141, 151, 161, 170, 170]
+
+
+def _write_container(path, rows, sequences):
+    import numpy as np
+    from data.motion_preprocessing import DATASET_HEADER, DATASET_SEQUENCE_ENTRY
+
+    rows = np.asarray(rows, dtype="<f4")
+    index = np.array(sequences, dtype=DATASET_SEQUENCE_ENTRY)
+    data_offset = 64
+    index_offset = data_offset + rows.nbytes
+    header = DATASET_HEADER.pack(b"AHDS", 1, 0, rows.shape[1], 0, rows.shape[0],
+                                 data_offset, index_offset, len(index), 0)
+    with open(path, "wb") as f:
+        f.write(header)
+        f.write(rows.tobytes())
+        f.write(index.tobytes())
+
+
+def test_read_binary_maps_dataset_container(tmp_path):
+    """ReadBinary returns the rows of an indexed container and the sequence index is readable."""
+    import numpy as np
+    from data.motion_preprocessing import ReadBinary, ReadDatasetContainer
+
+    rows = np.arange(12, dtype=np.float32).reshape(4, 3)
+    path = tmp_path / "data_x.ahds"
+    _write_container(path, rows, [(1, 60, 0, 3), (2, 60, 3, 1)])
+
+    np.testing.assert_array_equal(ReadBinary(str(path), 4, 3), rows)
+
+    _, index = ReadDatasetContainer(str(path))
+    assert index["sequence_id"].tolist() == [1, 2]
+    assert index["row_count"].tolist() == [3, 1]
+
+
+def test_compute_normalization_uses_precomputed_columns(tmp_path):
+    """Precomputed statistics replace the leading columns, remaining columns are computed."""
+    import numpy as np
+    import pandas as pd
+    from data.motion_preprocessing import compute_normalization
+
+    df = pd.DataFrame({"a": [1.0, 2.0, 3.0], "b": [4.0, 4.0, 4.0], "phase": [0.0, 1.0, 2.0]})
+    stats = tmp_path / "InputNormalization.txt"
+    stats.write_text("10 20\n30 40\n")
+
+    mean, std = compute_normalization(df, str(stats), sample_count=3)
+    np.testing.assert_allclose(mean, [10, 20, 1])
+    np.testing.assert_allclose(std, [30, 40, 1])
+
+    mean, std = compute_normalization(df)
+    np.testing.assert_allclose(mean, [2, 4, 1])
+    np.testing.assert_allclose(std, [1, 1, 1])
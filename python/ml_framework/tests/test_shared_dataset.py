@@ -0,0 +1,51 @@
+#!/usr/bin/env python3
+"""Tests for attaching to a dataset segment in the layout of AnimHost's SharedDatasetPublisher."""
+
+import json
+import uuid
+from multiprocessing import shared_memory
+
+import numpy as np
+
+from data.shared_dataset import SEGMENT_HEADER, SEGMENT_MAGIC, SEGMENT_VERSION, open_shared_dataset
+
+
+def _publish(values):
+    """Create a segment with one float32 block named data_x, as the C++ publisher lays it out."""
+    block_offset = 256
+    manifest = json.dumps({
+        "version": SEGMENT_VERSION,
+        "blocks": [{"name": "data_x", "dtype": "<f4", "offset": block_offset, "shape": list(values.shape), "source": ""}],
+    }).encode()
+
+    shm = shared_memory.SharedMemory(name="ahtest_" + uuid.uuid4().hex[:8], create=True, size=block_offset + values.nbytes)
+    SEGMENT_HEADER.pack_into(shm.buf, 0, SEGMENT_MAGIC, SEGMENT_VERSION, len(manifest))
+    shm.buf[SEGMENT_HEADER.size:SEGMENT_HEADER.size + len(manifest)] = manifest
+    shm.buf[block_offset:block_offset + values.nbytes] = values.astype("<f4").tobytes()
+    return shm
+
+
+def test_shared_matrix_view():
+    """Blocks are reshaped to (rows, features) over the segment without copying."""
+    values = np.arange(12, dtype=np.float32)
+    shm = _publish(values)
+    try:
+        dataset = open_shared_dataset(shm.name)
+        assert dataset is not None and "data_x" in dataset
+
+        matrix = dataset.matrix("data_x", 3, 4)
+        assert matrix.shape == (3, 4)
+        assert matrix[2, 1] == 9.0
+        assert not matrix.flags.writeable
+
+        del matrix
+        dataset.close()
+    finally:
+        shm.close()
+        shm.unlink()
+
+
+def test_missing_segment_falls_back():
+    """An unknown segment name returns None so callers read the dataset files."""
+    assert open_shared_dataset("ahtest_missing_" + uuid.uuid4().hex[:8]) is None
+    assert open_shared_dataset(None) is None